@@ -408,6 +408,17 @@ PmsiTunnel::PmsiTunnel(PmsiTunnelDB *pmsi_tunnel_db,
     identifier_ = pmsi_spec_.GetIdentifier();
 }
 
+// Hash only the fields compared in PmsiTunnelSpec::CompareTo
+std::size_t hash_value(const PmsiTunnel &pmsi_tunnel) {
+    const PmsiTunnelSpec &spec = pmsi_tunnel.pmsi_spec_;
+    size_t hash = 0;
+    boost::hash_combine(hash, spec.tunnel_flags);
+    boost::hash_combine(hash, spec.tunnel_type);
+    boost::hash_combine(hash, spec.label);
+    boost::hash_range(hash, spec.identifier.begin(), spec.identifier.end());
+    return hash;
+}
+
 void PmsiTunnel::Remove() {
     pmsi_tunnel_db_->Delete(this);
 }
@@ -563,6 +574,21 @@ int EdgeDiscovery::CompareTo(const EdgeDiscovery &rhs) const {
     return result;
 }
 
+// Hash the sorted edge_list, which is what CompareTo compares, so that specs
+// with the same edges in different order have the same hash
+std::size_t hash_value(const EdgeDiscovery &edge_discovery) {
+    size_t hash = 0;
+    for (EdgeDiscovery::EdgeList::const_iterator it =
+         edge_discovery.edge_list.begin();
+         it != edge_discovery.edge_list.end(); ++it) {
+        const EdgeDiscovery::Edge *edge = *it;
+        boost::hash_combine(hash, edge->address.to_ulong());
+        boost::hash_combine(hash, edge->label_block->first());
+        boost::hash_combine(hash, edge->label_block->last());
+    }
+    return hash;
+}
+
 void EdgeDiscovery::Remove() {
     edge_discovery_db_->Delete(this);
 }
@@ -716,6 +742,22 @@ int EdgeForwarding::CompareTo(const EdgeForwarding &rhs) const {
     return result;
 }
 
+// Hash the sorted edge_list, which is what CompareTo compares, so that specs
+// with the same edges in different order have the same hash
+std::size_t hash_value(const EdgeForwarding &edge_forwarding) {
+    size_t hash = 0;
+    for (EdgeForwarding::EdgeList::const_iterator it =
+         edge_forwarding.edge_list.begin();
+         it != edge_forwarding.edge_list.end(); ++it) {
+        const EdgeForwarding::Edge *edge = *it;
+        boost::hash_combine(hash, edge->inbound_address.to_ulong());
+        boost::hash_combine(hash, edge->outbound_address.to_ulong());
+        boost::hash_combine(hash, edge->inbound_label);
+        boost::hash_combine(hash, edge->outbound_label);
+    }
+    return hash;
+}
+
 void EdgeForwarding::Remove() {
     edge_forwarding_db_->Delete(this);
 }
@@ -799,6 +841,21 @@ int BgpOList::CompareTo(const BgpOList &rhs) const {
     return result;
 }
 
+// Hash the sorted elements_, which is what CompareTo compares, so that specs
+// with the same elements in different order have the same hash
+std::size_t hash_value(const BgpOList &olist) {
+    size_t hash = 0;
+    boost::hash_combine(hash, olist.olist().subcode);
+    for (BgpOList::Elements::const_iterator it = olist.elements_.begin();
+         it != olist.elements_.end(); ++it) {
+        const BgpOListElem *elem = *it;
+        boost::hash_combine(hash, elem->address.to_ulong());
+        boost::hash_combine(hash, elem->label);
+        boost::hash_range(hash, elem->encap.begin(), elem->encap.end());
+    }
+    return hash;
+}
+
 void BgpOList::Remove() {
     olist_db_->Delete(this);
 }
@@ -1256,42 +1313,49 @@ int BgpAttr::CompareTo(const BgpAttr &rhs) const {
     return 0;
 }
 
+static void HashAddress(size_t *hash, const IpAddress &address) {
+    if (address.is_v4()) {
+        boost::hash_combine(*hash, address.to_v4().to_ulong());
+    } else {
+        Ip6Address::bytes_type bytes = address.to_v6().to_bytes();
+        boost::hash_range(*hash, bytes.begin(), bytes.end());
+    }
+}
+
+//
+// Sub-attributes are compared by pointer in BgpAttr::CompareTo since they
+// are interned in their own databases. Hash the pointers as well, instead of
+// hashing their contents all over again.
+//
 std::size_t hash_value(BgpAttr const &attr) {
     size_t hash = 0;
 
     boost::hash_combine(hash, attr.origin_);
-    boost::hash_combine(hash, attr.nexthop_.to_string());
+    HashAddress(&hash, attr.nexthop_);
     boost::hash_combine(hash, attr.med_);
     boost::hash_combine(hash, attr.local_pref_);
     boost::hash_combine(hash, attr.atomic_aggregate_);
     boost::hash_combine(hash, attr.aggregator_as_num_);
     boost::hash_combine(hash, attr.aggregator_as4_num_);
-    boost::hash_combine(hash, attr.aggregator_address_.to_string());
-    boost::hash_combine(hash, attr.originator_id_.to_string());
+    HashAddress(&hash, attr.aggregator_address_);
+    boost::hash_combine(hash, attr.originator_id_.to_ulong());
     boost::hash_combine(hash, attr.params_);
     boost::hash_combine(hash, attr.source_rd_.ToString());
     boost::hash_combine(hash, attr.esi_.ToString());
 
-    if (attr.label_block_) {
-        boost::hash_combine(hash, attr.label_block_->first());
-        boost::hash_combine(hash, attr.label_block_->last());
-    }
-
-    if (attr.olist_) {
-        boost::hash_range(hash, attr.olist_->elements().begin(),
-                          attr.olist_->elements().end());
-    }
-    if (attr.leaf_olist_) {
-        boost::hash_range(hash, attr.leaf_olist_->elements().begin(),
-                          attr.leaf_olist_->elements().end());
-    }
-
-    if (attr.as_path_) boost::hash_combine(hash, *attr.as_path_);
-    if (attr.aspath_4byte_) boost::hash_combine(hash, *attr.aspath_4byte_);
-    if (attr.as4_path_) boost::hash_combine(hash, *attr.as4_path_);
-    if (attr.community_) boost::hash_combine(hash, *attr.community_);
-    if (attr.ext_community_) boost::hash_combine(hash, *attr.ext_community_);
-    if (attr.origin_vn_path_) boost::hash_combine(hash, *attr.origin_vn_path_);
+    boost::hash_combine(hash, attr.pmsi_tunnel_.get());
+    boost::hash_combine(hash, attr.edge_discovery_.get());
+    boost::hash_combine(hash, attr.edge_forwarding_.get());
+    boost::hash_combine(hash, attr.label_block_.get());
+    boost::hash_combine(hash, attr.olist_.get());
+    boost::hash_combine(hash, attr.leaf_olist_.get());
+    boost::hash_combine(hash, attr.as_path_.get());
+    boost::hash_combine(hash, attr.aspath_4byte_.get());
+    boost::hash_combine(hash, attr.as4_path_.get());
+    boost::hash_combine(hash, attr.cluster_list_.get());
+    boost::hash_combine(hash, attr.community_.get());
+    boost::hash_combine(hash, attr.ext_community_.get());
+    boost::hash_combine(hash, attr.origin_vn_path_.get());
     if (!attr.sub_protocol_.empty()) {
         boost::hash_combine(hash, attr.sub_protocol_);
     }
@@ -231,6 +231,8 @@ public:
 
     friend std::size_t hash_value(const ClusterList &cluster_list) {
         size_t hash = 0;
+        boost::hash_range(hash, cluster_list.spec_.cluster_list.begin(),
+                          cluster_list.spec_.cluster_list.end());
         return hash;
     }
 
@@ -373,11 +375,7 @@ public:
     const PmsiTunnelSpec &pmsi_tunnel() const { return pmsi_spec_; }
     uint32_t GetLabel(const ExtCommunity *ext) const;
 
-    friend std::size_t hash_value(const PmsiTunnel &pmsi_tunnel) {
-        size_t hash = 0;
-        boost::hash_combine(hash, pmsi_tunnel.pmsi_tunnel().ToString());
-        return hash;
-    }
+    friend std::size_t hash_value(const PmsiTunnel &pmsi_tunnel);
 
     const uint8_t tunnel_flags() const { return tunnel_flags_; }
     const uint8_t tunnel_type() const { return tunnel_type_; }
@@ -469,11 +467,7 @@ public:
 
     const EdgeDiscoverySpec &edge_discovery() const { return edspec_; }
 
-    friend std::size_t hash_value(const EdgeDiscovery &edge_discovery) {
-        size_t hash = 0;
-        boost::hash_combine(hash, edge_discovery.edge_discovery().ToString());
-        return hash;
-    }
+    friend std::size_t hash_value(const EdgeDiscovery &edge_discovery);
 
     struct Edge {
         explicit Edge(const EdgeDiscoverySpec::Edge *edge_spec);
@@ -576,11 +570,7 @@ public:
 
     const EdgeForwardingSpec &edge_forwarding() const { return efspec_; }
 
-    friend std::size_t hash_value(const EdgeForwarding &edge_forwarding) {
-        size_t hash = 0;
-        boost::hash_combine(hash, edge_forwarding.edge_forwarding().ToString());
-        return hash;
-    }
+    friend std::size_t hash_value(const EdgeForwarding &edge_forwarding);
 
     struct Edge {
         explicit Edge(const EdgeForwardingSpec::Edge *edge_spec);
@@ -703,11 +693,7 @@ public:
 
     const BgpOListSpec &olist() const { return olist_spec_; }
 
-    friend std::size_t hash_value(const BgpOList &olist) {
-        size_t hash = 0;
-        boost::hash_combine(hash, olist.olist().ToString());
-        return hash;
-    }
+    friend std::size_t hash_value(const BgpOList &olist);
 
     typedef std::vector<BgpOListElem *> Elements;
 
@@ -7,9 +7,9 @@
 
 #include <boost/functional/hash.hpp>
 #include <boost/scoped_array.hpp>
+#include <boost/unordered_map.hpp>
 #include <tbb/mutex.h>
 
-#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -115,130 +115,175 @@ struct BgpProtoPrefix : public ParseObject {
 // constructor.
 //
 // Attribute contents must be hashable via hash_value() and hashed using
-// boost::hash_combine() to partition the attribute database.
+// boost::hash_combine() to partition the attribute database. Attributes that
+// are equal as per TypeCompare must have the same hash, else they are stored
+// as separate entries.
 //
 template <class Type, class TypePtr, class TypeSpec, typename TypeCompare,
           class TypeDB>
 class BgpPathAttributeDB {
 public:
+    static const size_t kDefaultHashSize = 64;
+
     explicit BgpPathAttributeDB(int hash_size = GetHashSize())
-        : hash_size_(hash_size),
-          set_(new Set[hash_size]),
-          mutex_(new tbb::mutex[hash_size]) {
+        : hash_size_(hash_size > 0 ? hash_size : 1),
+          shard_(new Shard[hash_size_]) {
     }
 
     size_t Size() {
         size_t size = 0;
 
         for (size_t i = 0; i < hash_size_; i++) {
-            tbb::mutex::scoped_lock lock(mutex_[i]);
-            size += set_[i].size();
+            tbb::mutex::scoped_lock lock(shard_[i].mutex);
+            size += shard_[i].map.size();
         }
         return size;
     }
 
     void Delete(Type *attr) {
         size_t hash = HashCompute(attr);
-
-        tbb::mutex::scoped_lock lock(mutex_[hash]);
-        assert(set_[hash].erase(attr));
+        Shard &shard = shard_[hash % hash_size_];
+
+        tbb::mutex::scoped_lock lock(shard.mutex);
+        std::pair<typename Map::iterator, typename Map::iterator> range =
+            shard.map.equal_range(hash);
+        typename Map::iterator it = range.first;
+        while (it != range.second && it->second != attr)
+            ++it;
+        assert(it != range.second);
+        shard.map.erase(it);
     }
 
     // Locate passed in attribute in the data base based on the attr ptr.
     TypePtr Locate(Type *attr) {
-        return LocateInternal(attr);
+        return LocateInternal(attr, HashCompute(attr));
     }
 
     // Locate passed in attribute in the data base, based on the attr spec.
+    //
+    // The attribute is first built on the stack and looked up, so that no
+    // heap allocation is done when an equal entry is already present, which
+    // is the common case. The attribute is allocated only on a miss.
     TypePtr Locate(const TypeSpec &spec) {
+        Type candidate(static_cast<TypeDB *>(this), spec);
+        size_t hash = HashCompute(&candidate);
+        TypePtr ptr = Find(&candidate, hash);
+        if (ptr)
+            return ptr;
         Type *attr = new Type(static_cast<TypeDB *>(this), spec);
-        return LocateInternal(attr);
+        return LocateInternal(attr, hash);
     }
 
 private:
-    const size_t HashCompute(Type *attr) const {
-        if (hash_size_ <= 1) return 0;
+    // Entries in a shard are keyed on the full content hash, so a lookup
+    // compares contents only against entries with the same hash.
+    typedef boost::unordered_multimap<size_t, Type *> Map;
+    struct Shard {
+        tbb::mutex mutex;
+        Map map;
+    };
 
+    static size_t HashCompute(const Type *attr) {
         size_t hash = 0;
         boost::hash_combine(hash, *attr);
-        return hash % hash_size_;
+        return hash;
     }
 
     static size_t GetHashSize() {
         char *str = getenv("BGP_PATH_ATTRIBUTE_DB_HASH_SIZE");
 
-        // Use just one bucket for now.
-        if (!str) return 1;
+        if (!str) return kDefaultHashSize;
         return strtoul(str, NULL, 0);
     }
 
+    static bool IsEqual(const Type *lhs, const Type *rhs) {
+        TypeCompare compare;
+        return !compare(lhs, rhs) && !compare(rhs, lhs);
+    }
+
+    // Find an entry with same contents as attr in the shard. Must be called
+    // with the shard mutex held.
+    static Type *FindInShard(Shard &shard, const Type *attr, size_t hash) {
+        std::pair<typename Map::iterator, typename Map::iterator> range =
+            shard.map.equal_range(hash);
+        for (typename Map::iterator it = range.first;
+             it != range.second; ++it) {
+            if (IsEqual(it->second, attr))
+                return it->second;
+        }
+        return NULL;
+    }
+
+    // Take a reference to the entry unless it is undergoing deletion.
+    // Must be called with the shard mutex held.
+    static TypePtr Acquire(Type *entry) {
+        // Take a reference to prevent this entry from getting deleted.
+        // Counter is automatically incremented, hence we get thread safety
+        // here.
+        int prev = intrusive_ptr_add_ref(entry);
+
+        // If the previous refcount is 0, it implies that this entry is about
+        // to get deleted (after we release the mutex), because attribute
+        // intrusive pointer is released without taking the mutex.
+        TypePtr ptr;
+        if (prev > 0)
+            ptr = TypePtr(entry);
+
+        // Release redundant refcount taken above to protect this entry from
+        // getting deleted, as we have now bumped up refcount above.
+        intrusive_ptr_del_ref(entry);
+        return ptr;
+    }
+
+    // Return existing entry with same contents as attr, if any.
+    TypePtr Find(const Type *attr, size_t hash) {
+        Shard &shard = shard_[hash % hash_size_];
+        tbb::mutex::scoped_lock lock(shard.mutex);
+        Type *entry = FindInShard(shard, attr, hash);
+        return entry ? Acquire(entry) : TypePtr();
+    }
+
     // This template safely retrieves an attribute entry from its data base.
     // If the entry is not found, it is inserted into the database.
     //
     // If the entry is already present, then passed in entry is freed and
     // existing entry is returned.
-    TypePtr LocateInternal(Type *attr) {
-        // Hash attribute contents to to avoid potential mutex contention.
-        size_t hash = HashCompute(attr);
+    TypePtr LocateInternal(Type *attr, size_t hash) {
+        // Shard on the content hash to avoid potential mutex contention.
+        Shard &shard = shard_[hash % hash_size_];
         while (true) {
-            // Grab mutex to keep db access thread safe.
-            tbb::mutex::scoped_lock lock(mutex_[hash]);
-            std::pair<typename Set::iterator, bool> ret;
-
-            // Try to insert the passed entry into the database.
-            ret = set_[hash].insert(attr);
-
-            // Take a reference to prevent this entry from getting deleted.
-            // Counter is automatically incremented, hence we get thread safety
-            // here.
-            int prev = intrusive_ptr_add_ref(*ret.first);
-
-            // Check if passed in entry did get into the data base.
-            if (ret.second) {
-                // Take intrusive pointer, thereby incrementing the refcount.
-                TypePtr ptr = TypePtr(*ret.first);
-
-                // Release redundant refcount taken above to protect this entry
-                // from getting deleted, as we have now bumped up refcount above
-                intrusive_ptr_del_ref(*ret.first);
-                return ptr;
+            TypePtr ptr;
+            {
+                // Grab mutex to keep db access thread safe.
+                tbb::mutex::scoped_lock lock(shard.mutex);
+                Type *entry = FindInShard(shard, attr, hash);
+
+                // Insert the passed entry into the database if not present.
+                if (!entry) {
+                    shard.map.insert(std::make_pair(hash, attr));
+                    return TypePtr(attr);
+                }
+                ptr = Acquire(entry);
             }
 
-            // Make sure that this entry, though in the database is not
-            // undergoing deletion. This can happen because attribute intrusive
-            // pointer is released without taking the mutex.
-            //
-            // If the previous refcount is 0, it implies that this entry is
-            // about to get deleted (after we release the mutex). In such
-            // cases, we retry inserting the passed attribute pointer into the
-            // data base.
-            if (prev > 0) {
-                // Free passed in attribute, as it is already in the database.
+            // Free passed in attribute, as it is already in the database.
+            // This is done outside the mutex as freeing the attribute may
+            // release references to entries in other databases.
+            if (ptr) {
                 delete attr;
-
-                // Take intrusive pointer, thereby incrementing the refcount.
-                TypePtr ptr = TypePtr(*ret.first);
-
-                // Release redundant refcount taken above to protect this entry
-                // from getting deleted, as we have now bumped up refcount above
-                intrusive_ptr_del_ref(*ret.first);
                 return ptr;
             }
 
-            // Decrement the counter bumped up above as we can't use this entry
-            // which is about to be deleted. Instead, retry inserting the passed
-            // entry again, into the database.
-            intrusive_ptr_del_ref(*ret.first);
+            // Existing entry is about to be deleted. Retry inserting the
+            // passed entry again, into the database.
         }
 
         assert(false);
         return NULL;
     }
 
-    typedef std::set<Type *, TypeCompare> Set;
     size_t hash_size_;
-    boost::scoped_array<Set> set_;
-    boost::scoped_array<tbb::mutex> mutex_;
+    boost::scoped_array<Shard> shard_;
 };
 
 #endif  // SRC_BGP_BGP_ATTR_BASE_H_
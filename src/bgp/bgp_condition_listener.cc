@@ -7,13 +7,18 @@
 #include <boost/bind.hpp>
 #include <boost/foreach.hpp>
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "base/task_annotations.h"
 #include "base/task_trigger.h"
 #include "bgp/bgp_route.h"
 #include "bgp/bgp_server.h"
 #include "bgp/bgp_table.h"
+#include "bgp/inet/inet_route.h"
+#include "bgp/inet6/inet6_route.h"
+#include "bgp/prefix_trie.h"
 #include "db/db_table_partition.h"
 #include "db/db_table_walk_mgr.h"
 
@@ -21,6 +26,7 @@ using std::make_pair;
 using std::map;
 using std::pair;
 using std::set;
+using std::vector;
 
 //
 // ConditionMatchTableState
@@ -33,9 +39,15 @@ using std::set;
 // Holds a table reference to ensure that table with active walk or listener
 // is not deleted
 //
+// ConditionMatch objects that declare a prefix scope are indexed in a trie in
+// inet and inet6 tables, so that route notification invokes Match only for
+// the objects interested in the route. IPv4 prefixes are stored as IPv4
+// mapped IPv6 prefixes to use same trie for both families.
+//
 class ConditionMatchTableState {
 public:
     typedef set<ConditionMatchPtr> MatchList;
+    typedef vector<ConditionMatch *> MatchObjectList;
     typedef map<ConditionMatchPtr,
             BgpConditionListener::RequestDoneCb> WalkList;
     ConditionMatchTableState(BgpTable *table, DBTableBase::ListenerId id);
@@ -53,7 +65,58 @@ public:
     }
 
     void AddMatchObject(ConditionMatch *obj) {
-        match_object_list_.insert(ConditionMatchPtr(obj));
+        if (!match_object_list_.insert(ConditionMatchPtr(obj)).second)
+            return;
+
+        Ip6Address address;
+        int prefixlen;
+        switch (GetMatchScope(obj, &address, &prefixlen)) {
+        case ConditionMatch::MATCH_MORE_SPECIFIC:
+            more_specific_trie_.Insert(address, prefixlen, obj);
+            break;
+        case ConditionMatch::MATCH_LESS_SPECIFIC:
+            less_specific_trie_.Insert(address, prefixlen, obj);
+            break;
+        default:
+            match_all_list_.insert(obj);
+            break;
+        }
+    }
+
+    void RemoveMatchObject(ConditionMatch *obj) {
+        MatchList::iterator it = match_object_list_.find(obj);
+        if (it == match_object_list_.end())
+            return;
+
+        Ip6Address address;
+        int prefixlen;
+        switch (GetMatchScope(obj, &address, &prefixlen)) {
+        case ConditionMatch::MATCH_MORE_SPECIFIC:
+            more_specific_trie_.Remove(address, prefixlen, obj);
+            break;
+        case ConditionMatch::MATCH_LESS_SPECIFIC:
+            less_specific_trie_.Remove(address, prefixlen, obj);
+            break;
+        default:
+            match_all_list_.erase(obj);
+            break;
+        }
+        match_object_list_.erase(it);
+    }
+
+    // Get the ConditionMatch objects interested in the route.
+    void GetMatchObjects(const BgpRoute *route, MatchObjectList *list) const {
+        list->insert(list->end(), match_all_list_.begin(),
+                     match_all_list_.end());
+        if (more_specific_trie_.empty() && less_specific_trie_.empty())
+            return;
+
+        Ip6Address address;
+        int prefixlen;
+        if (!GetRoutePrefix(route, &address, &prefixlen))
+            return;
+        more_specific_trie_.FindCovering(address, prefixlen, list);
+        less_specific_trie_.FindCovered(address, prefixlen, list);
     }
 
     void StoreDoneCb(ConditionMatch *obj,
@@ -93,12 +156,66 @@ public:
     }
 
 private:
+    typedef PrefixTrie<Ip6Address, ConditionMatch *> MatchTrie;
+
+    static Ip6Address MapAddress(const Ip4Address &address) {
+        Ip6Address::bytes_type bytes;
+        std::fill(bytes.begin(), bytes.end(), 0);
+        bytes[10] = bytes[11] = 0xFF;
+        Ip4Address::bytes_type v4_bytes = address.to_bytes();
+        std::copy(v4_bytes.begin(), v4_bytes.end(), bytes.begin() + 12);
+        return Ip6Address(bytes);
+    }
+
+    // Get the scope of obj with prefix in the trie format. Objects that
+    // cannot be indexed in this table are treated as MATCH_ALL.
+    ConditionMatch::MatchScope GetMatchScope(const ConditionMatch *obj,
+        Ip6Address *address, int *prefixlen) const {
+        IpAddress scope_address;
+        ConditionMatch::MatchScope scope =
+            obj->GetMatchScope(&scope_address, prefixlen);
+        if (scope == ConditionMatch::MATCH_ALL)
+            return scope;
+        if (table_->family() == Address::INET && scope_address.is_v4()) {
+            *address = MapAddress(scope_address.to_v4());
+            *prefixlen += 96;
+            return scope;
+        }
+        if (table_->family() == Address::INET6 && scope_address.is_v6()) {
+            *address = scope_address.to_v6();
+            return scope;
+        }
+        return ConditionMatch::MATCH_ALL;
+    }
+
+    bool GetRoutePrefix(const BgpRoute *route, Ip6Address *address,
+                        int *prefixlen) const {
+        if (table_->family() == Address::INET) {
+            const Ip4Prefix &prefix =
+                static_cast<const InetRoute *>(route)->GetPrefix();
+            *address = MapAddress(prefix.addr());
+            *prefixlen = prefix.prefixlen() + 96;
+            return true;
+        }
+        if (table_->family() == Address::INET6) {
+            const Inet6Prefix &prefix =
+                static_cast<const Inet6Route *>(route)->GetPrefix();
+            *address = prefix.addr();
+            *prefixlen = prefix.prefixlen();
+            return true;
+        }
+        return false;
+    }
+
     tbb::mutex table_state_mutex_;
     BgpTable *table_;
     DBTableBase::ListenerId id_;
     DBTable::DBTableWalkRef walk_ref_;
     WalkList walk_list_;
     MatchList match_object_list_;
+    set<ConditionMatch *> match_all_list_;
+    MatchTrie more_specific_trie_;
+    MatchTrie less_specific_trie_;
     LifetimeRef<ConditionMatchTableState> table_delete_ref_;
     DISALLOW_COPY_AND_ASSIGN(ConditionMatchTableState);
 };
@@ -326,9 +443,12 @@ bool BgpConditionListener::BgpRouteNotify(BgpServer *server,
     DBTableBase::ListenerId id = ts->GetListenerId();
     assert(id != DBTableBase::kInvalidId);
 
-    for (ConditionMatchTableState::MatchList::iterator match_obj_it =
-         ts->match_objects()->begin();
-        match_obj_it != ts->match_objects()->end(); match_obj_it++) {
+    // Only the objects with scope covering the route are invoked
+    ConditionMatchTableState::MatchObjectList match_objects;
+    ts->GetMatchObjects(rt, &match_objects);
+    for (ConditionMatchTableState::MatchObjectList::iterator match_obj_it =
+         match_objects.begin();
+        match_obj_it != match_objects.end(); match_obj_it++) {
         bool deleted = false;
         if ((*match_obj_it)->deleted() || del_rt) {
             deleted = true;
@@ -371,7 +491,7 @@ void BgpConditionListener::UnregisterMatchCondition(BgpTable *bgptable,
 
     // Wait for Walk completion of deleted ConditionMatch object
     if (obj->deleted() && obj->walk_done()) {
-        ts->match_objects()->erase(obj);
+        ts->RemoveMatchObject(obj);
         purge_list_.insert(ts);
     }
     purge_trigger_->Set();
@@ -13,6 +13,7 @@
 #include <set>
 #include <string>
 
+#include "base/address.h"
 #include "base/util.h"
 
 class BgpRoute;
@@ -31,6 +32,13 @@ class TaskTrigger;
 //
 class ConditionMatch {
 public:
+    // Scope of routes that the ConditionMatch is interested in.
+    enum MatchScope {
+        MATCH_ALL,              // All routes in the table
+        MATCH_MORE_SPECIFIC,    // Routes equal to or more specific than prefix
+        MATCH_LESS_SPECIFIC     // Routes equal to or less specific than prefix
+    };
+
     ConditionMatch() : deleted_(false), walk_done_(false), num_matchstate_(0) {
         refcount_ = 0;
     }
@@ -47,6 +55,15 @@ public:
                        BgpRoute *route, bool deleted) = 0;
     virtual std::string ToString() const = 0;
 
+    // Scope of routes for which Match needs to be invoked. The listener
+    // indexes the ConditionMatch with the prefix in inet and inet6 tables
+    // and skips Match for routes outside the scope. Scope must not change
+    // while the ConditionMatch is registered with the listener.
+    virtual MatchScope GetMatchScope(IpAddress *address,
+                                     int *prefixlen) const {
+        return MATCH_ALL;
+    }
+
     bool deleted() const { return deleted_; }
 
     void IncrementNumMatchstate() {
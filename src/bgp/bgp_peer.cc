@@ -488,6 +488,8 @@ BgpPeer::BgpPeer(BgpServer *server, RoutingInstance *instance,
                    TaskScheduler::GetInstance()->GetTaskId("bgp::StateMachine"),
                    GetTaskInstance()),
           buffer_capacity_(GetBufferCapacity()),
+          chunk_offset_(0),
+          chunk_size_(0),
           session_(NULL),
           keepalive_timer_(TimerManager::CreateTimer(*server->ioservice(),
                      "BGP keepalive timer",
@@ -1616,29 +1618,84 @@ bool BgpPeer::SendUpdate(const uint8_t *msg, size_t msgsize,
     const string *msg_str) {
     tbb::spin_mutex::scoped_lock lock(spin_mutex_);
     bool send_ready = true;
-    if (buffer_.size() + msgsize > buffer_capacity_) {
+    if (buffer_.size() + chunk_size_ + msgsize > buffer_capacity_) {
         send_ready = FlushUpdateUnlocked();
-        assert(buffer_.empty());
+        assert(buffer_.empty() && !chunk_);
     }
+    MoveChunkToBufferUnlocked();
     buffer_.insert(buffer_.end(), msg, msg + msgsize);
     inc_tx_update();
     return send_ready;
 }
 
+//
+// Accumulate the message that's in a chunk shared with other peers.
+//
+// The message is not copied if there's nothing pending, or if it follows
+// the updates that are pending in the same chunk. This is the common case
+// since all peers in a RibOut are usually sent the same messages. If not,
+// pending updates are moved to the update buffer and the message is copied
+// to the buffer as well.
+//
+bool BgpPeer::SendUpdateChunk(const BgpUpdateChunkPtr &chunk, size_t offset,
+    size_t msgsize) {
+    tbb::spin_mutex::scoped_lock lock(spin_mutex_);
+    bool send_ready = true;
+    if (buffer_.size() + chunk_size_ + msgsize > buffer_capacity_) {
+        send_ready = FlushUpdateUnlocked();
+        assert(buffer_.empty() && !chunk_);
+    }
+    if (buffer_.empty() && !chunk_) {
+        chunk_ = chunk;
+        chunk_offset_ = offset;
+        chunk_size_ = msgsize;
+    } else if (chunk_ == chunk && chunk_offset_ + chunk_size_ == offset) {
+        chunk_size_ += msgsize;
+    } else {
+        MoveChunkToBufferUnlocked();
+        const uint8_t *msg = chunk->data() + offset;
+        buffer_.insert(buffer_.end(), msg, msg + msgsize);
+    }
+    inc_tx_update();
+    return send_ready;
+}
+
+//
+// Copy updates pending in the shared chunk, if any, to the update buffer.
+//
+void BgpPeer::MoveChunkToBufferUnlocked() {
+    if (!chunk_)
+        return;
+    const uint8_t *data = chunk_->data() + chunk_offset_;
+    buffer_.insert(buffer_.end(), data, data + chunk_size_);
+    chunk_ = NULL;
+    chunk_offset_ = 0;
+    chunk_size_ = 0;
+}
+
 bool BgpPeer::FlushUpdateUnlocked() {
-    // Bail if the update buffer is empty.
-    if (buffer_.empty())
+    // Bail if there are no pending updates.
+    if (buffer_.empty() && !chunk_)
         return true;
 
     // Bail if there's no session for the peer anymore.
     if (!session_) {
         buffer_.clear();
+        chunk_ = NULL;
+        chunk_size_ = 0;
         return true;
     }
 
     if (!SkipUpdateSend()) {
-        send_ready_ = session_->Send(buffer_.data(), buffer_.size(), NULL);
-        buffer_.clear();
+        if (chunk_) {
+            send_ready_ = session_->Send(chunk_->data() + chunk_offset_,
+                                         chunk_size_, NULL);
+            chunk_ = NULL;
+            chunk_size_ = 0;
+        } else {
+            send_ready_ = session_->Send(buffer_.data(), buffer_.size(), NULL);
+            buffer_.clear();
+        }
         if (send_ready_) {
             StartKeepaliveTimerUnlocked();
         } else {
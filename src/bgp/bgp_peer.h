@@ -107,6 +107,8 @@ public:
     virtual bool SendUpdate(const uint8_t *msg, size_t msgsize) {
         return SendUpdate(msg, msgsize, NULL);
     }
+    virtual bool SendUpdateChunk(const BgpUpdateChunkPtr &chunk,
+                                 size_t offset, size_t msgsize);
     virtual bool FlushUpdate();
 
     // Task: bgp::Config
@@ -182,7 +184,7 @@ public:
     uint16_t hold_time() const { return hold_time_; }
     as_t local_as() const { return local_as_; }
     as_t peer_as() const { return peer_as_; }
-    size_t buffer_size() const { return buffer_.size(); }
+    size_t buffer_size() const { return buffer_.size() + chunk_size_; }
 
     // The BGP Identifier in host byte order.
     virtual uint32_t local_bgp_identifier() const;
@@ -388,6 +390,7 @@ private:
 
     size_t GetBufferCapacity() const;
     bool FlushUpdateUnlocked();
+    void MoveChunkToBufferUnlocked();
     static int Encode(const BgpMessage *msg, uint8_t *data, size_t size,
                       EncodeOffsets *offsets = NULL, bool as4 = false);
     void KeepaliveTimerErrorHandler(std::string error_name,
@@ -496,6 +499,12 @@ private:
     tbb::spin_mutex spin_mutex_;
     size_t buffer_capacity_;
     std::vector<uint8_t> buffer_;
+
+    // Updates pending in a chunk shared with other peers. Updates are
+    // pending in atmost one of chunk_ and buffer_.
+    BgpUpdateChunkPtr chunk_;
+    size_t chunk_offset_;
+    size_t chunk_size_;
     BgpSession *session_;
     Timer *keepalive_timer_;
     Timer *eor_receive_timer_[Address::NUM_FAMILIES];
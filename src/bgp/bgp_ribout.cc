@@ -181,6 +181,11 @@ RibOutAttr::RibOutAttr(const BgpRoute *route, const BgpAttr *attr,
     }
 }
 
+const std::string &RibOutAttr::repr() const {
+    static const std::string empty_repr;
+    return repr_ ? repr_->repr() : empty_repr;
+}
+
 //
 // Assignment operator.
 // Do not copy the string representation;
@@ -214,6 +219,99 @@ int RibOutAttr::CompareTo(const RibOutAttr &rhs) const {
     return 0;
 }
 
+RouteRepr::RouteRepr(RouteReprCache *cache, const BgpRoute *route,
+    const RibOutAttr &roattr, const std::string &repr, size_t pos)
+    : cache_(cache),
+      route_(route),
+      roattr_(roattr),
+      repr_(repr, pos, std::string::npos) {
+    refcount_ = 0;
+}
+
+void intrusive_ptr_release(RouteRepr *route_repr) {
+    int prev = route_repr->refcount_.fetch_and_decrement();
+    if (prev == 1) {
+        if (route_repr->cache_)
+            route_repr->cache_->Remove(route_repr);
+        delete route_repr;
+    }
+}
+
+RouteReprCache::RouteReprCache() {
+    count_ = 0;
+}
+
+//
+// Detach any remaining entries so that they can be released safely after
+// the cache is gone.
+//
+RouteReprCache::~RouteReprCache() {
+    tbb::mutex::scoped_lock lock(mutex_);
+    for (RouteReprMap::iterator it = map_.begin(); it != map_.end(); ++it) {
+        it->second->cache_ = NULL;
+    }
+    map_.clear();
+}
+
+//
+// Find the RouteRepr for the route and RibOutAttr and, if found, associate
+// it with the RibOutAttr.  Entries whose last reference is being released
+// are ignored.
+//
+bool RouteReprCache::Lookup(const BgpRoute *route, const RibOutAttr *roattr) {
+    RouteReprPtr route_repr;
+    {
+        tbb::mutex::scoped_lock lock(mutex_);
+        RouteReprMap::iterator it = map_.find(RouteReprKey(route, roattr));
+        if (it == map_.end())
+            return false;
+        int prev = it->second->refcount_.fetch_and_increment();
+        if (prev > 0)
+            route_repr = RouteReprPtr(it->second, false);
+        else
+            it->second->refcount_.fetch_and_decrement();
+    }
+    if (!route_repr)
+        return false;
+    roattr->set_repr(route_repr.get());
+    return true;
+}
+
+//
+// Create a RouteRepr with the substring of repr starting at pos and
+// associate it with the RibOutAttr. It's added to the cache unless there's
+// an existing entry that is being deleted.
+//
+void RouteReprCache::Insert(const BgpRoute *route, const RibOutAttr *roattr,
+    const std::string &repr, size_t pos) {
+    RouteRepr *route_repr = new RouteRepr(this, route, *roattr, repr, pos);
+    RouteReprPtr route_repr_ptr(route_repr);
+    {
+        tbb::mutex::scoped_lock lock(mutex_);
+        RouteReprKey key(route, &route_repr->roattr());
+        if (map_.insert(std::make_pair(key, route_repr)).second) {
+            count_++;
+        } else {
+            route_repr->cache_ = NULL;
+        }
+    }
+    roattr->set_repr(route_repr);
+}
+
+void RouteReprCache::Remove(RouteRepr *route_repr) {
+    tbb::mutex::scoped_lock lock(mutex_);
+    RouteReprMap::iterator it =
+        map_.find(RouteReprKey(route_repr->route(), &route_repr->roattr()));
+    assert(it != map_.end() && it->second == route_repr);
+    map_.erase(it);
+    count_--;
+}
+
+size_t RouteReprCache::Size() const {
+    tbb::mutex::scoped_lock lock(mutex_);
+    return map_.size();
+}
+
 void RibOutAttr::set_attr(const BgpTable *table, const BgpAttrPtr &attrp,
     uint32_t label, uint32_t l3_label, bool vrf_originated, bool is_xmpp) {
     if (!attr_out_) {
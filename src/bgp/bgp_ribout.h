@@ -5,11 +5,16 @@
 #ifndef SRC_BGP_BGP_RIBOUT_H_
 #define SRC_BGP_BGP_RIBOUT_H_
 
+#include <boost/intrusive_ptr.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/intrusive/slist.hpp>
+#include <tbb/atomic.h>
+#include <tbb/mutex.h>
 
 #include <algorithm>
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/bitset.h"
@@ -28,9 +33,15 @@ class BgpTable;
 class BgpExport;
 class BgpRoute;
 class BgpUpdateSender;
+class RouteRepr;
+class RouteReprCache;
 class RouteUpdate;
 class UpdateInfoSList;
 
+void intrusive_ptr_add_ref(RouteRepr *route_repr);
+void intrusive_ptr_release(RouteRepr *route_repr);
+typedef boost::intrusive_ptr<RouteRepr> RouteReprPtr;
+
 //
 // This class represents the attributes for a ribout entry, including the
 // label.  It is essentially a combination of a smart pointer to BgpAttr
@@ -122,11 +133,9 @@ public:
     Ip4Address *source_address() { return &source_address_; }
     bool is_xmpp() const { return is_xmpp_; }
     bool vrf_originated() const { return vrf_originated_; }
-    const std::string &repr() const { return repr_; }
-    void set_repr(const std::string &repr, size_t pos = 0) const {
-        repr_.clear();
-        repr_.append(repr, pos, std::string::npos);
-    }
+    const std::string &repr() const;
+    void set_repr(RouteRepr *route_repr) const { repr_ = route_repr; }
+    bool operator<(const RibOutAttr &rhs) const { return CompareTo(rhs) < 0; }
 
 private:
     int CompareTo(const RibOutAttr &rhs) const;
@@ -138,7 +147,95 @@ private:
     Ip4Address source_address_;
     bool is_xmpp_;
     bool vrf_originated_;
-    mutable std::string repr_;
+    mutable RouteReprPtr repr_;
+};
+
+//
+// This class represents the formatted string representation of a route with
+// a given RibOutAttr, as encoded by the Message for the RibOut.
+//
+// A RouteRepr is shared by the RibOutAttrs in all UpdateInfos for the route
+// that have the same value, irrespective of the RibOut to which they belong.
+// This allows the route to be encoded just once when it's being advertised
+// via multiple RibOuts with the same encoding, or to peers that get blocked
+// and are processed at a later point in time.
+//
+// The RouteRepr is found via the RouteReprCache in which it is registered.
+// It gets removed from the cache and deleted when the last RibOutAttr with
+// a reference to it goes away. Note that RibOutAttr copies don't take a
+// reference, so it's released once the UpdateInfo is gone.
+//
+class RouteRepr {
+public:
+    RouteRepr(RouteReprCache *cache, const BgpRoute *route,
+              const RibOutAttr &roattr, const std::string &repr, size_t pos);
+
+    const BgpRoute *route() const { return route_; }
+    const RibOutAttr &roattr() const { return roattr_; }
+    const std::string &repr() const { return repr_; }
+
+private:
+    friend class RouteReprCache;
+    friend void intrusive_ptr_add_ref(RouteRepr *route_repr);
+    friend void intrusive_ptr_release(RouteRepr *route_repr);
+
+    RouteReprCache *cache_;
+    const BgpRoute *route_;
+    RibOutAttr roattr_;
+    std::string repr_;
+    tbb::atomic<int> refcount_;
+
+    DISALLOW_COPY_AND_ASSIGN(RouteRepr);
+};
+
+inline void intrusive_ptr_add_ref(RouteRepr *route_repr) {
+    route_repr->refcount_.fetch_and_increment();
+}
+
+//
+// Cache of RouteReprs keyed by the route and the RibOutAttr.
+//
+// There's one cache for each DB partition since a given route is always
+// encoded in the context of the same bgp::SendUpdate task instance. A mutex
+// is still used since RibOutAttrs may be released from other tasks. As with
+// BgpPathAttributeDB, references are released without taking the mutex, so
+// a lookup skips entries that are about to be deleted.
+//
+class RouteReprCache {
+public:
+    RouteReprCache();
+    ~RouteReprCache();
+
+    bool Lookup(const BgpRoute *route, const RibOutAttr *roattr);
+    void Insert(const BgpRoute *route, const RibOutAttr *roattr,
+                const std::string &repr, size_t pos);
+    size_t Size() const;
+    bool empty() const { return count_ == 0; }
+
+private:
+    friend void intrusive_ptr_release(RouteRepr *route_repr);
+
+    // The RibOutAttr in the key for an entry points to the one in the
+    // RouteRepr itself.
+    typedef std::pair<const BgpRoute *, const RibOutAttr *> RouteReprKey;
+    struct RouteReprKeyCompare {
+        bool operator()(const RouteReprKey &lhs,
+                        const RouteReprKey &rhs) const {
+            if (lhs.first != rhs.first)
+                return lhs.first < rhs.first;
+            return *lhs.second < *rhs.second;
+        }
+    };
+    typedef std::map<RouteReprKey, RouteRepr *, RouteReprKeyCompare>
+        RouteReprMap;
+
+    void Remove(RouteRepr *route_repr);
+
+    mutable tbb::mutex mutex_;
+    RouteReprMap map_;
+    tbb::atomic<size_t> count_;
+
+    DISALLOW_COPY_AND_ASSIGN(RouteReprCache);
 };
 
 //
@@ -22,6 +22,7 @@ using std::vector;
 
 vector<Message *> RibOutUpdates::bgp_messages_;
 vector<Message *> RibOutUpdates::xmpp_messages_;
+vector<BgpUpdateChunkPtr> RibOutUpdates::bgp_chunks_;
 
 //
 // Create a new RibOutUpdates.  Also create the necessary UpdateQueue and
@@ -51,6 +52,7 @@ RibOutUpdates::~RibOutUpdates() {
 void RibOutUpdates::Initialize() {
     bgp_messages_.resize(DB::PartitionCount(), NULL);
     xmpp_messages_.resize(DB::PartitionCount(), NULL);
+    bgp_chunks_.resize(DB::PartitionCount());
 }
 
 //
@@ -59,6 +61,7 @@ void RibOutUpdates::Initialize() {
 void RibOutUpdates::Terminate() {
     STLDeleteValues(&bgp_messages_);
     STLDeleteValues(&xmpp_messages_);
+    bgp_chunks_.clear();
 }
 
 //
@@ -458,6 +461,12 @@ void RibOutUpdates::UpdateSend(int queue_id, Message *message,
         const RibPeerSet &dst, RibPeerSet *blocked) {
     CHECK_CONCURRENCY("bgp::SendUpdate");
 
+    // Contents of bgp messages are the same for all peers. Copy the message
+    // to the update chunk of the partition once and let the peers refer to
+    // it from there.
+    BgpUpdateChunkPtr chunk;
+    size_t offset = 0;
+
     RibOut::PeerIterator iter(ribout_, dst);
     while (iter.HasNext()) {
         int ix_current = iter.index();
@@ -466,6 +475,8 @@ void RibOutUpdates::UpdateSend(int queue_id, Message *message,
         const string *msg_str = NULL;
         string temp;
         const uint8_t *data = message->GetData(peer, &msgsize, &msg_str, &temp);
+        if (ribout_->IsEncodingBgp() && !chunk)
+            chunk = AppendToChunk(data, msgsize, &offset);
         if (Sandesh::LoggingLevel() >= Sandesh::LoggingUtLevel()) {
             BGP_LOG_PEER(Message, peer, Sandesh::LoggingUtLevel(),
                 BGP_LOG_FLAG_SYSLOG, BGP_PEER_DIR_OUT,
@@ -476,7 +487,12 @@ void RibOutUpdates::UpdateSend(int queue_id, Message *message,
         stats_[queue_id].messages_sent_count_++;
         stats_[queue_id].reach_count_ += message->num_reach_routes();
         stats_[queue_id].unreach_count_ += message->num_unreach_routes();
-        bool more = peer->SendUpdate(data, msgsize, msg_str);
+        bool more;
+        if (chunk) {
+            more = peer->SendUpdateChunk(chunk, offset, msgsize);
+        } else {
+            more = peer->SendUpdate(data, msgsize, msg_str);
+        }
         if (!more) {
             blocked->set(ix_current);
         }
@@ -492,6 +508,24 @@ void RibOutUpdates::UpdateSend(int queue_id, Message *message,
     }
 }
 
+//
+// Concurrency: Called in the context of the bgp::SendUpdate task.
+//
+// Copy the message to the update chunk of this partition and return the
+// chunk. A new chunk is started if the message doesn't fit in the current
+// one. The old chunk goes away once all peers are done with it.
+//
+BgpUpdateChunkPtr RibOutUpdates::AppendToChunk(const uint8_t *data,
+    size_t msgsize, size_t *offset) {
+    if (msgsize > BgpUpdateChunk::kSize)
+        return BgpUpdateChunkPtr();
+    BgpUpdateChunkPtr &chunk = bgp_chunks_[index_];
+    if (!chunk || chunk->available() < msgsize)
+        chunk = new BgpUpdateChunk();
+    *offset = chunk->Append(data, msgsize);
+    return chunk;
+}
+
 //
 // Concurrency: Called in the context of the bgp::SendUpdate task.
 //
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "base/util.h"
+#include "bgp/bgp_update_chunk.h"
 
 class BgpTable;
 class DBEntryBase;
@@ -110,6 +111,8 @@ private:
     void UpdateSend(int queue_id, Message *message, const RibPeerSet &dst,
                     RibPeerSet *blocked);
     void UpdateFlush(const RibPeerSet &dst, RibPeerSet *blocked);
+    BgpUpdateChunkPtr AppendToChunk(const uint8_t *data, size_t msgsize,
+                                    size_t *offset);
 
     // Remove the advertised bits on an update. This updates the history
     // information. Returns true if the UpdateInfo should be deleted.
@@ -130,6 +133,7 @@ private:
     boost::scoped_ptr<RibUpdateMonitor> monitor_;
     static std::vector<Message *> bgp_messages_;
     static std::vector<Message *> xmpp_messages_;
+    static std::vector<BgpUpdateChunkPtr> bgp_chunks_;
 
     DISALLOW_COPY_AND_ASSIGN(RibOutUpdates);
 };
@@ -97,6 +97,7 @@ public:
     ~BgpTable();
 
     const RibOutMap &ribout_map() { return ribout_map_; }
+    const RibOutMap &ribout_map() const { return ribout_map_; }
     RibOut *RibOutFind(const RibExportPolicy &policy);
     RibOut *RibOutLocate(BgpUpdateSender *sender,
                          const RibExportPolicy &policy);
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2017 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef SRC_BGP_BGP_UPDATE_CHUNK_H_
+#define SRC_BGP_BGP_UPDATE_CHUNK_H_
+
+#include <assert.h>
+#include <boost/intrusive_ptr.hpp>
+#include <stdint.h>
+#include <string.h>
+#include <tbb/atomic.h>
+
+#include "base/util.h"
+
+//
+// Block of encoded BGP update messages that is shared by peers.
+//
+// The RibOutUpdates of a partition copies each message that it builds into
+// its current chunk once. Every peer that the message is sent to keeps a
+// reference to the chunk along with the offset and size of the message
+// instead of copying the message into its own buffer. Consecutive messages
+// sent to a peer are adjacent in the chunk as long as the peer is sent all
+// the messages, so they can be handed to the session straight from the
+// chunk in a single Send.
+//
+// Messages are only ever appended to a chunk, so peers may read messages
+// added earlier while new messages are being appended. Appends are done
+// only from the bgp::SendUpdate task for the partition.
+//
+class BgpUpdateChunk {
+public:
+    static const size_t kSize = 32768;
+
+    BgpUpdateChunk() : size_(0) {
+        refcount_ = 0;
+    }
+
+    // Copy the message to the end of the chunk and return its offset.
+    size_t Append(const uint8_t *msg, size_t msgsize) {
+        size_t offset = size_;
+        assert(msgsize <= available());
+        memcpy(data_ + offset, msg, msgsize);
+        size_ += msgsize;
+        return offset;
+    }
+
+    const uint8_t *data() const { return data_; }
+    size_t size() const { return size_; }
+    size_t available() const { return kSize - size_; }
+
+private:
+    friend void intrusive_ptr_add_ref(BgpUpdateChunk *chunk);
+    friend void intrusive_ptr_release(BgpUpdateChunk *chunk);
+
+    tbb::atomic<int> refcount_;
+    size_t size_;
+    uint8_t data_[kSize];
+
+    DISALLOW_COPY_AND_ASSIGN(BgpUpdateChunk);
+};
+
+inline void intrusive_ptr_add_ref(BgpUpdateChunk *chunk) {
+    chunk->refcount_.fetch_and_increment();
+}
+
+inline void intrusive_ptr_release(BgpUpdateChunk *chunk) {
+    int prev = chunk->refcount_.fetch_and_decrement();
+    if (prev == 1) {
+        delete chunk;
+    }
+}
+
+typedef boost::intrusive_ptr<BgpUpdateChunk> BgpUpdateChunkPtr;
+
+#endif  // SRC_BGP_BGP_UPDATE_CHUNK_H_
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2017 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "bgp/bgp_xmpp_attr_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "bgp/community.h"
+
+using std::string;
+using std::vector;
+
+template <typename T>
+static void KeyAppend(string *key, const T &value) {
+    key->append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+static void KeyAppendList(string *key, const vector<T> &list) {
+    KeyAppend(key, static_cast<uint32_t>(list.size()));
+    if (!list.empty()) {
+        key->append(reinterpret_cast<const char *>(&list[0]),
+                    list.size() * sizeof(T));
+    }
+}
+
+BgpXmppAttrCache::BgpXmppAttrCache() : hits_(0), misses_(0) {
+}
+
+BgpXmppAttrCache::~BgpXmppAttrCache() {
+}
+
+//
+// Encode the contents of the spec into key. Every attribute is encoded as
+// its code and subcode followed by its value, with variable length values
+// prefixed by their length.
+//
+// Returns false if the spec has an attribute that is not understood.
+//
+bool BgpXmppAttrCache::BuildKey(const BgpAttrSpec &spec, string *key) {
+    for (BgpAttrSpec::const_iterator it = spec.begin();
+         it != spec.end(); ++it) {
+        const BgpAttribute *attr = *it;
+        KeyAppend(key, attr->code);
+        KeyAppend(key, attr->subcode);
+        switch (attr->code) {
+        case BgpAttribute::NextHop: {
+            const BgpAttrNextHop *nexthop =
+                static_cast<const BgpAttrNextHop *>(attr);
+            KeyAppend(key, nexthop->nexthop);
+            KeyAppend(key, nexthop->v6_nexthop.to_bytes());
+            break;
+        }
+        case BgpAttribute::MultiExitDisc:
+            KeyAppend(key, static_cast<const BgpAttrMultiExitDisc *>(
+                attr)->med);
+            break;
+        case BgpAttribute::LocalPref:
+            KeyAppend(key, static_cast<const BgpAttrLocalPref *>(
+                attr)->local_pref);
+            break;
+        case BgpAttribute::Communities:
+            KeyAppendList(key, static_cast<const CommunitySpec *>(
+                attr)->communities);
+            break;
+        case BgpAttribute::ExtendedCommunities:
+            KeyAppendList(key, static_cast<const ExtCommunitySpec *>(
+                attr)->communities);
+            break;
+        case BgpAttribute::PmsiTunnel: {
+            const PmsiTunnelSpec *pmsi_spec =
+                static_cast<const PmsiTunnelSpec *>(attr);
+            KeyAppend(key, pmsi_spec->tunnel_flags);
+            KeyAppend(key, pmsi_spec->tunnel_type);
+            KeyAppend(key, pmsi_spec->label);
+            KeyAppendList(key, pmsi_spec->identifier);
+            break;
+        }
+        case BgpAttribute::Reserved:
+            if (attr->subcode == BgpAttribute::LabelBlock) {
+                // The block can't be freed and its address reused while the
+                // cached attribute holds a reference to it.
+                KeyAppend(key, static_cast<const BgpAttrLabelBlock *>(
+                    attr)->label_block.get());
+            } else if (attr->subcode == BgpAttribute::SourceRd) {
+                const BgpAttrSourceRd *source_rd =
+                    static_cast<const BgpAttrSourceRd *>(attr);
+                key->append(reinterpret_cast<const char *>(
+                    source_rd->source_rd.GetData()), RouteDistinguisher::kSize);
+            } else if (attr->subcode == BgpAttribute::SubProtocol) {
+                const string &sbp =
+                    static_cast<const BgpAttrSubProtocol *>(attr)->sbp;
+                KeyAppend(key, static_cast<uint32_t>(sbp.size()));
+                key->append(sbp);
+            } else {
+                return false;
+            }
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+//
+// Return the attribute for the spec, from the cache if possible.
+//
+BgpAttrPtr BgpXmppAttrCache::Locate(BgpAttrDB *attr_db,
+                                    const BgpAttrSpec &spec) {
+    string key;
+    if (!BuildKey(spec, &key))
+        return attr_db->Locate(spec);
+
+    CacheMap::const_iterator loc = cache_.find(key);
+    if (loc != cache_.end()) {
+        hits_++;
+        return loc->second;
+    }
+
+    misses_++;
+    BgpAttrPtr attr = attr_db->Locate(spec);
+    if (cache_.size() >= kMaxSize)
+        cache_.clear();
+    cache_.insert(std::make_pair(key, attr));
+    return attr;
+}
+
+void BgpXmppAttrCache::Clear() {
+    cache_.clear();
+}
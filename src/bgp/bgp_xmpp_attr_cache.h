@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2017 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef SRC_BGP_BGP_XMPP_ATTR_CACHE_H_
+#define SRC_BGP_BGP_XMPP_ATTR_CACHE_H_
+
+#include <boost/unordered_map.hpp>
+
+#include <string>
+
+#include "base/util.h"
+#include "bgp/bgp_attr.h"
+
+//
+// Cache of path attributes built for routes received on a BgpXmppChannel.
+//
+// Agents advertise thousands of routes with the same nexthop, tunnel
+// encapsulations, security groups and so on, so most of the routes from an
+// agent end up with a handful of distinct path attributes. The cache maps
+// the contents of a BgpAttrSpec to the BgpAttr located for it earlier, so
+// that the attribute and its sub-attributes are not built and interned in
+// the attribute databases again for every route.
+//
+// Only the attributes that the channel builds for inet, inet6, enet and
+// multicast routes are understood. A spec with any other attribute is
+// located in the BgpAttrDB directly.
+//
+// Cached entries hold a reference to their attribute. The cache is flushed
+// when it's full and when the channel is closed, so that it does not keep
+// attributes that are no longer used by any route alive for long.
+//
+// The cache is not thread-safe. It's used only from the receive path of the
+// channel.
+//
+class BgpXmppAttrCache {
+public:
+    static const size_t kMaxSize = 1024;
+
+    BgpXmppAttrCache();
+    ~BgpXmppAttrCache();
+
+    BgpAttrPtr Locate(BgpAttrDB *attr_db, const BgpAttrSpec &spec);
+    void Clear();
+
+    size_t size() const { return cache_.size(); }
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+
+private:
+    typedef boost::unordered_map<std::string, BgpAttrPtr> CacheMap;
+
+    static bool BuildKey(const BgpAttrSpec &spec, std::string *key);
+
+    CacheMap cache_;
+    uint64_t hits_;
+    uint64_t misses_;
+
+    DISALLOW_COPY_AND_ASSIGN(BgpXmppAttrCache);
+};
+
+#endif  // SRC_BGP_BGP_XMPP_ATTR_CACHE_H_
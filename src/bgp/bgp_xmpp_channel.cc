@@ -19,6 +19,7 @@
 #include "bgp/bgp_membership.h"
 #include "bgp/bgp_server.h"
 #include "bgp/bgp_update_sender.h"
+#include "bgp/bgp_xmpp_attr_cache.h"
 #include "bgp/bgp_xmpp_peer_close.h"
 #include "bgp/inet/inet_table.h"
 #include "bgp/inet6/inet6_table.h"
@@ -490,6 +491,7 @@ BgpXmppChannel::BgpXmppChannel(XmppChannel *channel,
       peer_close_(new BgpXmppPeerClose(this)),
       peer_stats_(new PeerStats(this)),
       bgp_policy_(BgpProto::XMPP, RibExportPolicy::XMPP, -1, 0),
+      attr_cache_(new BgpXmppAttrCache()),
       manager_(manager),
       delete_in_progress_(false),
       deleted_(false),
@@ -940,7 +942,7 @@ bool BgpXmppChannel::ProcessMcastItem(string vrf_name,
         if (!ext.communities.empty())
             attrs.push_back(&ext);
 
-        BgpAttrPtr attr = bgp_server_->attr_db()->Locate(attrs);
+        BgpAttrPtr attr = attr_cache_->Locate(bgp_server_->attr_db(), attrs);
         req.data.reset(new ErmVpnTable::RequestData(
             attr, flags, 0, 0, subscription_gen_id));
         stats_[RX].reach++;
@@ -995,7 +997,7 @@ void BgpXmppChannel::CreateType5MvpnRouteRequest(IpAddress grp_address,
         BgpAttrSourceRd source_rd(
                 RouteDistinguisher(nh_address.to_v4().to_ulong(), instance_id));
         attrs.push_back(&source_rd);
-        BgpAttrPtr attr = bgp_server_->attr_db()->Locate(attrs);
+        BgpAttrPtr attr = attr_cache_->Locate(bgp_server_->attr_db(), attrs);
         req.data.reset(new MvpnTable::RequestData(
             attr, flags, 0, 0, subscription_gen_id));
         stats_[RX].reach++;
@@ -1025,7 +1027,7 @@ void BgpXmppChannel::CreateType7MvpnRouteRequest(IpAddress grp_address,
         BgpAttrNextHop nexthop(src_address);
         attrs.push_back(&nexthop);
 
-        BgpAttrPtr attr = bgp_server_->attr_db()->Locate(attrs);
+        BgpAttrPtr attr = attr_cache_->Locate(bgp_server_->attr_db(), attrs);
         req.data.reset(new MvpnTable::RequestData(
             attr, flags, 0, 0, subscription_gen_id));
         stats_[RX].reach++;
@@ -1391,7 +1393,7 @@ bool BgpXmppChannel::ProcessItem(string vrf_name,
         BgpAttrSubProtocol sbp(item.entry.sub_protocol);
         attrs.push_back(&sbp);
 
-        BgpAttrPtr attr = bgp_server_->attr_db()->Locate(attrs);
+        BgpAttrPtr attr = attr_cache_->Locate(bgp_server_->attr_db(), attrs);
         req.data.reset(new BgpTable::RequestData(
             attr, flags, label, 0, subscription_gen_id));
     } else {
@@ -1719,7 +1721,8 @@ bool BgpXmppChannel::ProcessInet6Item(string vrf_name,
             if (!master && !ext.communities.empty())
                 attrs.push_back(&ext);
 
-            BgpAttrPtr attr = bgp_server_->attr_db()->Locate(attrs);
+            BgpAttrPtr attr =
+                attr_cache_->Locate(bgp_server_->attr_db(), attrs);
             req.data.reset(new BgpTable::RequestData(
                 attr, flags, label, 0, subscription_gen_id));
         } else {
@@ -2097,7 +2100,7 @@ bool BgpXmppChannel::ProcessEnetItem(string vrf_name,
             attrs.push_back(&pmsi_spec);
         }
 
-        BgpAttrPtr attr = bgp_server_->attr_db()->Locate(attrs);
+        BgpAttrPtr attr = attr_cache_->Locate(bgp_server_->attr_db(), attrs);
 
         req.data.reset(new EvpnTable::RequestData(
             attr, flags, label, l3_label, subscription_gen_id));
@@ -3274,6 +3277,7 @@ bool BgpXmppChannelManager::CollectStats(BgpRouterState *state, bool first)
 void BgpXmppChannel::Close() {
     instance_membership_request_map_.clear();
     STLDeleteElements(&defer_q_);
+    attr_cache_->Clear();
 
     if (table_membership_requests()) {
         BGP_LOG_PEER(Event, peer_.get(), SandeshLevel::SYS_INFO,
@@ -31,6 +31,7 @@ class xml_node;
 class BgpGlobalSystemConfig;
 class BgpRouterState;
 class BgpServer;
+class BgpXmppAttrCache;
 class BgpXmppRTargetManager;
 struct DBRequest;
 class IPeer;
@@ -354,6 +355,9 @@ private:
     // DB Requests pending membership request response.
     DeferQ defer_q_;
 
+    // Path attributes of routes received from the peer.
+    boost::scoped_ptr<BgpXmppAttrCache> attr_cache_;
+
     TableMembershipRequestMap table_membership_request_map_;
     InstanceMembershipRequestMap instance_membership_request_map_;
     BgpXmppChannelManager *manager_;
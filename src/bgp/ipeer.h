@@ -6,6 +6,7 @@
 #define SRC_BGP_IPEER_H_
 
 #include "bgp/bgp_proto.h"
+#include "bgp/bgp_update_chunk.h"
 #include "base/address.h"
 #include "tbb/atomic.h"
 
@@ -33,6 +34,14 @@ public:
         return SendUpdate(msg, msgsize);
     }
 
+    // Send an update that's at offset in a chunk shared with other peers.
+    // Peers may keep a reference to the chunk instead of copying the update.
+    // Returns true if the peer can send additional messages.
+    virtual bool SendUpdateChunk(const BgpUpdateChunkPtr &chunk,
+                                 size_t offset, size_t msgsize) {
+        return SendUpdate(chunk->data() + offset, msgsize, NULL);
+    }
+
     // Flush any accumulated updates.
     // Returns true if the peer can send additional messages.
     virtual bool FlushUpdate() { return true; }
@@ -34,6 +34,11 @@ public:
     virtual Address::Family family() const { return Address::INETVPN; }
     virtual bool IsVpnTable() const { return true; }
 
+    // bgp.l3vpn.0 holds routes of all VRFs, use the denser data-store
+    virtual PartitionStorage partition_storage() const {
+        return BTREE_STORAGE;
+    }
+
     virtual size_t Hash(const DBEntry *entry) const;
     virtual size_t Hash(const DBRequestKey *key) const;
 
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2017 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef SRC_BGP_PREFIX_TRIE_H_
+#define SRC_BGP_PREFIX_TRIE_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/util.h"
+
+//
+// PrefixTrie
+// Path compressed binary trie of IP prefixes. AddressT is Ip4Address or
+// Ip6Address and ValueT is any copyable type with operator==.
+//
+// Each node holds the prefix bits masked to its length and the list of
+// values inserted for prefixes that mask to the node. Nodes without values
+// exist only where two branches split. Insert, Remove and lookups walk at
+// most one node per bit of the prefix.
+//
+// Values are stored against the masked prefix, so 10.1.1.1/24 and 10.1.1.0/24
+// share the node. Users that care about host bits must check the values
+// returned by the lookups.
+//
+// The trie is not thread-safe. Users need to ensure that modifications are
+// done in exclusion to lookups.
+//
+template <typename AddressT, typename ValueT>
+class PrefixTrie {
+public:
+    typedef std::vector<ValueT> ValueList;
+
+    PrefixTrie() : root_(NULL), count_(0) {
+    }
+    ~PrefixTrie() {
+        DeleteTree(root_);
+    }
+
+    // Add value for the prefix. Duplicates are not checked.
+    void Insert(const AddressT &addr, int prefixlen, const ValueT &value) {
+        KeyT key = Mask(addr.to_bytes(), prefixlen);
+        Node *parent = NULL;
+        Node **link = &root_;
+        while (*link != NULL) {
+            Node *node = *link;
+            int common = CommonLength(node->key, key,
+                                      std::min(node->prefixlen, prefixlen));
+            if (common < node->prefixlen) {
+                // Split the branch at the first bit that differs.
+                Node *split = new Node(Mask(key, common), common, parent);
+                split->child[Bit(node->key, common)] = node;
+                node->parent = split;
+                *link = split;
+                if (common == prefixlen) {
+                    split->values.push_back(value);
+                } else {
+                    Node *leaf = new Node(key, prefixlen, split);
+                    leaf->values.push_back(value);
+                    split->child[Bit(key, common)] = leaf;
+                }
+                count_++;
+                return;
+            }
+            if (node->prefixlen == prefixlen) {
+                node->values.push_back(value);
+                count_++;
+                return;
+            }
+            parent = node;
+            link = &node->child[Bit(key, node->prefixlen)];
+        }
+
+        *link = new Node(key, prefixlen, parent);
+        (*link)->values.push_back(value);
+        count_++;
+    }
+
+    // Remove value for the prefix. Returns false if value is not present.
+    bool Remove(const AddressT &addr, int prefixlen, const ValueT &value) {
+        Node *node = FindNode(Mask(addr.to_bytes(), prefixlen), prefixlen);
+        if (node == NULL)
+            return false;
+        typename ValueList::iterator it =
+            std::find(node->values.begin(), node->values.end(), value);
+        if (it == node->values.end())
+            return false;
+        node->values.erase(it);
+        count_--;
+        Prune(node);
+        return true;
+    }
+
+    // Get values of all prefixes that cover the given prefix, including the
+    // prefix itself. Values are appended longest prefix first.
+    void FindCovering(const AddressT &addr, int prefixlen,
+                      ValueList *list) const {
+        KeyT key = addr.to_bytes();
+        std::vector<const Node *> path;
+        for (const Node *node = root_; node != NULL; ) {
+            if (node->prefixlen > prefixlen)
+                break;
+            if (CommonLength(node->key, key, node->prefixlen) <
+                node->prefixlen) {
+                break;
+            }
+            if (!node->values.empty())
+                path.push_back(node);
+            if (node->prefixlen == prefixlen)
+                break;
+            node = node->child[Bit(key, node->prefixlen)];
+        }
+
+        for (typename std::vector<const Node *>::reverse_iterator it =
+             path.rbegin(); it != path.rend(); ++it) {
+            list->insert(list->end(), (*it)->values.begin(),
+                         (*it)->values.end());
+        }
+    }
+
+    // Get values of all prefixes covered by the given prefix, including the
+    // prefix itself. Values are appended in no specific order.
+    void FindCovered(const AddressT &addr, int prefixlen,
+                     ValueList *list) const {
+        KeyT key = addr.to_bytes();
+        const Node *node = root_;
+        while (node != NULL && node->prefixlen < prefixlen) {
+            if (CommonLength(node->key, key, node->prefixlen) <
+                node->prefixlen) {
+                return;
+            }
+            node = node->child[Bit(key, node->prefixlen)];
+        }
+        if (node == NULL || CommonLength(node->key, key, prefixlen) < prefixlen)
+            return;
+        CollectValues(node, list);
+    }
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+private:
+    typedef typename AddressT::bytes_type KeyT;
+
+    struct Node {
+        Node(const KeyT &key, int prefixlen, Node *parent)
+            : key(key), prefixlen(prefixlen), parent(parent) {
+            child[0] = child[1] = NULL;
+        }
+        KeyT key;
+        int prefixlen;
+        Node *parent;
+        Node *child[2];
+        ValueList values;
+    };
+
+    static int Bit(const KeyT &key, int index) {
+        return (key[index / 8] >> (7 - (index % 8))) & 0x1;
+    }
+
+    static KeyT Mask(KeyT key, int prefixlen) {
+        for (size_t i = 0; i < key.size(); i++) {
+            int bits = prefixlen - static_cast<int>(i * 8);
+            if (bits >= 8)
+                continue;
+            if (bits <= 0) {
+                key[i] = 0;
+            } else {
+                key[i] &= static_cast<uint8_t>(0xFF << (8 - bits));
+            }
+        }
+        return key;
+    }
+
+    // Number of leading bits, upto max, that are same in both keys
+    static int CommonLength(const KeyT &lhs, const KeyT &rhs, int max) {
+        int length = 0;
+        for (size_t i = 0; i < lhs.size() && length < max; i++) {
+            uint8_t diff = lhs[i] ^ rhs[i];
+            if (diff == 0) {
+                length += 8;
+                continue;
+            }
+            while ((diff & 0x80) == 0) {
+                diff <<= 1;
+                length++;
+            }
+            break;
+        }
+        return std::min(length, max);
+    }
+
+    Node *FindNode(const KeyT &key, int prefixlen) const {
+        Node *node = root_;
+        while (node != NULL && node->prefixlen < prefixlen) {
+            if (CommonLength(node->key, key, node->prefixlen) <
+                node->prefixlen) {
+                return NULL;
+            }
+            node = node->child[Bit(key, node->prefixlen)];
+        }
+        if (node == NULL || node->prefixlen != prefixlen || node->key != key)
+            return NULL;
+        return node;
+    }
+
+    Node **ParentLink(Node *node) {
+        if (node->parent == NULL)
+            return &root_;
+        Node *parent = node->parent;
+        return (parent->child[0] == node) ? &parent->child[0] :
+                                            &parent->child[1];
+    }
+
+    // Remove nodes that no longer have values and do not split branches.
+    void Prune(Node *node) {
+        while (node != NULL && node->values.empty()) {
+            Node *child = node->child[0] ? node->child[0] : node->child[1];
+            if (node->child[0] && node->child[1])
+                return;
+
+            Node *parent = node->parent;
+            *ParentLink(node) = child;
+            if (child != NULL)
+                child->parent = parent;
+            delete node;
+            if (child != NULL)
+                return;
+            node = parent;
+        }
+    }
+
+    static void CollectValues(const Node *node, ValueList *list) {
+        if (node == NULL)
+            return;
+        list->insert(list->end(), node->values.begin(), node->values.end());
+        CollectValues(node->child[0], list);
+        CollectValues(node->child[1], list);
+    }
+
+    static void DeleteTree(Node *node) {
+        if (node == NULL)
+            return;
+        DeleteTree(node->child[0]);
+        DeleteTree(node->child[1]);
+        delete node;
+    }
+
+    Node *root_;
+    size_t count_;
+
+    DISALLOW_COPY_AND_ASSIGN(PrefixTrie);
+};
+
+#endif  // SRC_BGP_PREFIX_TRIE_H_
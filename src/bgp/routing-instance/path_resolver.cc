@@ -1207,6 +1207,18 @@ bool ResolverNexthop::Match(BgpServer *server, BgpTable *table,
     return true;
 }
 
+//
+// Implement virtual method for ConditionMatch base class.
+// Only the routes that cover the address can resolve it.
+//
+ConditionMatch::MatchScope ResolverNexthop::GetMatchScope(IpAddress *address,
+    int *prefixlen) const {
+    *address = address_;
+    *prefixlen = address_.is_v4() ?
+        Address::kMaxV4PrefixLen : Address::kMaxV6PrefixLen;
+    return MATCH_LESS_SPECIFIC;
+}
+
 //
 // Add the given ResolverPath to the list of dependents in the partition.
 // Add to register/unregister list when the first dependent ResolverPath for
@@ -397,6 +397,7 @@ public:
     virtual std::string ToString() const;
     virtual bool Match(BgpServer *server, BgpTable *table, BgpRoute *route,
         bool deleted);
+    virtual MatchScope GetMatchScope(IpAddress *address, int *prefixlen) const;
     void AddResolverPath(int part_id, ResolverPath *rpath);
     void RemoveResolverPath(int part_id, ResolverPath *rpath);
     ResolverRouteState *GetResolverRouteState();
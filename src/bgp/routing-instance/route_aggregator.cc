@@ -149,6 +149,14 @@ public:
     virtual bool Match(BgpServer *server, BgpTable *table,
                        BgpRoute *route, bool deleted);
 
+    // Only the routes more specific than aggregate prefix can contribute
+    virtual MatchScope GetMatchScope(IpAddress *address,
+                                     int *prefixlen) const {
+        *address = aggregate_route_prefix_.addr();
+        *prefixlen = aggregate_route_prefix_.prefixlen();
+        return MATCH_MORE_SPECIFIC;
+    }
+
     void UpdateNexthop(IpAddress nexthop) {
         nexthop_ = nexthop;
         UpdateAggregateRoute();
@@ -302,34 +310,18 @@ bool AggregateRoute<T>::IsOriginVnMatch(BgpRoute *route) const {
 }
 
 //
-// Calculate all aggregate prefixes to which the route can be contributing.
-// We need to calculate the longest prefix to which this route belongs.
-// E.g. routing instance is configured with 1/8, 1.1/16 and 1.1.1/24, 1.1.1.1/32
-// should match 1.1.1/24. Similarly, 1.1.1/24 should be most specific to 1.1/16
-// as so on
+// Check whether this aggregate has the longest prefix to which the route
+// belongs. E.g. routing instance is configured with 1/8, 1.1/16 and 1.1.1/24,
+// 1.1.1.1/32 should match 1.1.1/24. Similarly, 1.1.1/24 should be most
+// specific to 1.1/16 as so on
 //
 template <typename T>
 bool AggregateRoute<T>::IsBestMatch(BgpRoute *route) const {
     const RouteT *ip_route = static_cast<RouteT *>(route);
-    const PrefixT &ip_prefix = ip_route->GetPrefix();
-    typename RouteAggregator<T>::AggregateRouteMap::const_iterator it;
-    std::set<PrefixT> prefix_list;
-    for (it = manager_->aggregate_route_map().begin();
-         it != manager_->aggregate_route_map().end(); ++it) {
-        if (!it->second->deleted() && ip_prefix != it->first &&
-            ip_prefix.IsMoreSpecific(it->first)) {
-            prefix_list.insert(it->first);
-        }
-    }
+    const AggregateRoute *best = manager_->FindBestMatch(ip_route->GetPrefix());
     // It should match atleast one prefix
-    assert(prefix_list.size());
-    //
-    // Longest prefix matches the aggregate prefix of current AggregateRoute
-    // return true to make this route as contributing route
-    // Longest prefix is the last prefix in the set
-    //
-    if (*(prefix_list.rbegin()) == aggregate_route_prefix_) return true;
-    return false;
+    assert(best);
+    return (best == this);
 }
 
 // Match function called from BgpConditionListener
@@ -736,6 +728,35 @@ bool RouteAggregator<T>::IsContributingRoute(const BgpRoute *route) const {
     return false;
 }
 
+//
+// Find the aggregate route with the longest prefix to which the given prefix
+// is more specific, ignoring the ones being deleted. Prefixes that differ
+// only in host bits share the trie node, pick the largest of them to match
+// the order of aggregate_route_map_.
+//
+template <typename T>
+AggregateRoute<T> *RouteAggregator<T>::FindBestMatch(
+    const PrefixT &prefix) const {
+    typename AggregateRouteTrie::ValueList list;
+    aggregate_route_trie_.FindCovering(prefix.addr(), prefix.prefixlen(),
+                                       &list);
+    AggregateRouteT *best = NULL;
+    for (typename AggregateRouteTrie::ValueList::const_iterator it =
+         list.begin(); it != list.end(); ++it) {
+        AggregateRouteT *aggregate = static_cast<AggregateRouteT *>(it->get());
+        const PrefixT &aggregate_prefix = aggregate->aggregate_route_prefix();
+        if (best && aggregate_prefix.prefixlen() <
+            best->aggregate_route_prefix().prefixlen()) {
+            break;
+        }
+        if (aggregate->deleted() || aggregate_prefix == prefix)
+            continue;
+        if (!best || best->aggregate_route_prefix() < aggregate_prefix)
+            best = aggregate;
+    }
+    return best;
+}
+
 template <typename T>
 bool RouteAggregator<T>::FillAggregateRouteInfo(AggregateRouteEntriesInfo *info,
     bool summary) const {
@@ -817,6 +838,8 @@ void RouteAggregator<T>::LocateAggregateRoutePrefix(const AggregateRouteConfig
         new AggregateRouteT(routing_instance(), this, prefix, cfg.nexthop);
     AggregateRoutePtr aggregate_route_match = AggregateRoutePtr(match);
     aggregate_route_map_.insert(make_pair(prefix, aggregate_route_match));
+    aggregate_route_trie_.Insert(prefix.addr(), prefix.prefixlen(),
+                                 aggregate_route_match);
 
     condition_listener_->AddMatchCondition(match->bgp_table(),
            aggregate_route_match.get(), BgpConditionListener::RequestDoneCb());
@@ -855,7 +878,9 @@ bool RouteAggregator<T>::ProcessUnregisterList() {
          it = unregister_aggregate_list_.begin();
          it != unregister_aggregate_list_.end(); ++it) {
         AggregateRouteT *aggregate = static_cast<AggregateRouteT *>(it->get());
-        aggregate_route_map_.erase(aggregate->aggregate_route_prefix());
+        const PrefixT &prefix = aggregate->aggregate_route_prefix();
+        aggregate_route_trie_.Remove(prefix.addr(), prefix.prefixlen(), *it);
+        aggregate_route_map_.erase(prefix);
         condition_listener_->UnregisterMatchCondition(aggregate->bgp_table(),
                                                       aggregate);
     }
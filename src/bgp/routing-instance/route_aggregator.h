@@ -18,6 +18,7 @@
 #include "bgp/inet/inet_table.h"
 #include "bgp/inet6/inet6_route.h"
 #include "bgp/inet6/inet6_table.h"
+#include "bgp/prefix_trie.h"
 
 class AggregateRouteConfig;
 
@@ -167,6 +168,8 @@ public:
 
     // Map of AggregateRoute prefix to the AggregateRoute match object
     typedef std::map<PrefixT, AggregateRoutePtr> AggregateRouteMap;
+    // Trie of AggregateRoute prefixes for longest prefix match
+    typedef PrefixTrie<AddressT, AggregateRoutePtr> AggregateRouteTrie;
 
     explicit RouteAggregator(RoutingInstance *instance);
     ~RouteAggregator();
@@ -184,6 +187,7 @@ public:
     const AggregateRouteMap &aggregate_route_map() const {
         return aggregate_route_map_;
     }
+    AggregateRouteT *FindBestMatch(const PrefixT &prefix) const;
 
     Address::Family GetFamily() const;
     AddressT GetAddress(IpAddress addr) const;
@@ -241,6 +245,7 @@ private:
     BgpConditionListener *condition_listener_;
     DBTableBase::ListenerId listener_id_;
     AggregateRouteMap  aggregate_route_map_;
+    AggregateRouteTrie aggregate_route_trie_;
     boost::scoped_ptr<TaskTrigger> update_list_trigger_;
     boost::scoped_ptr<TaskTrigger> unregister_list_trigger_;
     tbb::mutex mutex_;
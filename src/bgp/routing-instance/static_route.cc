@@ -141,6 +141,16 @@ public:
     virtual bool Match(BgpServer *server, BgpTable *table,
                        BgpRoute *route, bool deleted);
 
+    // Nexthop routes have prefix address same as nexthop, they cover the
+    // nexthop address.
+    virtual MatchScope GetMatchScope(IpAddress *address,
+                                     int *prefixlen) const {
+        *address = nexthop_;
+        *prefixlen = nexthop_.is_v4() ?
+            Address::kMaxV4PrefixLen : Address::kMaxV6PrefixLen;
+        return MATCH_LESS_SPECIFIC;
+    }
+
     virtual string ToString() const {
         return (string("StaticRoute ") + nexthop_.to_string());
     }
@@ -3161,6 +3161,124 @@ TEST_F(BgpAttrTest, BgpAttrDB) {
     STLDeleteValues(&spec);
 }
 
+// Entries located from equal specs are interned, across all shards.
+TEST_F(BgpAttrTest, CommunityDBLocate) {
+    vector<CommunityPtr> comm_list;
+    for (int idx = 0; idx < 1000; idx++) {
+        CommunitySpec spec;
+        spec.communities.push_back(idx);
+        spec.communities.push_back(idx + 1);
+        comm_list.push_back(comm_db_->Locate(spec));
+    }
+    EXPECT_EQ(1000, comm_db_->Size());
+
+    for (int idx = 0; idx < 1000; idx++) {
+        CommunitySpec spec;
+        spec.communities.push_back(idx + 1);
+        spec.communities.push_back(idx);
+        CommunityPtr comm = comm_db_->Locate(spec);
+        EXPECT_EQ(comm_list[idx].get(), comm.get());
+        Community *dup = new Community(*comm);
+        EXPECT_EQ(comm.get(), comm_db_->Locate(dup).get());
+    }
+    EXPECT_EQ(1000, comm_db_->Size());
+    comm_list.clear();
+}
+
+TEST_F(BgpAttrTest, ClusterListDBLocate) {
+    vector<ClusterListPtr> cluster_list;
+    for (int idx = 0; idx < 1000; idx++) {
+        ClusterListSpec spec;
+        spec.cluster_list.push_back(idx);
+        cluster_list.push_back(cluster_list_db_->Locate(spec));
+    }
+    EXPECT_EQ(1000, cluster_list_db_->Size());
+
+    for (int idx = 0; idx < 1000; idx++) {
+        ClusterListSpec spec;
+        spec.cluster_list.push_back(idx);
+        EXPECT_EQ(cluster_list[idx].get(),
+                  cluster_list_db_->Locate(spec).get());
+    }
+    cluster_list.clear();
+    EXPECT_EQ(0, cluster_list_db_->Size());
+}
+
+// Specs with the same edges in different order are interned as one entry.
+TEST_F(BgpAttrTest, EdgeDiscoveryDBLocate) {
+    EdgeDiscoverySpec edspec1;
+    EdgeDiscoverySpec edspec2;
+    for (int idx = 1; idx <= 8; ++idx) {
+        error_code ec;
+        EdgeDiscoverySpec::Edge *edge1 = new(EdgeDiscoverySpec::Edge);
+        std::string addr_str1 = "10.1.1." + integerToString(idx);
+        edge1->SetIp4Address(Ip4Address::from_string(addr_str1, ec));
+        edge1->SetLabels(1000 * idx, 1000 * idx + 999);
+        edspec1.edge_list.push_back(edge1);
+
+        EdgeDiscoverySpec::Edge *edge2 = new(EdgeDiscoverySpec::Edge);
+        std::string addr_str2 = "10.1.1." + integerToString(9 - idx);
+        edge2->SetIp4Address(Ip4Address::from_string(addr_str2, ec));
+        edge2->SetLabels(1000 * (9 - idx), 1000 * (9 - idx) + 999);
+        edspec2.edge_list.push_back(edge2);
+    }
+    EdgeDiscoveryPtr ediscovery1 = edge_discovery_db_->Locate(edspec1);
+    EdgeDiscoveryPtr ediscovery2 = edge_discovery_db_->Locate(edspec2);
+    EXPECT_EQ(ediscovery1.get(), ediscovery2.get());
+    EXPECT_EQ(1, edge_discovery_db_->Size());
+}
+
+// Specs with the same edges in different order are interned as one entry.
+TEST_F(BgpAttrTest, EdgeForwardingDBLocate) {
+    EdgeForwardingSpec efspec1;
+    EdgeForwardingSpec efspec2;
+    for (int idx = 1; idx <= 8; ++idx) {
+        error_code ec;
+        EdgeForwardingSpec::Edge *edge1 = new(EdgeForwardingSpec::Edge);
+        std::string addr_str1 = "10.1.1." + integerToString(idx);
+        edge1->SetInboundIp4Address(Ip4Address::from_string("10.1.1.100", ec));
+        edge1->inbound_label = 100000;
+        edge1->SetOutboundIp4Address(Ip4Address::from_string(addr_str1, ec));
+        edge1->outbound_label = 1000 * idx;
+        efspec1.edge_list.push_back(edge1);
+
+        EdgeForwardingSpec::Edge *edge2 = new(EdgeForwardingSpec::Edge);
+        std::string addr_str2 = "10.1.1." + integerToString(9 - idx);
+        edge2->SetInboundIp4Address(Ip4Address::from_string("10.1.1.100", ec));
+        edge2->inbound_label = 100000;
+        edge2->SetOutboundIp4Address(Ip4Address::from_string(addr_str2, ec));
+        edge2->outbound_label = 1000 * (9 - idx);
+        efspec2.edge_list.push_back(edge2);
+    }
+    EdgeForwardingPtr eforwarding1 = edge_forwarding_db_->Locate(efspec1);
+    EdgeForwardingPtr eforwarding2 = edge_forwarding_db_->Locate(efspec2);
+    EXPECT_EQ(eforwarding1.get(), eforwarding2.get());
+    EXPECT_EQ(1, edge_forwarding_db_->Size());
+}
+
+// Specs with the same elements and encaps in different order are interned
+// as one entry.
+TEST_F(BgpAttrTest, BgpOListDBLocate) {
+    BgpOListSpec olist_spec1(BgpAttribute::OList);
+    BgpOListSpec olist_spec2(BgpAttribute::OList);
+    for (int idx = 1; idx <= 8; ++idx) {
+        error_code ec;
+        std::string addr_str1 = "10.1.1." + integerToString(idx);
+        std::vector<std::string> encap1 = list_of("gre")("udp");
+        olist_spec1.elements.push_back(BgpOListElem(
+            Ip4Address::from_string(addr_str1, ec), 1000 * idx, encap1));
+
+        std::string addr_str2 = "10.1.1." + integerToString(9 - idx);
+        std::vector<std::string> encap2 = list_of("udp")("gre");
+        olist_spec2.elements.push_back(BgpOListElem(
+            Ip4Address::from_string(addr_str2, ec), 1000 * (9 - idx), encap2));
+    }
+    BgpOListPtr olist1 = olist_db_->Locate(olist_spec1);
+    BgpOListPtr olist2 = olist_db_->Locate(olist_spec2);
+    EXPECT_EQ(olist1.get(), olist2.get());
+    EXPECT_EQ(1, olist_db_->Size());
+}
+
 // ----- Test multi-threaded issues in path attributes db.
 // Launch a number of threads, that add and delete the same attribute content.
 // Since many threads are launched, we get to uncover most of the concurrency
@@ -57,8 +57,15 @@ class TestConditionMatch : public ConditionMatch {
 public:
     typedef map<PrefixT, BgpRoute *> MatchList;
     TestConditionMatch(Address::Family family, const PrefixT &prefix,
-                       bool hold_db_state)
-        : family_(family), prefix_(prefix), hold_db_state_(hold_db_state) {
+                       bool hold_db_state, MatchScope scope)
+        : family_(family), prefix_(prefix), hold_db_state_(hold_db_state),
+          scope_(scope) {
+    }
+
+    MatchScope GetMatchScope(IpAddress *address, int *prefixlen) const {
+        *address = prefix_.addr();
+        *prefixlen = prefix_.prefixlen();
+        return scope_;
     }
 
     bool Match(BgpServer *server, BgpTable *table,
@@ -133,6 +140,7 @@ private:
     MatchList match_list_;
     PrefixT prefix_;
     bool hold_db_state_;
+    MatchScope scope_;
 };
 
 //
@@ -323,10 +331,12 @@ protected:
     }
 
     void AddMatchCondition(string name, string match,
-                           bool hold_db_state = false) {
+        bool hold_db_state = false,
+        ConditionMatch::MatchScope match_scope = ConditionMatch::MATCH_ALL) {
         ConcurrencyScope scope("bgp::Config");
         PrefixT prefix = PrefixT::FromString(match);
-        match_.reset(new ConditionMatchT(family_, prefix, hold_db_state));
+        match_.reset(new ConditionMatchT(family_, prefix, hold_db_state,
+                                         match_scope));
         RoutingInstance *rti =
             bgp_server_->routing_instance_mgr()->GetRoutingInstance(name);
         BgpTable *table = rti->GetTable(family_);
@@ -522,6 +532,45 @@ TYPED_TEST(BgpConditionListenerTest, DelWalk) {
     this->DeleteRoute("blue", this->BuildPrefix("192.168.0.0", 16));
 }
 
+//
+// Match condition with scope is not invoked for routes outside the scope,
+// even though Match of the test condition accepts them.
+//
+TYPED_TEST(BgpConditionListenerTest, MatchScope) {
+    typedef typename TypeParam::ConditionMatchT ConditionMatchT;
+    typedef typename TypeParam::PrefixT PrefixT;
+
+    this->AddRoutingInstance("blue");
+    task_util::WaitForIdle();
+
+    this->AddRoute("blue", this->BuildHostAddress("192.168.1.2"));
+    this->AddRoute("blue", this->BuildHostAddress("192.168.2.2"));
+
+    this->AddMatchCondition("blue", this->BuildPrefix("192.168.1.0", 24),
+                            false, ConditionMatch::MATCH_MORE_SPECIFIC);
+    task_util::WaitForIdle();
+
+    ConditionMatchT *match = static_cast<ConditionMatchT *>(this->match_.get());
+    TASK_UTIL_EXPECT_EQ(1, match->matched_routes_size());
+
+    this->AddRoute("blue", this->BuildHostAddress("192.168.1.3"));
+    this->AddRoute("blue", this->BuildHostAddress("192.168.3.3"));
+    TASK_UTIL_EXPECT_EQ(2, match->matched_routes_size());
+    PrefixT prefix = PrefixT::FromString(this->BuildHostAddress("192.168.3.3"));
+    TASK_UTIL_EXPECT_TRUE(match->lookup_matched_routes(prefix) == NULL);
+
+    this->DeleteRoute("blue", this->BuildHostAddress("192.168.1.2"));
+    TASK_UTIL_EXPECT_EQ(1, match->matched_routes_size());
+
+    this->RemoveMatchCondition("blue");
+    task_util::WaitForIdle();
+    TASK_UTIL_EXPECT_TRUE(match->matched_routes_empty());
+
+    this->DeleteRoute("blue", this->BuildHostAddress("192.168.1.3"));
+    this->DeleteRoute("blue", this->BuildHostAddress("192.168.2.2"));
+    this->DeleteRoute("blue", this->BuildHostAddress("192.168.3.3"));
+}
+
 TYPED_TEST(BgpConditionListenerTest, Stress) {
     typedef typename TypeParam::ConditionMatchT ConditionMatchT;
 
@@ -27,19 +27,26 @@ public:
 class BgpSessionMock : public BgpSession {
 public:
     BgpSessionMock(BgpSessionManager *manager)
-        : BgpSession(manager, NULL), message_count_(0) {
+        : BgpSession(manager, NULL), message_count_(0), last_data_(NULL),
+          last_size_(0) {
     }
     ~BgpSessionMock() { }
 
     virtual bool Send(const u_int8_t *data, size_t size, size_t *sent) {
         message_count_++;
+        last_data_ = data;
+        last_size_ = size;
         return true;
     }
 
     uint64_t message_count() const { return message_count_; }
+    const u_int8_t *last_data() const { return last_data_; }
+    size_t last_size() const { return last_size_; }
 
 private:
     uint64_t message_count_;
+    const u_int8_t *last_data_;
+    size_t last_size_;
 };
 
 class BgpPeerMock : public BgpPeer {
@@ -465,6 +472,81 @@ TEST_F(BgpPeerTest, MessageBuffer8) {
     TASK_UTIL_EXPECT_EQ(0, session_->message_count());
 }
 
+//
+// Adjacent messages in a shared chunk are sent straight from the chunk.
+//
+TEST_F(BgpPeerTest, MessageChunk1) {
+    static const size_t msgsize = 128;
+    uint8_t msg[msgsize];
+    BgpUpdateChunkPtr chunk(new BgpUpdateChunk());
+
+    size_t offset = chunk->Append(msg, msgsize);
+    peer_->SendUpdateChunk(chunk, offset, msgsize);
+    offset = chunk->Append(msg, msgsize);
+    peer_->SendUpdateChunk(chunk, offset, msgsize);
+    TASK_UTIL_EXPECT_EQ(2 * msgsize, peer_->buffer_size());
+    TASK_UTIL_EXPECT_EQ(2, peer_->get_tx_update());
+    TASK_UTIL_EXPECT_EQ(0, session_->message_count());
+
+    peer_->FlushUpdate();
+    TASK_UTIL_EXPECT_EQ(0, peer_->buffer_size());
+    TASK_UTIL_EXPECT_EQ(1, session_->message_count());
+    TASK_UTIL_EXPECT_TRUE(session_->last_data() == chunk->data());
+    TASK_UTIL_EXPECT_EQ(2 * msgsize, session_->last_size());
+}
+
+//
+// Messages that are not adjacent in the chunk are copied to the buffer,
+// along with any raw messages. All of them go out in a single Send.
+//
+TEST_F(BgpPeerTest, MessageChunk2) {
+    static const size_t msgsize = 128;
+    uint8_t msg[msgsize];
+    BgpUpdateChunkPtr chunk(new BgpUpdateChunk());
+
+    size_t offset = chunk->Append(msg, msgsize);
+    peer_->SendUpdateChunk(chunk, offset, msgsize);
+    chunk->Append(msg, msgsize);
+    offset = chunk->Append(msg, msgsize);
+    peer_->SendUpdateChunk(chunk, offset, msgsize);
+    TASK_UTIL_EXPECT_EQ(2 * msgsize, peer_->buffer_size());
+    peer_->SendUpdate(msg, msgsize);
+    TASK_UTIL_EXPECT_EQ(3 * msgsize, peer_->buffer_size());
+    offset = chunk->Append(msg, msgsize);
+    peer_->SendUpdateChunk(chunk, offset, msgsize);
+    TASK_UTIL_EXPECT_EQ(4 * msgsize, peer_->buffer_size());
+    TASK_UTIL_EXPECT_EQ(4, peer_->get_tx_update());
+
+    peer_->FlushUpdate();
+    TASK_UTIL_EXPECT_EQ(0, peer_->buffer_size());
+    TASK_UTIL_EXPECT_EQ(1, session_->message_count());
+    TASK_UTIL_EXPECT_TRUE(session_->last_data() != chunk->data());
+    TASK_UTIL_EXPECT_EQ(4 * msgsize, session_->last_size());
+}
+
+//
+// SendUpdateChunk causes call to FlushUpdate when the buffer is full.
+//
+TEST_F(BgpPeerTest, MessageChunk3) {
+    static const size_t msgsize = BufferCapacity() - 128;
+    uint8_t msg[msgsize];
+    BgpUpdateChunkPtr chunk(new BgpUpdateChunk());
+
+    size_t offset = chunk->Append(msg, msgsize);
+    peer_->SendUpdateChunk(chunk, offset, msgsize);
+    BgpUpdateChunkPtr chunk2(new BgpUpdateChunk());
+    offset = chunk2->Append(msg, 129);
+    peer_->SendUpdateChunk(chunk2, offset, 129);
+    TASK_UTIL_EXPECT_EQ(129, peer_->buffer_size());
+    TASK_UTIL_EXPECT_EQ(1, session_->message_count());
+    TASK_UTIL_EXPECT_TRUE(session_->last_data() == chunk->data());
+
+    peer_->FlushUpdate();
+    TASK_UTIL_EXPECT_EQ(0, peer_->buffer_size());
+    TASK_UTIL_EXPECT_EQ(2, session_->message_count());
+    TASK_UTIL_EXPECT_TRUE(session_->last_data() == chunk2->data());
+}
+
 typedef std::tr1::tuple<time_t, uint64_t, bool, Address::Family, time_t, bool,
                         bool> TestParams;
 class BgpPeerParamTest :
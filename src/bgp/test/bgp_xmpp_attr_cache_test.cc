@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2017 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "bgp/bgp_xmpp_attr_cache.h"
+
+#include "base/test/task_test_util.h"
+#include "bgp/bgp_log.h"
+#include "bgp/bgp_server.h"
+#include "bgp/community.h"
+#include "control-node/control_node.h"
+
+class BgpXmppAttrCacheTest : public ::testing::Test {
+protected:
+    BgpXmppAttrCacheTest()
+        : server_(&evm_), attr_db_(server_.attr_db()) {
+    }
+
+    virtual void TearDown() {
+        cache_.Clear();
+        EXPECT_EQ(0, attr_db_->Size());
+        server_.Shutdown();
+        task_util::WaitForIdle();
+    }
+
+    BgpAttrPtr Locate(uint32_t nexthop, uint32_t local_pref,
+                      uint32_t community) {
+        BgpAttrSpec attrs;
+        BgpAttrNextHop attr_nexthop(nexthop);
+        attrs.push_back(&attr_nexthop);
+        BgpAttrLocalPref attr_local_pref(local_pref);
+        attrs.push_back(&attr_local_pref);
+        CommunitySpec comm;
+        comm.communities.push_back(community);
+        attrs.push_back(&comm);
+        BgpAttrSubProtocol sbp("interface");
+        attrs.push_back(&sbp);
+        return cache_.Locate(attr_db_, attrs);
+    }
+
+    EventManager evm_;
+    BgpServer server_;
+    BgpAttrDB *attr_db_;
+    BgpXmppAttrCache cache_;
+};
+
+TEST_F(BgpXmppAttrCacheTest, Basic) {
+    BgpAttrPtr attr1 = Locate(0x01010101, 100, 1);
+    BgpAttrPtr attr2 = Locate(0x01010101, 100, 1);
+    EXPECT_EQ(attr1.get(), attr2.get());
+    EXPECT_EQ(1U, cache_.size());
+    EXPECT_EQ(1U, cache_.hits());
+    EXPECT_EQ(1U, cache_.misses());
+
+    // Any difference in the contents results in a different attribute
+    BgpAttrPtr attr3 = Locate(0x02020202, 100, 1);
+    BgpAttrPtr attr4 = Locate(0x01010101, 200, 1);
+    BgpAttrPtr attr5 = Locate(0x01010101, 100, 2);
+    EXPECT_NE(attr1.get(), attr3.get());
+    EXPECT_NE(attr1.get(), attr4.get());
+    EXPECT_NE(attr1.get(), attr5.get());
+    EXPECT_EQ(200U, attr4->local_pref());
+    EXPECT_EQ(4U, cache_.size());
+    EXPECT_EQ(4, attr_db_->Size());
+
+    // Cache holds on to the attributes until cleared
+    attr1.reset();
+    attr2.reset();
+    EXPECT_EQ(4, attr_db_->Size());
+    cache_.Clear();
+    EXPECT_EQ(3, attr_db_->Size());
+}
+
+// Attribute located directly from the db is the same as the cached one
+TEST_F(BgpXmppAttrCacheTest, SameAsAttrDB) {
+    BgpAttrSpec attrs;
+    BgpAttrNextHop nexthop(0x01010101);
+    attrs.push_back(&nexthop);
+    BgpAttrSourceRd source_rd(RouteDistinguisher(0x01010101, 1));
+    attrs.push_back(&source_rd);
+    ExtCommunitySpec ext;
+    ext.communities.push_back(0x030c000000000001ULL);
+    attrs.push_back(&ext);
+
+    BgpAttrPtr attr1 = cache_.Locate(attr_db_, attrs);
+    BgpAttrPtr attr2 = attr_db_->Locate(attrs);
+    EXPECT_EQ(attr1.get(), attr2.get());
+    EXPECT_EQ(1U, cache_.size());
+}
+
+// Spec with an attribute that's not understood bypasses the cache
+TEST_F(BgpXmppAttrCacheTest, Unsupported) {
+    BgpAttrSpec attrs;
+    BgpAttrNextHop nexthop(0x01010101);
+    attrs.push_back(&nexthop);
+    BgpAttrOrigin origin(BgpAttrOrigin::IGP);
+    attrs.push_back(&origin);
+
+    BgpAttrPtr attr1 = cache_.Locate(attr_db_, attrs);
+    BgpAttrPtr attr2 = cache_.Locate(attr_db_, attrs);
+    EXPECT_EQ(attr1.get(), attr2.get());
+    EXPECT_EQ(0U, cache_.size());
+    EXPECT_EQ(0U, cache_.hits());
+}
+
+// Cache is flushed when full
+TEST_F(BgpXmppAttrCacheTest, Full) {
+    for (uint32_t idx = 0; idx < BgpXmppAttrCache::kMaxSize; idx++) {
+        Locate(0x01010101, 100, idx);
+    }
+    EXPECT_EQ(BgpXmppAttrCache::kMaxSize, cache_.size());
+    Locate(0x01010101, 100, BgpXmppAttrCache::kMaxSize);
+    EXPECT_EQ(1U, cache_.size());
+    EXPECT_EQ(1, attr_db_->Size());
+}
+
+static void SetUp() {
+    bgp_log_test::init();
+    ControlNode::SetDefaultSchedulingPolicy();
+}
+
+static void TearDown() {
+    task_util::WaitForIdle();
+    TaskScheduler *scheduler = TaskScheduler::GetInstance();
+    scheduler->Terminate();
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    SetUp();
+    int result = RUN_ALL_TESTS();
+    TearDown();
+    return result;
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2017 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "bgp/prefix_trie.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/address.h"
+#include "testing/gunit.h"
+
+using std::string;
+using std::vector;
+
+typedef PrefixTrie<Ip4Address, int> Inet4Trie;
+typedef PrefixTrie<Ip6Address, int> Inet6Trie;
+
+class PrefixTrieTest : public ::testing::Test {
+protected:
+    struct Prefix {
+        Prefix(uint32_t addr, int prefixlen)
+            : addr(addr), prefixlen(prefixlen) {
+        }
+        uint32_t addr;
+        int prefixlen;
+    };
+
+    static uint32_t Mask(uint32_t addr, int prefixlen) {
+        return prefixlen ? (addr & (~0U << (32 - prefixlen))) : 0;
+    }
+
+    // Returns true if lhs is covered by rhs
+    static bool IsCovered(const Prefix &lhs, const Prefix &rhs) {
+        return lhs.prefixlen >= rhs.prefixlen &&
+            Mask(lhs.addr, rhs.prefixlen) == Mask(rhs.addr, rhs.prefixlen);
+    }
+
+    static Ip4Address Address(const string &addr) {
+        return Ip4Address::from_string(addr);
+    }
+};
+
+TEST_F(PrefixTrieTest, Basic) {
+    Inet4Trie trie;
+    EXPECT_TRUE(trie.empty());
+
+    trie.Insert(Address("10.0.0.0"), 8, 1);
+    trie.Insert(Address("10.1.0.0"), 16, 2);
+    trie.Insert(Address("10.1.1.0"), 24, 3);
+    trie.Insert(Address("11.0.0.0"), 8, 4);
+    trie.Insert(Address("0.0.0.0"), 0, 5);
+    EXPECT_EQ(5U, trie.size());
+
+    Inet4Trie::ValueList list;
+    trie.FindCovering(Address("10.1.1.1"), 32, &list);
+    ASSERT_EQ(4U, list.size());
+    EXPECT_EQ(3, list[0]);
+    EXPECT_EQ(2, list[1]);
+    EXPECT_EQ(1, list[2]);
+    EXPECT_EQ(5, list[3]);
+
+    list.clear();
+    trie.FindCovering(Address("10.1.0.0"), 16, &list);
+    ASSERT_EQ(3U, list.size());
+    EXPECT_EQ(2, list[0]);
+
+    list.clear();
+    trie.FindCovered(Address("10.0.0.0"), 8, &list);
+    std::sort(list.begin(), list.end());
+    ASSERT_EQ(3U, list.size());
+    EXPECT_EQ(1, list[0]);
+    EXPECT_EQ(2, list[1]);
+    EXPECT_EQ(3, list[2]);
+
+    list.clear();
+    trie.FindCovered(Address("12.0.0.0"), 8, &list);
+    EXPECT_TRUE(list.empty());
+
+    EXPECT_FALSE(trie.Remove(Address("10.1.0.0"), 16, 3));
+    EXPECT_FALSE(trie.Remove(Address("10.2.0.0"), 16, 2));
+    EXPECT_TRUE(trie.Remove(Address("10.1.0.0"), 16, 2));
+    EXPECT_EQ(4U, trie.size());
+
+    list.clear();
+    trie.FindCovering(Address("10.1.1.1"), 32, &list);
+    ASSERT_EQ(3U, list.size());
+    EXPECT_EQ(3, list[0]);
+    EXPECT_EQ(1, list[1]);
+
+    EXPECT_TRUE(trie.Remove(Address("10.0.0.0"), 8, 1));
+    EXPECT_TRUE(trie.Remove(Address("10.1.1.0"), 24, 3));
+    EXPECT_TRUE(trie.Remove(Address("11.0.0.0"), 8, 4));
+    EXPECT_TRUE(trie.Remove(Address("0.0.0.0"), 0, 5));
+    EXPECT_TRUE(trie.empty());
+}
+
+// Prefixes that differ only in host bits share the node
+TEST_F(PrefixTrieTest, HostBits) {
+    Inet4Trie trie;
+    trie.Insert(Address("10.1.1.1"), 24, 1);
+    trie.Insert(Address("10.1.1.2"), 24, 2);
+
+    Inet4Trie::ValueList list;
+    trie.FindCovering(Address("10.1.1.0"), 24, &list);
+    EXPECT_EQ(2U, list.size());
+
+    EXPECT_TRUE(trie.Remove(Address("10.1.1.0"), 24, 1));
+    EXPECT_TRUE(trie.Remove(Address("10.1.1.3"), 24, 2));
+    EXPECT_TRUE(trie.empty());
+}
+
+TEST_F(PrefixTrieTest, Inet6) {
+    Inet6Trie trie;
+    trie.Insert(Ip6Address::from_string("2001:db8::"), 32, 1);
+    trie.Insert(Ip6Address::from_string("2001:db8:1::"), 48, 2);
+    trie.Insert(Ip6Address::from_string("2001:db9::"), 32, 3);
+
+    Inet6Trie::ValueList list;
+    trie.FindCovering(Ip6Address::from_string("2001:db8:1::1"), 128, &list);
+    ASSERT_EQ(2U, list.size());
+    EXPECT_EQ(2, list[0]);
+    EXPECT_EQ(1, list[1]);
+
+    list.clear();
+    trie.FindCovered(Ip6Address::from_string("2001:db8::"), 31, &list);
+    EXPECT_EQ(3U, list.size());
+
+    EXPECT_TRUE(trie.Remove(Ip6Address::from_string("2001:db8::"), 32, 1));
+    list.clear();
+    trie.FindCovering(Ip6Address::from_string("2001:db8:1::1"), 128, &list);
+    ASSERT_EQ(1U, list.size());
+    EXPECT_EQ(2, list[0]);
+}
+
+// Compare lookups against a linear walk over random prefixes
+TEST_F(PrefixTrieTest, Random) {
+    srand(1);
+    Inet4Trie trie;
+    vector<Prefix> prefixes;
+    vector<bool> present;
+    for (int i = 0; i < 512; i++) {
+        // Use few high order bits to have lot of nested prefixes
+        uint32_t addr = (rand() & 0xF0F0) << 16;
+        prefixes.push_back(Prefix(addr, rand() % 33));
+        present.push_back(true);
+        trie.Insert(Ip4Address(addr), prefixes[i].prefixlen, i);
+    }
+
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < 1000; i++) {
+            Prefix query((rand() & 0xF0F0) << 16, rand() % 33);
+
+            Inet4Trie::ValueList covering;
+            trie.FindCovering(Ip4Address(query.addr), query.prefixlen,
+                              &covering);
+            Inet4Trie::ValueList covered;
+            trie.FindCovered(Ip4Address(query.addr), query.prefixlen,
+                             &covered);
+
+            for (size_t j = 1; j < covering.size(); j++) {
+                EXPECT_GE(prefixes[covering[j - 1]].prefixlen,
+                          prefixes[covering[j]].prefixlen);
+            }
+
+            Inet4Trie::ValueList expected_covering;
+            Inet4Trie::ValueList expected_covered;
+            for (size_t j = 0; j < prefixes.size(); j++) {
+                if (!present[j])
+                    continue;
+                if (IsCovered(query, prefixes[j]))
+                    expected_covering.push_back(j);
+                if (IsCovered(prefixes[j], query))
+                    expected_covered.push_back(j);
+            }
+
+            std::sort(covering.begin(), covering.end());
+            std::sort(covered.begin(), covered.end());
+            EXPECT_TRUE(covering == expected_covering);
+            EXPECT_TRUE(covered == expected_covered);
+        }
+
+        // Remove half of the prefixes and verify again
+        for (size_t j = 0; j < prefixes.size(); j += 2) {
+            if (!present[j])
+                continue;
+            EXPECT_TRUE(trie.Remove(Ip4Address(prefixes[j].addr),
+                                    prefixes[j].prefixlen, j));
+            present[j] = false;
+        }
+        EXPECT_EQ(prefixes.size() / 2, trie.size());
+    }
+
+    for (size_t j = 1; j < prefixes.size(); j += 2) {
+        EXPECT_TRUE(trie.Remove(Ip4Address(prefixes[j].addr),
+                                prefixes[j].prefixlen, j));
+    }
+    EXPECT_TRUE(trie.empty());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
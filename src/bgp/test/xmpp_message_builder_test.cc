@@ -133,6 +133,7 @@ protected:
     }
 
     virtual void TearDown() {
+        BgpXmppMessage::item_template_disable_ = false;
         STLDeleteValues(&roattrs_);
         STLDeleteValues(&routes_);
         table_->RibOutDelete(
@@ -143,6 +144,45 @@ protected:
         task_util::WaitForIdle();
     }
 
+    void SetItemTemplateDisable(bool disable) {
+        BgpXmppMessage::item_template_disable_ = disable;
+    }
+
+    size_t RouteReprCacheSize() {
+        return static_cast<BgpXmppMessage *>(message_)->repr_cache_.Size();
+    }
+
+    string BuildMessage(const RibOutAttr *roattr, bool cache) {
+        message_->Start(ribout_, cache, roattr, routes_[0]);
+        message_->Finish();
+        XmppTestPeer peer("agent.juniper.net");
+        size_t msgsize;
+        const string *msg_str = NULL;
+        string temp;
+        const uint8_t *msg = message_->GetData(&peer, &msgsize, &msg_str,
+                                               &temp);
+        return string(reinterpret_cast<const char *>(msg), msgsize);
+    }
+
+    // Build a message with all routes, using the given RibOutAttr for all of
+    // them if specified, and return the data for a peer.
+    string BuildMessage(const RibOutAttr *roattr) {
+        message_->Start(ribout_, false, roattr ? roattr : roattrs_[0],
+            routes_[0]);
+        for (int ridx = 1; ridx < kRouteCount; ++ridx) {
+            message_->AddRoute(routes_[ridx],
+                roattr ? roattr : roattrs_[ridx]);
+        }
+        message_->Finish();
+        XmppTestPeer peer("agent.juniper.net");
+        size_t msgsize;
+        const string *msg_str = NULL;
+        string temp;
+        const uint8_t *msg = message_->GetData(&peer, &msgsize, &msg_str,
+                                               &temp);
+        return string(reinterpret_cast<const char *>(msg), msgsize);
+    }
+
     EventManager evm_;
     ServerThread thread_;
     BgpServerTestPtr bs_x_;
@@ -265,6 +305,63 @@ TEST_P(XmppMessageBuilderParamTest, Basic) {
     }
 }
 
+//
+// Items generated from the template must be identical to fully encoded ones
+// when all routes in the message have the same attributes.
+//
+TEST_F(XmppMessageBuilderTest, ItemTemplate) {
+    RibOutAttr roattr(table_, attr_.get(), 100, 0, true);
+    SetItemTemplateDisable(true);
+    string expected = BuildMessage(&roattr);
+    SetItemTemplateDisable(false);
+    string result = BuildMessage(&roattr);
+    EXPECT_EQ(expected, result);
+    for (int idx = 0; idx < kRouteCount; ++idx) {
+        string id = "id=\"" + routes_[idx]->ToXmppIdString() + "\"";
+        EXPECT_NE(string::npos, result.find(id));
+    }
+}
+
+//
+// Template must not be reused for routes with different attributes.
+//
+TEST_F(XmppMessageBuilderTest, ItemTemplateDifferentAttributes) {
+    SetItemTemplateDisable(true);
+    string expected = BuildMessage(NULL);
+    SetItemTemplateDisable(false);
+    string result = BuildMessage(NULL);
+    EXPECT_EQ(expected, result);
+}
+
+//
+// Formatted route is shared by RibOutAttrs with the same value and is
+// released when the last such RibOutAttr goes away.
+//
+TEST_F(XmppMessageBuilderTest, RouteReprCache) {
+    EXPECT_EQ(0, RouteReprCacheSize());
+    {
+        RibOutAttr roattr1(table_, attr_.get(), 100, 0, true);
+        RibOutAttr roattr2(roattr1);
+        RibOutAttr roattr3(table_, attr_.get(), 200, 0, true);
+
+        string msg1 = BuildMessage(&roattr1, true);
+        EXPECT_FALSE(roattr1.repr().empty());
+        EXPECT_TRUE(roattr2.repr().empty());
+        EXPECT_EQ(1, RouteReprCacheSize());
+
+        string msg2 = BuildMessage(&roattr2, false);
+        EXPECT_EQ(msg1, msg2);
+        EXPECT_EQ(&roattr1.repr(), &roattr2.repr());
+        EXPECT_EQ(1, RouteReprCacheSize());
+
+        string msg3 = BuildMessage(&roattr3, false);
+        EXPECT_NE(msg1, msg3);
+        EXPECT_TRUE(roattr3.repr().empty());
+        EXPECT_EQ(1, RouteReprCacheSize());
+    }
+    EXPECT_EQ(0, RouteReprCacheSize());
+}
+
 class XmppMvpnMessageBuilderParamTest:
     public XmppMvpnMessageBuilderTest,
     public ::testing::WithParamInterface<TestParams> {
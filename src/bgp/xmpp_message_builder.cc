@@ -73,6 +73,117 @@ static inline const char *XmppSafiName(uint8_t safi) {
     return NULL;
 }
 
+bool BgpXmppMessage::item_template_disable_ =
+    (getenv("BGP_XMPP_ITEM_TEMPLATE_DISABLE") != NULL);
+
+//
+// Return true if the string can be emitted as an attribute value or as
+// element text without any escaping.
+//
+static inline bool IsXmlSafe(const string &value) {
+    for (string::const_iterator it = value.begin(); it != value.end(); ++it) {
+        unsigned char c = *it;
+        if (c < 0x20 || c == '&' || c == '<' || c == '>' ||
+            c == '"' || c == '\'') {
+            return false;
+        }
+    }
+    return true;
+}
+
+BgpXmppMessage::ItemTemplate::ItemTemplate()
+    : built_(false), valid_(false), key_(0) {
+}
+
+void BgpXmppMessage::ItemTemplate::Clear() {
+    built_ = false;
+    valid_ = false;
+    roattr_.clear();
+    key_ = 0;
+    segments_.clear();
+    fields_.clear();
+}
+
+const char *BgpXmppMessage::ItemTemplate::Placeholder(Field field) {
+    static const char *placeholders[FIELD_COUNT] = {
+        "@@bgp-xmpp-item-id@@",
+        "@@bgp-xmpp-item-address@@",
+        "@@bgp-xmpp-item-mac@@",
+        "@@bgp-xmpp-item-source@@",
+        "@@bgp-xmpp-item-group@@",
+    };
+    return placeholders[field];
+}
+
+//
+// Return true if the template has been built for the given RibOutAttr and
+// key. The key is used for route specific fields that are not strings and
+// hence can't be substituted.
+//
+bool BgpXmppMessage::ItemTemplate::IsBuilt(const RibOutAttr *roattr,
+    uint32_t key) const {
+    return (built_ && key_ == key && roattr_ == *roattr);
+}
+
+//
+// Build the template from an item that was encoded with the placeholders.
+// The template is marked invalid if any placeholder that was used does not
+// appear exactly once in the encoded item.
+//
+void BgpXmppMessage::ItemTemplate::Build(const RibOutAttr *roattr,
+    uint32_t key, const string *placeholders, const string &repr) {
+    Clear();
+    built_ = true;
+    roattr_ = *roattr;
+    key_ = key;
+
+    vector<std::pair<size_t, Field> > positions;
+    for (int idx = 0; idx < FIELD_COUNT; ++idx) {
+        const string &placeholder = placeholders[idx];
+        if (placeholder.empty())
+            continue;
+        size_t pos = repr.find(placeholder);
+        if (pos == string::npos)
+            return;
+        if (repr.find(placeholder, pos + placeholder.size()) != string::npos)
+            return;
+        positions.push_back(std::make_pair(pos, static_cast<Field>(idx)));
+    }
+    std::sort(positions.begin(), positions.end());
+
+    size_t start = 0;
+    for (size_t idx = 0; idx < positions.size(); ++idx) {
+        size_t pos = positions[idx].first;
+        Field field = positions[idx].second;
+        segments_.push_back(string(repr, start, pos - start));
+        fields_.push_back(field);
+        start = pos + placeholders[field].size();
+    }
+    segments_.push_back(string(repr, start));
+    valid_ = true;
+}
+
+//
+// Append the item for a route with the given field values. Returns false
+// if the template is not usable for the values, in which case nothing is
+// appended and the item needs to be fully encoded.
+//
+bool BgpXmppMessage::ItemTemplate::Append(const string *values,
+    string *repr) const {
+    if (!valid_)
+        return false;
+    for (size_t idx = 0; idx < fields_.size(); ++idx) {
+        if (!IsXmlSafe(values[fields_[idx]]))
+            return false;
+    }
+    for (size_t idx = 0; idx < fields_.size(); ++idx) {
+        *repr += segments_[idx];
+        *repr += values[fields_[idx]];
+    }
+    *repr += segments_.back();
+    return true;
+}
+
 BgpXmppMessage::BgpXmppMessage()
     : table_(NULL),
       writer_(XmlWriter(&repr_)),
@@ -94,6 +205,7 @@ void BgpXmppMessage::Reset() {
     cache_routes_ = false;
     repr_valid_ = false;
     repr_.clear();
+    item_template_.Clear();
 }
 
 bool BgpXmppMessage::Start(const RibOut *ribout, bool cache_routes,
@@ -101,7 +213,10 @@ bool BgpXmppMessage::Start(const RibOut *ribout, bool cache_routes,
     Reset();
     table_ = ribout->table();
     is_reachable_ = roattr->IsReachable();
-    cache_routes_ = cache_routes;
+
+    // Also cache the formatted routes if there are other RibOuts for the
+    // table, since the same routes are likely to be advertised via them.
+    cache_routes_ = cache_routes || table_->ribout_map().size() > 1;
     Address::Family family = table_->family();
 
     if (is_reachable_) {
@@ -140,7 +255,12 @@ bool BgpXmppMessage::Start(const RibOut *ribout, bool cache_routes,
     return true;
 }
 
+//
+// Release the template as it holds a reference to the BgpAttr. It's not
+// needed once all routes have been added.
+//
 void BgpXmppMessage::Finish() {
+    item_template_.Clear();
 }
 
 bool BgpXmppMessage::AddRoute(const BgpRoute *route, const RibOutAttr *roattr) {
@@ -201,18 +321,36 @@ void BgpXmppMessage::EncodeNextHop(const BgpRoute *route,
     item->entry.next_hops.next_hop.push_back(item_nexthop);
 }
 
-void BgpXmppMessage::AddIpReach(const BgpRoute *route,
-                                const RibOutAttr *roattr) {
-    if (!roattr->repr().empty()) {
-        repr_ += roattr->repr();
-        return;
+//
+// Add the formatted route from the RibOutAttr, or from the RouteReprCache if
+// it was encoded for another RibOutAttr with the same value e.g. in another
+// RibOut or for an UpdateInfo that was processed earlier.
+//
+bool BgpXmppMessage::AddCachedRoute(const BgpRoute *route,
+    const RibOutAttr *roattr) {
+    if (roattr->repr().empty()) {
+        if (repr_cache_.empty() || !repr_cache_.Lookup(route, roattr))
+            return false;
     }
+    repr_ += roattr->repr();
+    return true;
+}
+
+void BgpXmppMessage::InitPlaceholders(string *placeholders) const {
+    for (int idx = 0; idx < ItemTemplate::FIELD_COUNT; ++idx) {
+        placeholders[idx] =
+            ItemTemplate::Placeholder(static_cast<ItemTemplate::Field>(idx));
+    }
+}
+
+void BgpXmppMessage::EncodeIpReach(const BgpRoute *route,
+    const RibOutAttr *roattr, const string *values, string *repr) {
     Address::Family family = table_->family();
 
     autogen::ItemType item;
     item.entry.nlri.af = BgpAf::FamilyToAfi(family);
     item.entry.nlri.safi = BgpAf::FamilyToXmppSafi(family);
-    item.entry.nlri.address = route->ToString();
+    item.entry.nlri.address = values[ItemTemplate::ADDRESS];
     item.entry.version = 1;
     item.entry.virtual_network = GetVirtualNetwork(route, roattr);
     item.entry.local_preference = roattr->attr()->local_pref();
@@ -243,19 +381,50 @@ void BgpXmppMessage::AddIpReach(const BgpRoute *route,
         load_balance_attribute_.Encode(&item.entry.load_balance);
 
     xml_node node = doc_.append_child("item");
-    node.append_attribute("id") = route->ToXmppIdString().c_str();
+    node.append_attribute("id") = values[ItemTemplate::ID].c_str();
 
-    // Remember the previous size.
     // Using remove_child instead of reset allows memory pages allocated for
     // the xml_document to be reused during the lifetime of the xml_document.
-    size_t pos = repr_.size();
+    XmlWriter writer(repr);
     item.Encode(&node);
-    doc_.print(writer_, "\t", pugi::format_default, pugi::encoding_auto, 3);
+    doc_.print(writer, "\t", pugi::format_default, pugi::encoding_auto, 3);
     doc_.remove_child(node);
+}
+
+//
+// The autogen item and the pugi DOM are built only for the first route in
+// the message, with placeholders for the route specific fields. Subsequent
+// routes in the message have the same RibOutAttr and are emitted directly
+// from the resulting ItemTemplate.
+//
+void BgpXmppMessage::AddIpReach(const BgpRoute *route,
+                                const RibOutAttr *roattr) {
+    if (AddCachedRoute(route, roattr))
+        return;
+
+    string values[ItemTemplate::FIELD_COUNT];
+    values[ItemTemplate::ID] = route->ToXmppIdString();
+    values[ItemTemplate::ADDRESS] = route->ToString();
+
+    if (!item_template_disable_ && !item_template_.IsBuilt(roattr, 0)) {
+        string placeholders[ItemTemplate::FIELD_COUNT];
+        InitPlaceholders(placeholders);
+        placeholders[ItemTemplate::MAC].clear();
+        placeholders[ItemTemplate::SOURCE].clear();
+        placeholders[ItemTemplate::GROUP].clear();
+        string repr;
+        EncodeIpReach(route, roattr, placeholders, &repr);
+        item_template_.Build(roattr, 0, placeholders, repr);
+    }
+
+    // Remember the previous size.
+    size_t pos = repr_.size();
+    if (!item_template_.Append(values, &repr_))
+        EncodeIpReach(route, roattr, values, &repr_);
 
     // Cache the substring starting at the previous size.
     if (cache_routes_)
-        roattr->set_repr(repr_, pos);
+        repr_cache_.Insert(route, roattr, repr_, pos);
 }
 
 void BgpXmppMessage::AddIpUnreach(const BgpRoute *route) {
@@ -310,12 +479,8 @@ void BgpXmppMessage::EncodeEnetNextHop(const BgpRoute *route,
     item->entry.next_hops.next_hop.push_back(item_nexthop);
 }
 
-void BgpXmppMessage::AddEnetReach(const BgpRoute *route,
-                                  const RibOutAttr *roattr) {
-    if (!roattr->repr().empty()) {
-        repr_ += roattr->repr();
-        return;
-    }
+void BgpXmppMessage::EncodeEnetReach(const BgpRoute *route,
+    const RibOutAttr *roattr, const string *values, string *repr) {
     Address::Family family = table_->family();
 
     autogen::EnetItemType item;
@@ -326,11 +491,10 @@ void BgpXmppMessage::AddEnetReach(const BgpRoute *route,
         static_cast<EvpnRoute *>(const_cast<BgpRoute *>(route));
     const EvpnPrefix &evpn_prefix = evpn_route->GetPrefix();
     item.entry.nlri.ethernet_tag = evpn_prefix.tag();
-    item.entry.nlri.mac = evpn_prefix.mac_addr().ToString();
-    item.entry.nlri.address = evpn_prefix.ip_address().to_string() + "/" +
-        integerToString(evpn_prefix.ip_address_length());
-    item.entry.nlri.source = evpn_prefix.source().to_string();
-    item.entry.nlri.group = evpn_prefix.group().to_string();
+    item.entry.nlri.mac = values[ItemTemplate::MAC];
+    item.entry.nlri.address = values[ItemTemplate::ADDRESS];
+    item.entry.nlri.source = values[ItemTemplate::SOURCE];
+    item.entry.nlri.group = values[ItemTemplate::GROUP];
 
     item.entry.virtual_network = GetVirtualNetwork(route, roattr);
     item.entry.local_preference = roattr->attr()->local_pref();
@@ -380,19 +544,52 @@ void BgpXmppMessage::AddEnetReach(const BgpRoute *route,
     }
 
     xml_node node = doc_.append_child("item");
-    node.append_attribute("id") = route->ToXmppIdString().c_str();
+    node.append_attribute("id") = values[ItemTemplate::ID].c_str();
 
-    // Remember the previous size.
     // Using remove_child instead of reset allows memory pages allocated for
     // the xml_document to be reused during the lifetime of the xml_document.
-    size_t pos = repr_.size();
+    XmlWriter writer(repr);
     item.Encode(&node);
-    doc_.print(writer_, "\t", pugi::format_default, pugi::encoding_auto, 3);
+    doc_.print(writer, "\t", pugi::format_default, pugi::encoding_auto, 3);
     doc_.remove_child(node);
+}
+
+//
+// Same as AddIpReach, except that the ethernet tag is part of the template
+// key since it's not a string.
+//
+void BgpXmppMessage::AddEnetReach(const BgpRoute *route,
+                                  const RibOutAttr *roattr) {
+    if (AddCachedRoute(route, roattr))
+        return;
+
+    const EvpnRoute *evpn_route = static_cast<const EvpnRoute *>(route);
+    const EvpnPrefix &evpn_prefix = evpn_route->GetPrefix();
+    string values[ItemTemplate::FIELD_COUNT];
+    values[ItemTemplate::ID] = route->ToXmppIdString();
+    values[ItemTemplate::MAC] = evpn_prefix.mac_addr().ToString();
+    values[ItemTemplate::ADDRESS] = evpn_prefix.ip_address().to_string() +
+        "/" + integerToString(evpn_prefix.ip_address_length());
+    values[ItemTemplate::SOURCE] = evpn_prefix.source().to_string();
+    values[ItemTemplate::GROUP] = evpn_prefix.group().to_string();
+
+    uint32_t key = evpn_prefix.tag();
+    if (!item_template_disable_ && !item_template_.IsBuilt(roattr, key)) {
+        string placeholders[ItemTemplate::FIELD_COUNT];
+        InitPlaceholders(placeholders);
+        string repr;
+        EncodeEnetReach(route, roattr, placeholders, &repr);
+        item_template_.Build(roattr, key, placeholders, repr);
+    }
+
+    // Remember the previous size.
+    size_t pos = repr_.size();
+    if (!item_template_.Append(values, &repr_))
+        EncodeEnetReach(route, roattr, values, &repr_);
 
     // Cache the substring starting at the previous size.
     if (cache_routes_)
-        roattr->set_repr(repr_, pos);
+        repr_cache_.Insert(route, roattr, repr_, pos);
 }
 
 void BgpXmppMessage::AddEnetUnreach(const BgpRoute *route) {
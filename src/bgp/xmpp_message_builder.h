@@ -44,6 +44,8 @@ public:
                                    std::string *temp);
 
 private:
+    friend class XmppMessageBuilderTest;
+
     static const size_t kMaxFromToLength = 192;
     static const uint32_t kMaxReachCount = 32;
     static const uint32_t kMaxUnreachCount = 256;
@@ -59,6 +61,50 @@ private:
         std::string *repr_;
     };
 
+    //
+    // Encoded item for a reachable route, split at the route specific fields.
+    //
+    // All routes that are packed into a message have the same RibOutAttr, so
+    // the items for the routes differ only in the fields derived from the
+    // route itself. The template is built by encoding the first item with a
+    // placeholder for each such field. The item for every route in the same
+    // message is then generated by splicing the route's field values between
+    // the segments, without building the autogen item and the pugi DOM.
+    //
+    // The template is used only if each placeholder occurs exactly once in
+    // the encoded item, and only for field values that do not need any xml
+    // escaping. This guarantees that the output is identical to that of the
+    // full encode.
+    //
+    class ItemTemplate {
+    public:
+        enum Field {
+            ID,
+            ADDRESS,
+            MAC,
+            SOURCE,
+            GROUP,
+            FIELD_COUNT
+        };
+
+        ItemTemplate();
+        void Clear();
+        bool IsBuilt(const RibOutAttr *roattr, uint32_t key) const;
+        void Build(const RibOutAttr *roattr, uint32_t key,
+                   const std::string *placeholders, const std::string &repr);
+        bool Append(const std::string *values, std::string *repr) const;
+
+        static const char *Placeholder(Field field);
+
+    private:
+        bool built_;
+        bool valid_;
+        RibOutAttr roattr_;
+        uint32_t key_;
+        std::vector<std::string> segments_;
+        std::vector<Field> fields_;
+    };
+
     struct MobilityInfo {
     public:
         MobilityInfo(uint32_t seqno, bool sticky)
@@ -72,6 +118,8 @@ private:
     void EncodeNextHop(const BgpRoute *route,
                        const RibOutAttr::NextHop &nexthop,
                        autogen::ItemType *item);
+    void EncodeIpReach(const BgpRoute *route, const RibOutAttr *roattr,
+                       const std::string *values, std::string *repr);
     void AddIpReach(const BgpRoute *route, const RibOutAttr *roattr);
     void AddIpUnreach(const BgpRoute *route);
     bool AddInetRoute(const BgpRoute *route, const RibOutAttr *roattr);
@@ -81,6 +129,8 @@ private:
     void EncodeEnetNextHop(const BgpRoute *route,
                            const RibOutAttr::NextHop &nexthop,
                            autogen::EnetItemType *item);
+    void EncodeEnetReach(const BgpRoute *route, const RibOutAttr *roattr,
+                         const std::string *values, std::string *repr);
     void AddEnetReach(const BgpRoute *route, const RibOutAttr *roattr);
     void AddEnetUnreach(const BgpRoute *route);
     bool AddEnetRoute(const BgpRoute *route, const RibOutAttr *roattr);
@@ -93,6 +143,8 @@ private:
     void AddMvpnUnreach(const BgpRoute *route);
     bool AddMvpnRoute(const BgpRoute *route, const RibOutAttr *roattr);
 
+    bool AddCachedRoute(const BgpRoute *route, const RibOutAttr *roattr);
+    void InitPlaceholders(std::string *placeholders) const;
     void ProcessCommunity(const Community *community);
     void ProcessExtCommunity(const ExtCommunity *ext_community);
     std::string GetVirtualNetwork(const RibOutAttr::NextHop &nexthop) const;
@@ -107,6 +159,8 @@ private:
     std::string msg_begin_;
     std::string repr_;
     pugi::xml_document doc_;
+    ItemTemplate item_template_;
+    RouteReprCache repr_cache_;
     MobilityInfo mobility_;
     bool etree_leaf_;
 
@@ -114,6 +168,8 @@ private:
     std::vector<std::string> community_list_;
     LoadBalance::LoadBalanceAttribute load_balance_attribute_;
 
+    static bool item_template_disable_;
+
     DISALLOW_COPY_AND_ASSIGN(BgpXmppMessage);
 };
 
@@ -281,6 +281,7 @@ int main(int argc, char *argv[]) {
     DB config_db(TaskScheduler::GetInstance()->GetTaskId("db::IFMapTable"));
     DBGraph config_graph;
     IFMapServer ifmap_server(&config_db, &config_graph, evm.io_service());
+    ifmap_server.set_client_snapshot_enable(options.ifmap_client_snapshot());
 
     ConfigFactory::Register<ConfigJsonParserBase>(
                           boost::factory<ConfigJsonParser *>());
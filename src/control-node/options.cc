@@ -131,6 +131,9 @@ void Options::Initialize(EventManager &evm,
              "Enable local logging of sandesh messages")
         ("DEFAULT.mvpn_ipv4_enable", opt::bool_switch(&mvpn_ipv4_enable_),
              "Enable NGEN Multicast VPN support for IPv4 routes")
+        ("DEFAULT.ifmap_client_snapshot",
+             opt::bool_switch(&ifmap_client_snapshot_),
+             "Send initial config to new agents as a snapshot")
         ("DEFAULT.use_syslog", opt::bool_switch(&use_syslog_),
              "Enable logging to syslog")
         ("DEFAULT.syslog_facility",
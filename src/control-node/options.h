@@ -38,6 +38,7 @@ public:
     bool use_syslog() const { return use_syslog_; }
     std::string syslog_facility() const { return syslog_facility_; }
     bool mvpn_ipv4_enable() const { return mvpn_ipv4_enable_; }
+    bool ifmap_client_snapshot() const { return ifmap_client_snapshot_; }
     bool task_track_run_time() const { return task_track_run_time_; }
     std::string config_db_user() const {
         return configdb_options_.config_db_username;
@@ -125,6 +126,7 @@ private:
     bool use_syslog_;
     std::string syslog_facility_;
     bool mvpn_ipv4_enable_;
+    bool ifmap_client_snapshot_;
     bool task_track_run_time_;
     ConfigClientOptions configdb_options_;
     uint16_t xmpp_port_;
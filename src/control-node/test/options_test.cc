@@ -74,6 +74,7 @@ TEST_F(OptionsTest, NoArguments) {
     EXPECT_EQ(options_.log_level(), "SYS_NOTICE");
     EXPECT_EQ(options_.log_local(), true);
     EXPECT_EQ(options_.mvpn_ipv4_enable(), false);
+    EXPECT_EQ(options_.ifmap_client_snapshot(), false);
     EXPECT_EQ(options_.config_db_user(), "");
     EXPECT_EQ(options_.config_db_password(), "");
     EXPECT_EQ(options_.config_db_use_ssl(), false);
@@ -14,6 +14,8 @@
 #include <boost/intrusive/list.hpp>
 #include <boost/intrusive/set.hpp>
 
+struct DBEntryBTreeLeaf;
+
 struct DBState {
     virtual ~DBState() { }
 };
@@ -86,13 +88,14 @@ private:
     DISALLOW_COPY_AND_ASSIGN(DBEntryBase);
 };
 
-// An implementation of DBEntryBase that uses boost::set as data-store
+// An implementation of DBEntryBase that uses boost::set or DBEntryBTree as
+// data-store
 // Most of the DB Table implementations should derive from here instead of
 // DBEntryBase directly.
 // Derive directly from DBEntryBase only if there is a strong reason to do so
 class DBEntry : public DBEntryBase {
 public:
-    DBEntry() { };
+    DBEntry() : btree_leaf_(NULL) { };
     virtual ~DBEntry() { };
 
     // Set key fields in the DBEntry
@@ -107,7 +110,10 @@ public:
 
 private:
     friend class DBTablePartition;
+    friend class DBEntryBTree;
     boost::intrusive::set_member_hook<> node_;
+    // Leaf holding the entry when partition uses DBEntryBTree
+    DBEntryBTreeLeaf *btree_leaf_;
     DISALLOW_COPY_AND_ASSIGN(DBEntry);
 };
 
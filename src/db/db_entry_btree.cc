@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2017 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "db/db_entry_btree.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "db/db_entry.h"
+
+struct DBEntryBTreeNode {
+    explicit DBEntryBTreeNode(bool is_leaf)
+        : parent(NULL), count(0), is_leaf(is_leaf) {
+    }
+    DBEntryBTreeInner *parent;
+    int count;
+    bool is_leaf;
+};
+
+struct DBEntryBTreeLeaf : public DBEntryBTreeNode {
+    DBEntryBTreeLeaf() : DBEntryBTreeNode(true), prev(NULL), next(NULL) {
+    }
+    DBEntryBTreeLeaf *prev;
+    DBEntryBTreeLeaf *next;
+    DBEntry *entries[DBEntryBTree::kLeafSize];
+};
+
+struct DBEntryBTreeInner : public DBEntryBTreeNode {
+    DBEntryBTreeInner() : DBEntryBTreeNode(false) {
+    }
+    // keys[i] is the smallest entry in the subtree of children[i]
+    const DBEntry *keys[DBEntryBTree::kInnerSize];
+    DBEntryBTreeNode *children[DBEntryBTree::kInnerSize];
+};
+
+static DBEntryBTreeLeaf *ToLeaf(DBEntryBTreeNode *node) {
+    assert(node->is_leaf);
+    return static_cast<DBEntryBTreeLeaf *>(node);
+}
+
+static DBEntryBTreeInner *ToInner(DBEntryBTreeNode *node) {
+    assert(!node->is_leaf);
+    return static_cast<DBEntryBTreeInner *>(node);
+}
+
+static const DBEntry *NodeMin(DBEntryBTreeNode *node) {
+    if (node->is_leaf)
+        return ToLeaf(node)->entries[0];
+    return ToInner(node)->keys[0];
+}
+
+static int ChildIndex(const DBEntryBTreeInner *inner,
+                      const DBEntryBTreeNode *child) {
+    for (int i = 0; i < inner->count; i++) {
+        if (inner->children[i] == child)
+            return i;
+    }
+    assert(false);
+    return -1;
+}
+
+// Index of the child whose subtree may contain key
+static int InnerLowerBound(const DBEntryBTreeInner *inner,
+                           const DBEntry *key) {
+    int low = 1, high = inner->count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (*key < *inner->keys[mid]) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return low - 1;
+}
+
+// Index of the first entry not less than key
+static int LeafLowerBound(const DBEntryBTreeLeaf *leaf, const DBEntry *key) {
+    int low = 0, high = leaf->count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (*leaf->entries[mid] < *key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+DBEntryBTree::DBEntryBTree() : root_(NULL), head_(NULL), count_(0) {
+}
+
+DBEntryBTree::~DBEntryBTree() {
+    DeleteTree(root_);
+}
+
+void DBEntryBTree::DeleteTree(DBEntryBTreeNode *node) {
+    if (node == NULL)
+        return;
+    if (node->is_leaf) {
+        delete ToLeaf(node);
+        return;
+    }
+    DBEntryBTreeInner *inner = ToInner(node);
+    for (int i = 0; i < inner->count; i++) {
+        DeleteTree(inner->children[i]);
+    }
+    delete inner;
+}
+
+DBEntryBTreeLeaf *DBEntryBTree::FindLeaf(const DBEntry *key) const {
+    DBEntryBTreeNode *node = root_;
+    if (node == NULL)
+        return NULL;
+    while (!node->is_leaf) {
+        DBEntryBTreeInner *inner = ToInner(node);
+        node = inner->children[InnerLowerBound(inner, key)];
+    }
+    return ToLeaf(node);
+}
+
+bool DBEntryBTree::Insert(DBEntry *entry) {
+    if (root_ == NULL) {
+        head_ = new DBEntryBTreeLeaf();
+        root_ = head_;
+    }
+
+    DBEntryBTreeLeaf *leaf = FindLeaf(entry);
+    int pos = LeafLowerBound(leaf, entry);
+    if (pos < leaf->count && !(*entry < *leaf->entries[pos]))
+        return false;
+
+    if (leaf->count == kLeafSize) {
+        SplitLeaf(leaf);
+        if (pos > leaf->count) {
+            pos -= leaf->count;
+            leaf = leaf->next;
+        }
+    }
+
+    memmove(&leaf->entries[pos + 1], &leaf->entries[pos],
+            (leaf->count - pos) * sizeof(leaf->entries[0]));
+    leaf->entries[pos] = entry;
+    leaf->count++;
+    entry->btree_leaf_ = leaf;
+    count_++;
+
+    if (pos == 0)
+        UpdateMin(leaf, entry);
+    return true;
+}
+
+bool DBEntryBTree::Remove(DBEntry *entry) {
+    DBEntryBTreeLeaf *leaf = entry->btree_leaf_;
+    if (leaf == NULL)
+        return false;
+
+    int pos = 0;
+    while (pos < leaf->count && leaf->entries[pos] != entry)
+        pos++;
+    if (pos == leaf->count)
+        return false;
+
+    memmove(&leaf->entries[pos], &leaf->entries[pos + 1],
+            (leaf->count - pos - 1) * sizeof(leaf->entries[0]));
+    leaf->count--;
+    entry->btree_leaf_ = NULL;
+    count_--;
+
+    if (leaf->count == 0) {
+        RemoveNode(leaf);
+        return true;
+    }
+    if (pos == 0)
+        UpdateMin(leaf, leaf->entries[0]);
+    MergeLeaf(leaf);
+    return true;
+}
+
+DBEntry *DBEntryBTree::Find(const DBEntry *key) const {
+    DBEntryBTreeLeaf *leaf = FindLeaf(key);
+    if (leaf == NULL)
+        return NULL;
+    int pos = LeafLowerBound(leaf, key);
+    if (pos < leaf->count && !(*key < *leaf->entries[pos]))
+        return leaf->entries[pos];
+    return NULL;
+}
+
+DBEntry *DBEntryBTree::LowerBound(const DBEntry *key) const {
+    DBEntryBTreeLeaf *leaf = FindLeaf(key);
+    if (leaf == NULL)
+        return NULL;
+    int pos = LeafLowerBound(leaf, key);
+    if (pos < leaf->count)
+        return leaf->entries[pos];
+    return leaf->next ? leaf->next->entries[0] : NULL;
+}
+
+DBEntry *DBEntryBTree::UpperBound(const DBEntry *key) const {
+    DBEntryBTreeLeaf *leaf = FindLeaf(key);
+    if (leaf == NULL)
+        return NULL;
+    int pos = LeafLowerBound(leaf, key);
+    if (pos < leaf->count && !(*key < *leaf->entries[pos]))
+        pos++;
+    if (pos < leaf->count)
+        return leaf->entries[pos];
+    return leaf->next ? leaf->next->entries[0] : NULL;
+}
+
+DBEntry *DBEntryBTree::GetFirst() const {
+    return head_ ? head_->entries[0] : NULL;
+}
+
+DBEntry *DBEntryBTree::GetNext(const DBEntry *entry) const {
+    DBEntryBTreeLeaf *leaf = entry->btree_leaf_;
+    assert(leaf != NULL);
+    for (int i = 0; i < leaf->count - 1; i++) {
+        if (leaf->entries[i] == entry)
+            return leaf->entries[i + 1];
+    }
+    assert(leaf->entries[leaf->count - 1] == entry);
+    return leaf->next ? leaf->next->entries[0] : NULL;
+}
+
+// Move upper half of a full leaf to a new leaf on its right
+void DBEntryBTree::SplitLeaf(DBEntryBTreeLeaf *leaf) {
+    DBEntryBTreeLeaf *right = new DBEntryBTreeLeaf();
+    int half = leaf->count / 2;
+    right->count = leaf->count - half;
+    for (int i = 0; i < right->count; i++) {
+        right->entries[i] = leaf->entries[half + i];
+        right->entries[i]->btree_leaf_ = right;
+    }
+    leaf->count = half;
+
+    right->next = leaf->next;
+    if (right->next)
+        right->next->prev = right;
+    right->prev = leaf;
+    leaf->next = right;
+
+    InsertChild(leaf, right, right->entries[0]);
+}
+
+// Add child with smallest entry min to the parent of node, right after node.
+// Parent is split if full and a new root is added when node is the root.
+void DBEntryBTree::InsertChild(DBEntryBTreeNode *node,
+                               DBEntryBTreeNode *child, const DBEntry *min) {
+    DBEntryBTreeInner *parent = node->parent;
+    if (parent == NULL) {
+        parent = new DBEntryBTreeInner();
+        parent->keys[0] = NodeMin(node);
+        parent->children[0] = node;
+        parent->count = 1;
+        node->parent = parent;
+        root_ = parent;
+    }
+
+    int index = ChildIndex(parent, node) + 1;
+    if (parent->count == kInnerSize) {
+        DBEntryBTreeInner *right = new DBEntryBTreeInner();
+        int half = parent->count / 2;
+        right->count = parent->count - half;
+        for (int i = 0; i < right->count; i++) {
+            right->keys[i] = parent->keys[half + i];
+            right->children[i] = parent->children[half + i];
+            right->children[i]->parent = right;
+        }
+        parent->count = half;
+        InsertChild(parent, right, right->keys[0]);
+        if (index > half) {
+            index -= half;
+            parent = right;
+        }
+    }
+
+    memmove(&parent->keys[index + 1], &parent->keys[index],
+            (parent->count - index) * sizeof(parent->keys[0]));
+    memmove(&parent->children[index + 1], &parent->children[index],
+            (parent->count - index) * sizeof(parent->children[0]));
+    parent->keys[index] = min;
+    parent->children[index] = child;
+    parent->count++;
+    child->parent = parent;
+}
+
+// Remove an empty node from the tree. Parent is removed if it becomes empty
+// and the root is collapsed while it has a single child.
+void DBEntryBTree::RemoveNode(DBEntryBTreeNode *node) {
+    assert(node->count == 0);
+    DBEntryBTreeInner *parent = node->parent;
+    int index = parent ? ChildIndex(parent, node) : 0;
+
+    if (node->is_leaf) {
+        DBEntryBTreeLeaf *leaf = ToLeaf(node);
+        if (leaf->prev)
+            leaf->prev->next = leaf->next;
+        if (leaf->next)
+            leaf->next->prev = leaf->prev;
+        if (head_ == leaf)
+            head_ = leaf->next;
+        delete leaf;
+    } else {
+        delete ToInner(node);
+    }
+
+    if (parent == NULL) {
+        root_ = NULL;
+        return;
+    }
+
+    memmove(&parent->keys[index], &parent->keys[index + 1],
+            (parent->count - index - 1) * sizeof(parent->keys[0]));
+    memmove(&parent->children[index], &parent->children[index + 1],
+            (parent->count - index - 1) * sizeof(parent->children[0]));
+    parent->count--;
+    if (parent->count == 0) {
+        RemoveNode(parent);
+        return;
+    }
+    if (index == 0)
+        UpdateMin(parent, parent->keys[0]);
+
+    while (!root_->is_leaf && root_->count == 1) {
+        DBEntryBTreeInner *root = ToInner(root_);
+        root_ = root->children[0];
+        root_->parent = NULL;
+        delete root;
+    }
+}
+
+// Merge a sparse leaf with a sibling under the same parent when the result
+// is atmost half full.
+void DBEntryBTree::MergeLeaf(DBEntryBTreeLeaf *leaf) {
+    if (leaf->count >= kLeafSize / 4)
+        return;
+
+    DBEntryBTreeLeaf *left = leaf->prev;
+    DBEntryBTreeLeaf *right = leaf;
+    if (leaf->next && leaf->next->parent == leaf->parent &&
+        leaf->count + leaf->next->count <= kLeafSize / 2) {
+        left = leaf;
+        right = leaf->next;
+    } else if (left == NULL || left->parent != leaf->parent ||
+               left->count + leaf->count > kLeafSize / 2) {
+        return;
+    }
+
+    for (int i = 0; i < right->count; i++) {
+        left->entries[left->count + i] = right->entries[i];
+        right->entries[i]->btree_leaf_ = left;
+    }
+    left->count += right->count;
+    right->count = 0;
+    RemoveNode(right);
+}
+
+// Update the separator of node in its ancestors after its smallest entry
+// changed.
+void DBEntryBTree::UpdateMin(DBEntryBTreeNode *node, const DBEntry *min) {
+    while (node->parent != NULL) {
+        DBEntryBTreeInner *parent = node->parent;
+        int index = ChildIndex(parent, node);
+        parent->keys[index] = min;
+        if (index > 0)
+            break;
+        node = parent;
+    }
+}
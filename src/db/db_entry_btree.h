@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2017 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef ctrlplane_db_entry_btree_h
+#define ctrlplane_db_entry_btree_h
+
+#include <stddef.h>
+
+#include "base/util.h"
+
+class DBEntry;
+struct DBEntryBTreeNode;
+struct DBEntryBTreeLeaf;
+struct DBEntryBTreeInner;
+
+//
+// DBEntryBTree
+// B+ tree of DBEntry ordered on DBEntry::IsLess. Used as storage of a
+// DBTablePartition in place of the red-black tree when the table asks for
+// it. Entries are packed kLeafSize per leaf and leaves are chained, so that
+// walks and lookups touch far fewer cache lines than the red-black tree.
+//
+// Every entry keeps a pointer to its leaf, so GetNext of an entry does not
+// search the tree. The pointer is updated whenever entries move across
+// leaves.
+//
+// Inner nodes keep the smallest entry of every child as the separator.
+// Leaves that become sparse on removal are merged with a sibling. Inner
+// nodes are removed only when they become empty.
+//
+// The tree does not own the entries and is not thread-safe.
+//
+class DBEntryBTree {
+public:
+    static const int kLeafSize = 64;
+    static const int kInnerSize = 64;
+
+    DBEntryBTree();
+    ~DBEntryBTree();
+
+    // Add entry to the tree. Returns false if an entry with same key exists.
+    bool Insert(DBEntry *entry);
+
+    // Remove entry from the tree. Returns false if entry is not in the tree.
+    bool Remove(DBEntry *entry);
+
+    DBEntry *Find(const DBEntry *key) const;
+    // Returns the matching entry or next in lex order
+    DBEntry *LowerBound(const DBEntry *key) const;
+    // Returns the next entry in lex order
+    DBEntry *UpperBound(const DBEntry *key) const;
+
+    DBEntry *GetFirst() const;
+    // Returns the entry following an entry present in the tree
+    DBEntry *GetNext(const DBEntry *entry) const;
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+private:
+    DBEntryBTreeLeaf *FindLeaf(const DBEntry *key) const;
+    void SplitLeaf(DBEntryBTreeLeaf *leaf);
+    void InsertChild(DBEntryBTreeNode *node, DBEntryBTreeNode *child,
+                     const DBEntry *min);
+    void RemoveNode(DBEntryBTreeNode *node);
+    void MergeLeaf(DBEntryBTreeLeaf *leaf);
+    void UpdateMin(DBEntryBTreeNode *node, const DBEntry *min);
+    void DeleteTree(DBEntryBTreeNode *node);
+
+    DBEntryBTreeNode *root_;
+    DBEntryBTreeLeaf *head_;
+    size_t count_;
+
+    DISALLOW_COPY_AND_ASSIGN(DBEntryBTree);
+};
+
+#endif
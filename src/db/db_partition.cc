@@ -4,12 +4,14 @@
 
 #include "db/db_partition.h"
 
+#include <assert.h>
 #include <list>
 #include <tbb/atomic.h>
 #include <tbb/concurrent_queue.h>
 #include <tbb/mutex.h>
 
 #include "base/task.h"
+#include "base/util.h"
 #include "db/db.h"
 #include "db/db_client.h"
 #include "db/db_entry.h"
@@ -20,12 +22,33 @@ using tbb::atomic;
 struct RequestQueueEntry {
     // Constructor takes ownership of DBRequest key, data.
     RequestQueueEntry(DBTablePartBase *tpart, DBClient *client, DBRequest *req)
-        : tpart(tpart), client(client) {
+        : tpart(tpart), client(client), next(0) {
         request.Swap(req);
     }
+    // Constructor takes ownership of the requests in the batch.
+    RequestQueueEntry(DBTablePartBase *tpart, DBClient *client,
+                      DBTableBase::RequestList *req_list)
+        : tpart(tpart), client(client), next(0) {
+        batch.swap(*req_list);
+    }
+    ~RequestQueueEntry() {
+        STLDeleteValues(&batch);
+    }
+
+    size_t size() const { return batch.empty() ? 1 : batch.size(); }
+
+    // Returns the next request to be processed, NULL when all are done.
+    DBRequest *NextRequest() {
+        if (batch.empty())
+            return (next++ == 0) ? &request : NULL;
+        return (next < batch.size()) ? batch[next++] : NULL;
+    }
+
     DBTablePartBase *tpart;
     DBClient *client;
     DBRequest request;
+    DBTableBase::RequestList batch;
+    size_t next;
 };
 
 struct RemoveQueueEntry {
@@ -46,6 +69,7 @@ public:
     explicit WorkQueue(DBPartition *partition, int partition_id)
         : db_partition_(partition),
           db_partition_id_(partition_id),
+          pending_request_(NULL),
           disable_(false),
           running_(false) {
         request_count_ = 0;
@@ -60,27 +84,42 @@ public:
             delete req_entry;
         }
         request_queue_.clear();
+        delete pending_request_;
     }
 
     bool EnqueueRequest(RequestQueueEntry *req_entry) {
+        long size = req_entry->size();
         request_queue_.push(req_entry);
         MaybeStartRunner();
-        uint32_t max = request_count_.fetch_and_increment();
+        uint32_t max = request_count_.fetch_and_add(size) + size - 1;
         if (max > max_request_queue_len_)
             max_request_queue_len_ = max;
-        total_request_count_++;
+        total_request_count_ += size;
         return max < (kThreshold - 1);
 
     }
 
+    // Entry that was partially processed by the previous run of the
+    // QueueRunner is returned ahead of the queue.
     bool DequeueRequest(RequestQueueEntry **req_entry) {
+        if (pending_request_ != NULL) {
+            *req_entry = pending_request_;
+            pending_request_ = NULL;
+            return true;
+        }
         bool success = request_queue_.try_pop(*req_entry);
         if (success) {
-            request_count_.fetch_and_decrement();
+            request_count_.fetch_and_add(
+                -static_cast<long>((*req_entry)->size()));
         }
         return success;
     }
 
+    void set_pending_request(RequestQueueEntry *req_entry) {
+        assert(pending_request_ == NULL);
+        pending_request_ = req_entry;
+    }
+
     void EnqueueRemove(RemoveQueueEntry *rm_entry) {
         remove_queue_.push(rm_entry);
         MaybeStartRunner();
@@ -120,7 +159,8 @@ public:
     int db_task_id() const { return db_partition_->task_id(); }
 
     bool IsDBQueueEmpty() const {
-        return (request_queue_.empty() && change_list_.empty());
+        return (request_queue_.empty() && pending_request_ == NULL &&
+                change_list_.empty());
     }
 
     bool disable() { return disable_; }
@@ -141,6 +181,7 @@ public:
 private:
     DBPartition *db_partition_;
     RequestQueue request_queue_;
+    RequestQueueEntry *pending_request_;
     TablePartList change_list_;
     atomic<long> request_count_;
     uint64_t total_request_count_;
@@ -205,11 +246,16 @@ public:
 
         RequestQueueEntry *req_entry = NULL;
         while (queue_->DequeueRequest(&req_entry)) {
-            req_entry->tpart->Process(req_entry->client, &req_entry->request);
-            delete req_entry;
-            if (++count == kMaxIterations) {
-                return false;
+            DBRequest *req;
+            while ((req = req_entry->NextRequest()) != NULL) {
+                req_entry->tpart->Process(req_entry->client, req);
+                if (++count == kMaxIterations) {
+                    // Rest of a batch is processed in the next run.
+                    queue_->set_pending_request(req_entry);
+                    return false;
+                }
             }
+            delete req_entry;
         }
 
         while (true) {
@@ -253,7 +299,8 @@ void DBPartition::WorkQueue::MaybeStartRunner() {
 
 bool DBPartition::WorkQueue::RunnerDone() {
     tbb::mutex::scoped_lock lock(mutex_);
-    if (disable_ || (request_queue_.empty() && remove_queue_.empty())) {
+    if (disable_ || (request_queue_.empty() && pending_request_ == NULL &&
+                     remove_queue_.empty())) {
         running_ = false;
         return true;
     }
@@ -277,6 +324,12 @@ bool DBPartition::EnqueueRequest(DBTablePartBase *tpart, DBClient *client,
     return work_queue_->EnqueueRequest(entry);
 }
 
+bool DBPartition::EnqueueRequest(DBTablePartBase *tpart, DBClient *client,
+                                 DBTableBase::RequestList *req_list) {
+    RequestQueueEntry *entry = new RequestQueueEntry(tpart, client, req_list);
+    return work_queue_->EnqueueRequest(entry);
+}
+
 void DBPartition::EnqueueRemove(DBTablePartBase *tpart, DBEntryBase *db_entry) {
     RemoveQueueEntry *entry = new RemoveQueueEntry(tpart, db_entry);
     db_entry->SetOnRemoveQ();
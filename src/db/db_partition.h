@@ -28,6 +28,10 @@ public:
     // Returns false if the client should stop enqueuing updates.
     bool EnqueueRequest(DBTablePartBase *tpart, DBClient *client,
                         DBRequest *req);
+    // Enqueue a batch of requests for a table partition as a single entry.
+    // Takes ownership of the requests and clears the list.
+    bool EnqueueRequest(DBTablePartBase *tpart, DBClient *client,
+                        DBTableBase::RequestList *req_list);
 
     void EnqueueRemove(DBTablePartBase *tpart, DBEntryBase *db_entry);
 
@@ -198,6 +198,30 @@ bool DBTableBase::Enqueue(DBRequest *req) {
     return partition->EnqueueRequest(tpart, NULL, req);
 }
 
+bool DBTableBase::Enqueue(RequestList *req_list) {
+    // Group requests by partition, retaining their relative order.
+    std::vector<DBTablePartBase *> tparts(DB::PartitionCount());
+    std::vector<RequestList> batches(DB::PartitionCount());
+    for (RequestList::iterator iter = req_list->begin();
+         iter != req_list->end(); ++iter) {
+        DBTablePartBase *tpart = GetTablePartition((*iter)->key.get());
+        tparts[tpart->index()] = tpart;
+        batches[tpart->index()].push_back(*iter);
+    }
+    enqueue_count_ += req_list->size();
+    req_list->clear();
+
+    bool more = true;
+    for (size_t index = 0; index < batches.size(); ++index) {
+        if (batches[index].empty())
+            continue;
+        DBPartition *partition = db_->GetPartition(index);
+        if (!partition->EnqueueRequest(tparts[index], NULL, &batches[index]))
+            more = false;
+    }
+    return more;
+}
+
 void DBTableBase::EnqueueRemove(DBEntryBase *db_entry) {
     DBTablePartBase *tpart = GetTablePartition(db_entry);
     DBPartition *partition = db_->GetPartition(tpart->index());
@@ -60,6 +60,7 @@ class DBTableBase {
 public:
     typedef boost::function<void(DBTablePartBase *, DBEntryBase *)> ChangeCallback;
     typedef int ListenerId;
+    typedef std::vector<DBRequest *> RequestList;
 
     static const int kInvalidId = -1;
 
@@ -68,6 +69,11 @@ public:
 
     // Enqueue a request to the table. Takes ownership of the data.
     bool Enqueue(DBRequest *req);
+    // Enqueue a batch of requests to the table. Requests are grouped by
+    // partition and each partition gets a single entry in its queue, with
+    // one wakeup. Takes ownership of the requests and clears the list.
+    // Returns false if any of the partitions is backed up.
+    bool Enqueue(RequestList *req_list);
     void EnqueueRemove(DBEntryBase *db_entry);
 
     // Determine the table partition depending on the record key.
@@ -180,6 +186,12 @@ public:
 
     static const int kIterationToYield = 256;
 
+    // Data-store used for entries in the table partitions
+    enum PartitionStorage {
+        RBTREE_STORAGE,
+        BTREE_STORAGE
+    };
+
     DBTable(DB *db, const std::string &name);
     virtual ~DBTable();
     void Init();
@@ -202,6 +214,13 @@ public:
     // Override if *really* necessary
     virtual DBTablePartition *AllocPartition(int index);
 
+    // Data-store for entries in DBTablePartition. The red-black tree is good
+    // for most cases. DBEntryBTree packs entries densely and is faster to
+    // walk and search in tables with millions of entries.
+    virtual PartitionStorage partition_storage() const {
+        return RBTREE_STORAGE;
+    }
+
     // Input processing implemented by derived class. Default
     // implementation takes care of Add/Delete/Change.
     // Override if *really* necessary
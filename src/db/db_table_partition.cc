@@ -84,7 +84,8 @@ void DBTablePartBase::Delete(DBEntryBase *entry) {
 }
 
 DBTablePartition::DBTablePartition(DBTable *table, int index)
-    : DBTablePartBase(table, index) {
+    : DBTablePartBase(table, index),
+      use_btree_(table->partition_storage() == DBTable::BTREE_STORAGE) {
 }
 
 void DBTablePartition::Process(DBClient *client, DBRequest *req) {
@@ -95,8 +96,13 @@ void DBTablePartition::Process(DBClient *client, DBRequest *req) {
 
 void DBTablePartition::Add(DBEntry *entry) {
     tbb::mutex::scoped_lock lock(mutex_);
-    std::pair<Tree::iterator, bool> ret = tree_.insert(*entry);
-    assert(ret.second);
+    if (use_btree_) {
+        bool success = btree_.Insert(entry);
+        assert(success);
+    } else {
+        std::pair<Tree::iterator, bool> ret = tree_.insert(*entry);
+        assert(ret.second);
+    }
     entry->set_table_partition(static_cast<DBTablePartBase *>(this));
     Notify(entry);
     parent()->AddRemoveCallback(entry, true);
@@ -112,7 +118,7 @@ void DBTablePartition::Remove(DBEntryBase *db_entry) {
     DBEntry *entry = static_cast<DBEntry *>(db_entry);
     parent()->AddRemoveCallback(entry, false);
 
-    bool success = tree_.erase(*entry);
+    bool success = use_btree_ ? btree_.Remove(entry) : tree_.erase(*entry);
     if (!success) {
         LOG(FATAL, "ABORT: DB node erase failed for table " + parent()->name());
         LOG(FATAL, "Invalid node " + db_entry->ToString());
@@ -122,11 +128,13 @@ void DBTablePartition::Remove(DBEntryBase *db_entry) {
 
     // If a table is marked for deletion, then we may trigger the deletion
     // process when the last prefix is deleted
-    if (tree_.empty())
+    if (size() == 0)
         table()->RetryDelete();
 }
 
 DBEntry *DBTablePartition::FindInternal(const DBEntry *entry) {
+    if (use_btree_)
+        return btree_.Find(entry);
     Tree::iterator loc = tree_.find(*entry);
     if (loc != tree_.end()) {
         return loc.operator->();
@@ -135,6 +143,8 @@ DBEntry *DBTablePartition::FindInternal(const DBEntry *entry) {
 }
 
 const DBEntry *DBTablePartition::FindInternal(const DBEntry *entry) const {
+    if (use_btree_)
+        return btree_.Find(entry);
     Tree::const_iterator loc = tree_.find(*entry);
     if (loc != tree_.end()) {
         return loc.operator->();
@@ -177,6 +187,8 @@ DBEntry *DBTablePartition::FindNext(const DBRequestKey *key) {
     tbb::mutex::scoped_lock lock(mutex_);
     DBTable *table = static_cast<DBTable *>(parent());
     std::auto_ptr<DBEntry> entry_ptr = table->AllocEntry(key);
+    if (use_btree_)
+        return btree_.UpperBound(entry_ptr.get());
 
     Tree::iterator loc = tree_.upper_bound(*(entry_ptr.get()));
     if (loc != tree_.end()) {
@@ -189,6 +201,8 @@ DBEntry *DBTablePartition::FindNext(const DBRequestKey *key) {
 DBEntry *DBTablePartition::lower_bound(const DBEntryBase *key) {
     const DBEntry *entry = static_cast<const DBEntry *>(key);
     tbb::mutex::scoped_lock lock(mutex_);
+    if (use_btree_)
+        return btree_.LowerBound(entry);
 
     Tree::iterator it = tree_.lower_bound(*entry);
     if (it != tree_.end()) {
@@ -199,6 +213,8 @@ DBEntry *DBTablePartition::lower_bound(const DBEntryBase *key) {
 
 DBEntry *DBTablePartition::GetFirst() {
     tbb::mutex::scoped_lock lock(mutex_);
+    if (use_btree_)
+        return btree_.GetFirst();
     Tree::iterator it = tree_.begin();
     if (it == tree_.end()) {
         return NULL;
@@ -210,6 +226,8 @@ DBEntry *DBTablePartition::GetFirst() {
 DBEntry *DBTablePartition::GetNext(const DBEntryBase *key) {
     const DBEntry *entry = static_cast<const DBEntry *>(key);
     tbb::mutex::scoped_lock lock(mutex_);
+    if (use_btree_)
+        return btree_.GetNext(entry);
 
     Tree::const_iterator it = tree_.iterator_to(*entry);
     it++;
@@ -219,6 +237,10 @@ DBEntry *DBTablePartition::GetNext(const DBEntryBase *key) {
     return NULL;
 }
 
+size_t DBTablePartition::size() const {
+    return use_btree_ ? btree_.size() : tree_.size();
+}
+
 DBTable *DBTablePartition::table() {
     return static_cast<DBTable *>(parent());
 }
@@ -10,6 +10,7 @@
 #include <tbb/mutex.h>
 
 #include "db/db_entry.h"
+#include "db/db_entry_btree.h"
 
 class DBTableBase;
 class DBTable;
@@ -111,14 +112,19 @@ public:
     DBEntry *FindNext(const DBRequestKey *key);
 
     DBTable *table();
-    size_t size() const { return tree_.size(); }
+    size_t size() const;
+    bool use_btree() const { return use_btree_; }
 
 private:
     DBEntry *FindInternal(const DBEntry *entry);
     const DBEntry *FindInternal(const DBEntry *entry) const;
 
     mutable tbb::mutex mutex_;
+    // Entries are in either tree_ or btree_ based on partition_storage() of
+    // the table
+    const bool use_btree_;
     Tree tree_;
+    DBEntryBTree btree_;
     DISALLOW_COPY_AND_ASSIGN(DBTablePartition);
 };
 
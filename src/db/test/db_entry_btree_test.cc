@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2017 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "db/db_entry_btree.h"
+
+#include <stdlib.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "db/db_entry.h"
+#include "testing/gunit.h"
+
+class TestEntry : public DBEntry {
+public:
+    explicit TestEntry(int key) : key_(key) { }
+
+    virtual bool IsLess(const DBEntry &rhs) const {
+        return key_ < static_cast<const TestEntry &>(rhs).key_;
+    }
+    virtual void SetKey(const DBRequestKey *key) { }
+    virtual std::string ToString() const { return "TestEntry"; }
+    virtual KeyPtr GetDBRequestKey() const { return KeyPtr(); }
+
+    int key() const { return key_; }
+
+private:
+    int key_;
+};
+
+class DBEntryBTreeTest : public ::testing::Test {
+protected:
+    virtual void TearDown() {
+        for (size_t i = 0; i < entries_.size(); i++) {
+            delete entries_[i];
+        }
+    }
+
+    TestEntry *Alloc(int key) {
+        TestEntry *entry = new TestEntry(key);
+        entries_.push_back(entry);
+        return entry;
+    }
+
+    static int Key(const DBEntry *entry) {
+        return entry ? static_cast<const TestEntry *>(entry)->key() : -1;
+    }
+
+    // Verify the tree against the expected set of keys
+    void Verify(const DBEntryBTree &tree, const std::set<int> &keys) {
+        EXPECT_EQ(keys.size(), tree.size());
+        const DBEntry *entry = tree.GetFirst();
+        for (std::set<int>::const_iterator it = keys.begin();
+             it != keys.end(); ++it) {
+            ASSERT_TRUE(entry != NULL);
+            ASSERT_EQ(*it, Key(entry));
+            entry = tree.GetNext(entry);
+        }
+        EXPECT_TRUE(entry == NULL);
+    }
+
+    std::vector<TestEntry *> entries_;
+};
+
+TEST_F(DBEntryBTreeTest, Basic) {
+    DBEntryBTree tree;
+    TestEntry key(5);
+    EXPECT_TRUE(tree.empty());
+    EXPECT_TRUE(tree.GetFirst() == NULL);
+    EXPECT_TRUE(tree.Find(&key) == NULL);
+    EXPECT_TRUE(tree.LowerBound(&key) == NULL);
+
+    EXPECT_TRUE(tree.Insert(Alloc(10)));
+    EXPECT_TRUE(tree.Insert(Alloc(0)));
+    EXPECT_TRUE(tree.Insert(Alloc(5)));
+    EXPECT_FALSE(tree.Insert(Alloc(5)));
+    EXPECT_EQ(3U, tree.size());
+
+    EXPECT_EQ(5, Key(tree.Find(&key)));
+    EXPECT_EQ(5, Key(tree.LowerBound(&key)));
+    EXPECT_EQ(10, Key(tree.UpperBound(&key)));
+    TestEntry key2(7);
+    EXPECT_TRUE(tree.Find(&key2) == NULL);
+    EXPECT_EQ(10, Key(tree.LowerBound(&key2)));
+    TestEntry key3(11);
+    EXPECT_TRUE(tree.LowerBound(&key3) == NULL);
+
+    // Duplicate that was not inserted cannot be removed
+    EXPECT_FALSE(tree.Remove(entries_[3]));
+    EXPECT_TRUE(tree.Remove(entries_[2]));
+    EXPECT_FALSE(tree.Remove(entries_[2]));
+    EXPECT_TRUE(tree.Find(&key) == NULL);
+    EXPECT_TRUE(tree.Remove(entries_[0]));
+    EXPECT_TRUE(tree.Remove(entries_[1]));
+    EXPECT_TRUE(tree.empty());
+    EXPECT_TRUE(tree.GetFirst() == NULL);
+}
+
+// Sequential insert and remove from either end
+TEST_F(DBEntryBTreeTest, Sequential) {
+    DBEntryBTree tree;
+    std::set<int> keys;
+    const int count = DBEntryBTree::kLeafSize * DBEntryBTree::kInnerSize * 3;
+    for (int i = 0; i < count; i++) {
+        EXPECT_TRUE(tree.Insert(Alloc(i)));
+        keys.insert(i);
+    }
+    Verify(tree, keys);
+
+    for (int i = 0; i < count / 2; i++) {
+        EXPECT_TRUE(tree.Remove(entries_[i]));
+        EXPECT_TRUE(tree.Remove(entries_[count - i - 1]));
+        keys.erase(i);
+        keys.erase(count - i - 1);
+        if ((i % 1000) == 0)
+            Verify(tree, keys);
+    }
+    EXPECT_TRUE(tree.empty());
+}
+
+// Compare against std::set with random insert, remove and lookups
+TEST_F(DBEntryBTreeTest, Random) {
+    srand(1);
+    DBEntryBTree tree;
+    std::set<int> keys;
+    std::vector<TestEntry *> present;
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < 20000; i++) {
+            TestEntry *entry = Alloc(rand() % 50000);
+            bool expected = keys.insert(entry->key()).second;
+            EXPECT_EQ(expected, tree.Insert(entry));
+            if (expected)
+                present.push_back(entry);
+        }
+        Verify(tree, keys);
+
+        for (int i = 0; i < 1000; i++) {
+            TestEntry key(rand() % 50000);
+            std::set<int>::iterator it = keys.lower_bound(key.key());
+            EXPECT_EQ(it == keys.end() ? -1 : *it, Key(tree.LowerBound(&key)));
+            it = keys.upper_bound(key.key());
+            EXPECT_EQ(it == keys.end() ? -1 : *it, Key(tree.UpperBound(&key)));
+            bool found = keys.find(key.key()) != keys.end();
+            EXPECT_EQ(found ? key.key() : -1, Key(tree.Find(&key)));
+        }
+
+        // Remove most of the entries to make leaves sparse
+        size_t remove = (round == 3) ? present.size() : present.size() * 3 / 4;
+        for (size_t i = 0; i < remove; i++) {
+            size_t index = rand() % present.size();
+            TestEntry *entry = present[index];
+            present[index] = present.back();
+            present.pop_back();
+            EXPECT_TRUE(tree.Remove(entry));
+            keys.erase(entry->key());
+        }
+        Verify(tree, keys);
+    }
+    EXPECT_TRUE(tree.empty());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -149,6 +149,26 @@ public:
     DISALLOW_COPY_AND_ASSIGN(VlanTable);
 };
 
+// VlanTable with entries kept in B+ tree storage
+class BTreeVlanTable : public VlanTable {
+public:
+    BTreeVlanTable(DB *db) : VlanTable(db) {
+    }
+
+    virtual PartitionStorage partition_storage() const {
+        return BTREE_STORAGE;
+    }
+
+    static DBTableBase *CreateTable(DB *db, const std::string &name) {
+        BTreeVlanTable *table = new BTreeVlanTable(db);
+        table->Init();
+        return table;
+    }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(BTreeVlanTable);
+};
+
 #include "db_test_cmn.h"
 
 // To Test:
@@ -244,6 +264,48 @@ TEST_F(DBTest, SkipDelete) {
     itbl->Unregister(tid_);
 }
 
+// Requests enqueued as a batch are processed in order within a partition
+TEST_F(DBTest, BatchEnqueue) {
+    const int num_entries = 1024;
+
+    tid_ = itbl->Register(boost::bind(&DBTest::DBTestListener, this, _1, _2));
+    adc_notification = 0;
+    del_notification = 0;
+
+    DBTableBase::RequestList req_list;
+    for (int idx = 0; idx < num_entries; ++idx) {
+        DBRequest *addReq = new DBRequest(DBRequest::DB_ENTRY_ADD_CHANGE);
+        addReq->key.reset(new VlanTableReqKey(idx));
+        addReq->data.reset(new VlanTableReqData("DB Test Vlan"));
+        req_list.push_back(addReq);
+    }
+
+    // Delete of the last entry follows its add in the same batch
+    DBRequest *delReq = new DBRequest(DBRequest::DB_ENTRY_DELETE);
+    delReq->key.reset(new VlanTableReqKey(num_entries - 1));
+    req_list.push_back(delReq);
+
+    itbl->Enqueue(&req_list);
+    EXPECT_TRUE(req_list.empty());
+    TASK_UTIL_EXPECT_EQ(num_entries - 1, itbl->Size());
+    task_util::WaitForIdle();
+    EXPECT_EQ(num_entries + 1, itbl->enqueue_count());
+
+    // Delete all entries
+    for (int idx = 0; idx < num_entries - 1; ++idx) {
+        DBRequest *req = new DBRequest(DBRequest::DB_ENTRY_DELETE);
+        req->key.reset(new VlanTableReqKey(idx));
+        req_list.push_back(req);
+    }
+    itbl->Enqueue(&req_list);
+    TASK_UTIL_EXPECT_EQ(0, itbl->Size());
+    task_util::WaitForIdle();
+
+    itbl->Unregister(tid_);
+    adc_notification = 0;
+    del_notification = 0;
+}
+
 // Find routine tests
 TEST_F(DBTest, Find) {
     // Create a VLAN
@@ -275,7 +337,106 @@ TEST_F(DBTest, Find) {
     del_notification = 0;
 }
 
+// Add, delete, walk and GetNext on a table with B+ tree storage. Enough
+// entries are added to have multiple leaves in every partition
+TEST_F(DBTest, BTreeStorage) {
+    const int num_entries = 4096;
+    VlanTable *btbl =
+        static_cast<VlanTable *>(db_.CreateTable("db.test.btree.0"));
+    EXPECT_EQ(DBTable::BTREE_STORAGE, btbl->partition_storage());
+    tid_ = btbl->Register(boost::bind(&DBTest::DBTestListener, this, _1, _2));
+    adc_notification = 0;
+    del_notification = 0;
+
+    // Add entries in reverse order
+    for (int idx = num_entries - 1; idx >= 0; --idx) {
+        DBRequest addReq;
+        addReq.key.reset(new VlanTableReqKey(idx));
+        addReq.data.reset(new VlanTableReqData("DB Test Vlan"));
+        addReq.oper = DBRequest::DB_ENTRY_ADD_CHANGE;
+        btbl->Enqueue(&addReq);
+    }
+    TASK_UTIL_EXPECT_EQ(num_entries, adc_notification);
+    EXPECT_EQ(num_entries, (int)btbl->Size());
+
+    // Entries in every partition are visited in key order
+    {
+        ConcurrencyScope scope("db::DBTable");
+        int count = 0;
+        for (int i = 0; i < btbl->PartitionCount(); i++) {
+            DBTablePartBase *part = btbl->GetTablePartition(i);
+            int prev = -1;
+            for (DBEntryBase *entry = part->GetFirst(); entry != NULL;
+                 entry = part->GetNext(entry)) {
+                int tag = static_cast<Vlan *>(entry)->getTag();
+                EXPECT_LT(prev, tag);
+                prev = tag;
+                count++;
+            }
+        }
+        EXPECT_EQ(num_entries, count);
+
+        VlanTableReqKey key(num_entries / 2);
+        EXPECT_TRUE(btbl->Find(&key) != NULL);
+        VlanTableReqKey key1(num_entries);
+        EXPECT_TRUE(btbl->Find(&key1) == NULL);
+    }
+
+    // Walk the table
+    walk_done_ = false;
+    walk_count_ = 0;
+    DBTable::DBTableWalkRef walk_ref = btbl->AllocWalker(
+                              boost::bind(&DBTest::TableWalk, this, _1, _2),
+                              boost::bind(&DBTest::TWalkDone, this, _1, _2));
+    btbl->WalkTable(walk_ref);
+    TASK_UTIL_EXPECT_TRUE(walk_done_);
+    EXPECT_EQ(num_entries, walk_count_);
+
+    // Delete odd entries and walk again
+    for (int idx = 1; idx < num_entries; idx += 2) {
+        DBRequest delReq;
+        delReq.key.reset(new VlanTableReqKey(idx));
+        delReq.oper = DBRequest::DB_ENTRY_DELETE;
+        btbl->Enqueue(&delReq);
+    }
+    TASK_UTIL_EXPECT_EQ(num_entries / 2, del_notification);
+    TASK_UTIL_EXPECT_EQ(num_entries / 2, (int)btbl->Size());
+
+    walk_done_ = false;
+    walk_count_ = 0;
+    btbl->WalkAgain(walk_ref);
+    TASK_UTIL_EXPECT_TRUE(walk_done_);
+    EXPECT_EQ(num_entries / 2, walk_count_);
+    btbl->ReleaseWalker(walk_ref);
+
+    {
+        ConcurrencyScope scope("db::DBTable");
+        for (int i = 0; i < btbl->PartitionCount(); i++) {
+            DBTablePartBase *part = btbl->GetTablePartition(i);
+            for (DBEntryBase *entry = part->GetFirst(); entry != NULL;
+                 entry = part->GetNext(entry)) {
+                EXPECT_EQ(0, static_cast<Vlan *>(entry)->getTag() % 2);
+            }
+        }
+    }
+
+    // Delete remaining entries
+    for (int idx = 0; idx < num_entries; idx += 2) {
+        DBRequest delReq;
+        delReq.key.reset(new VlanTableReqKey(idx));
+        delReq.oper = DBRequest::DB_ENTRY_DELETE;
+        btbl->Enqueue(&delReq);
+    }
+    TASK_UTIL_EXPECT_EQ(0, (int)btbl->Size());
+    task_util::WaitForIdle();
+
+    btbl->Unregister(tid_);
+    adc_notification = 0;
+    del_notification = 0;
+}
+
 void RegisterFactory() {
+    DB::RegisterFactory("db.test.btree.0", &BTreeVlanTable::CreateTable);
     DB::RegisterFactory("db.test.vlan.0", &VlanTable::CreateTable);
     DB::RegisterFactory("db.test.vlan.1", &VlanTable::CreateTable);
 }
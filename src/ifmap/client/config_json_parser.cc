@@ -335,20 +335,34 @@ void ConfigJsonParser::InsertRequestIntoQ(IFMapOrigin::Origin origin,
 }
 
 void ConfigJsonParser::EnqueueListToTables(RequestList *req_list) const {
-    while (!req_list->empty()) {
-        auto_ptr<DBRequest> req(req_list->front());
-        req_list->pop_front();
+    // All the requests of a document are for the same table, so the table
+    // is looked up only when the type changes and the requests for a table
+    // are handed to it as a single batch.
+    IFMapTable *table = NULL;
+    string id_type;
+    RequestList batch;
+    for (RequestList::iterator iter = req_list->begin();
+         iter != req_list->end(); ++iter) {
+        auto_ptr<DBRequest> req(*iter);
         IFMapTable::RequestKey *key =
             static_cast<IFMapTable::RequestKey *>(req->key.get());
 
-        IFMapTable *table = IFMapTable::FindTable(ifmap_server_->database(),
-                                                  key->id_type);
+        if ((table == NULL) || (id_type != key->id_type)) {
+            if (table != NULL)
+                table->Enqueue(&batch);
+            table = IFMapTable::FindTable(ifmap_server_->database(),
+                                          key->id_type);
+            id_type = key->id_type;
+        }
         if (table != NULL) {
-            table->Enqueue(req.get());
+            batch.push_back(req.release());
         } else {
             IFMAP_TRACE(IFMapTblNotFoundTrace, "Cant find table", key->id_type);
         }
     }
+    if (table != NULL)
+        table->Enqueue(&batch);
+    req_list->clear();
 }
 
 bool ConfigJsonParser::Receive(const ConfigCass2JsonAdapter &adapter,
@@ -5,9 +5,8 @@
 #ifndef ctrlplane_config_json_parser_h
 #define ctrlplane_config_json_parser_h
 
-#include <list>
-#include <map>
 #include <string>
+#include <vector>
 
 #include "config-client-mgr/config_json_parser_base.h"
 
@@ -20,6 +19,7 @@
 #include "ifmap/ifmap_server.h"
 
 #include <boost/function.hpp>
+#include <boost/unordered_map.hpp>
 
 struct AutogenProperty;
 class ConfigCass2JsonAdapter;
@@ -29,8 +29,8 @@ public:
     typedef boost::function<
         bool(const contrail_rapidjson::Value &, std::auto_ptr<AutogenProperty > *)
     > MetadataParseFn;
-    typedef std::map<std::string, MetadataParseFn> MetadataParseMap;
-    typedef std::list<struct DBRequest *> RequestList;
+    typedef boost::unordered_map<std::string, MetadataParseFn> MetadataParseMap;
+    typedef std::vector<struct DBRequest *> RequestList;
 
     ConfigJsonParser();
     ~ConfigJsonParser();
@@ -40,6 +40,10 @@ public:
 
     void MetadataRegister(const std::string &metadata, MetadataParseFn parser);
     void MetadataClear(const std::string &module);
+    // Parse the document in adapter and enqueue the resulting requests to
+    // the IFMap tables. The parser is not modified once the metadata is
+    // registered, so documents can be received concurrently from multiple
+    // tasks.
     virtual bool Receive(const ConfigCass2JsonAdapter &adapter,
                  bool add_change);
     void ifmap_server_set(IFMapServer *ifmap_server) {
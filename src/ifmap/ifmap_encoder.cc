@@ -4,7 +4,6 @@
 
 #include "ifmap/ifmap_encoder.h"
 
-#include <sstream>
 #include "ifmap/ifmap_link.h"
 #include "ifmap/ifmap_object.h"
 #include "ifmap/ifmap_update.h"
@@ -12,88 +11,148 @@
 using namespace pugi;
 using namespace std;
 
-IFMapMessage::IFMapMessage() : op_type_(NONE), node_count_(0),
-    objects_per_message_(kObjectsPerMessage) {
-    // init empty document
-    Open();
+namespace {
+class StringWriter : public xml_writer {
+public:
+    explicit StringWriter(string *str) : str_(str) { }
+    virtual void write(const void *data, size_t size) {
+        str_->append(static_cast<const char *>(data), size);
+    }
+
+private:
+    string *str_;
+};
+
+void AppendEscaped(const string &value, string *str) {
+    for (string::const_iterator it = value.begin(); it != value.end(); ++it) {
+        switch (*it) {
+        case '&': *str += "&amp;"; break;
+        case '<': *str += "&lt;"; break;
+        case '>': *str += "&gt;"; break;
+        case '"': *str += "&quot;"; break;
+        default: *str += *it; break;
+        }
+    }
+}
+}
+
+const char *IFMapMessage::OpName(Op op) {
+    return (op == UPDATE) ? "update" : "delete";
 }
 
-void IFMapMessage::Open() {
-    xml_node iq = doc_.append_child("iq");
-    // set iq (type, from, to) attributes
-    iq.append_attribute("type") = "set";
-    iq.append_attribute("from") = "network-control@contrailsystems.com";
-    iq.append_attribute("to") = "";
-    config_ = iq.append_child("config");
+IFMapMessage::IFMapMessage() : op_type_(NONE), node_count_(0),
+    objects_per_message_(kObjectsPerMessage) {
 }
 
 void IFMapMessage::Close() {
-    ostringstream oss;
-    doc_.save(oss);
-    str_ = oss.str();
+    str_.clear();
+    str_.reserve(body_.size() + receiver_.size() + 160);
+    str_ += "<?xml version=\"1.0\"?>\n";
+    str_ += "<iq type=\"set\" from=\"network-control@contrailsystems.com\"";
+    str_ += " to=\"";
+    AppendEscaped(receiver_, &str_);
+    str_ += "\"><config>";
+    str_ += body_;
+    if (op_type_ != NONE) {
+        str_ += "</";
+        str_ += OpName(op_type_);
+        str_ += ">";
+    }
+    str_ += "</config></iq>\n";
 }
 
 void IFMapMessage::SetReceiverInMsg(const std::string &cli_identifier) {
-    xml_node iq = doc_.child("iq");
-    assert(iq);
-    xml_attribute iqattr = iq.attribute("to");
-    assert(iqattr);
-    std::string str(cli_identifier);
-    str += "/config";
-    iqattr.set_value(str.c_str());
+    receiver_ = cli_identifier;
+    receiver_ += "/config";
 }
 
 void IFMapMessage::SetObjectsPerMessage(int num) {
     objects_per_message_ = num;
 }
 
-void IFMapMessage::EncodeUpdate(const IFMapUpdate *update) {
-    // update is either of type UPDATE OR DELETE
-    if (update->IsUpdate()) {
-        if (op_type_ != UPDATE) {
-            op_node_ = config_.append_child("update");
-            op_type_ = UPDATE;
-        }
-        if (update->data().type == IFMapObjectPtr::NODE) {
-            EncodeNode(update);
-        } else if (update->data().type == IFMapObjectPtr::LINK) {
-            EncodeLink(update);
-        } else {
-            assert(0);
-        }
-    } else {
-        if (op_type_ != DEL) {
-            op_node_ = config_.append_child("delete");
-            op_type_ = DEL;
-        }
-        if (update->data().type == IFMapObjectPtr::NODE) {
-            EncodeNode(update);
-        } else if (update->data().type == IFMapObjectPtr::LINK) {
-            EncodeLink(update);
-        } else {
-            assert(0);
+void IFMapMessage::SetOp(Op op_type) {
+    if (op_type_ != op_type) {
+        if (op_type_ != NONE) {
+            body_ += "</";
+            body_ += OpName(op_type_);
+            body_ += ">";
         }
+        body_ += "<";
+        body_ += OpName(op_type);
+        body_ += ">";
+        op_type_ = op_type;
     }
-    node_count_++;
 }
 
-void IFMapMessage::EncodeNode(const IFMapUpdate *update) {
-    IFMapNode *node = update->data().u.node;
-    if (update->IsUpdate()) {
-        node->EncodeNodeDetail(&op_node_);
+void IFMapMessage::EncodeUpdate(const IFMapUpdate *update,
+                                IFMapNodeState *state) {
+    // update is either of type UPDATE OR DELETE
+    SetOp(update->IsUpdate() ? UPDATE : DEL);
+    if (update->data().type == IFMapObjectPtr::NODE) {
+        EncodeNode(update->data().u.node, update->IsUpdate(), state);
+    } else if (update->data().type == IFMapObjectPtr::LINK) {
+        EncodeLink(update->data().u.link);
     } else {
-        node->EncodeNode(&op_node_);
+        assert(0);
     }
+    node_count_++;
+}
+
+void IFMapMessage::EncodeNodeUpdate(IFMapNode *node, IFMapNodeState *state) {
+    SetOp(UPDATE);
+    EncodeNode(node, true, state);
+    node_count_++;
+}
+
+void IFMapMessage::EncodeLinkUpdate(const IFMapLink *link) {
+    SetOp(UPDATE);
+    EncodeLink(link);
+    node_count_++;
+}
+
+//
+// Save the only child of the scratch document to str and remove it from the
+// document. The pugixml library allocates memory for a document in pages of
+// 32KB. Removing the child, rather than calling reset on the document, lets
+// the library reuse the same pages when encoding the next object.
+//
+void IFMapMessage::SaveFragment(string *str) {
+    StringWriter writer(str);
+    doc_.save(writer, "", format_raw | format_no_declaration);
+    doc_.remove_child(doc_.first_child());
 }
 
-void IFMapMessage::EncodeLink(const IFMapUpdate *update) {
-    xml_node link_node = op_node_.append_child("link");
+void IFMapMessage::EncodeNode(IFMapNode *node, bool detail,
+                              IFMapNodeState *state) {
+    if (!detail) {
+        node->EncodeNode(&doc_);
+        SaveFragment(&body_);
+        return;
+    }
 
-    const IFMapLink *link = update->data().u.link;
+    if (state == NULL) {
+        node->EncodeNodeDetail(&doc_);
+        SaveFragment(&body_);
+        return;
+    }
+    const string *encoded = state->GetEncoded();
+    if (encoded == NULL) {
+        string str;
+        node->EncodeNodeDetail(&doc_);
+        SaveFragment(&str);
+        state->SetEncoded(str);
+        encoded = state->GetEncoded();
+    }
+    body_ += *encoded;
+}
+
+void IFMapMessage::EncodeLink(const IFMapLink *link) {
+    xml_node link_node = doc_.append_child("link");
 
     IFMapNode::EncodeNode(link->left_id(), &link_node);
     IFMapNode::EncodeNode(link->right_id(), &link_node);
     link->EncodeLinkInfo(&link_node);
+    SaveFragment(&body_);
 
     node_count_++;
 }
@@ -108,20 +167,11 @@ bool IFMapMessage::IsEmpty() {
 
 //
 // Reset the IFMapMessage to initial state so that it can be used to build
-// the next config message.
-//
-// Using remove_child to remove the only child of the document is a better
-// way to clear the document than using reset. The pugixml library allocates
-// memory for a document in increments of 32KB pages and then manages smaller
-// allocations (nodes or attributes) using these pages. Calling reset method
-// on a document frees all the pages. In contrast, removing the only child
-// node of the document returns the smaller allocations to the free pool of
-// memory for the document, but doesn't free the pages themselves. This lets
-// the library reuse the same memory when building the tree for each message.
+// the next config message. The strings keep their capacity, so that the
+// buffers are reused for the next message.
 //
 void IFMapMessage::Reset() {
-    doc_.remove_child("iq");
+    body_.clear();
     node_count_ = 0;
     op_type_ = NONE;
-    Open();
 }
@@ -5,12 +5,26 @@
 #ifndef __ctrlplane__ifmap_encoder__
 #define __ctrlplane__ifmap_encoder__
 
+#include <string>
 #include <pugixml/pugixml.hpp>
 
 class IFMapNode;
 class IFMapLink;
+class IFMapNodeState;
 class IFMapUpdate;
 
+//
+// Config message sent to IFMap clients.
+//
+// The message is built as a string of encoded objects that is common to
+// all the receivers. Close wraps it in the iq element addressed to the
+// current receiver, so that the objects are not encoded again for every
+// client. Objects are encoded one at a time in a scratch pugi document.
+//
+// The encoding of a node with its properties is cached in the node state,
+// when one is provided, and reused by messages for any set of clients until
+// the crc of the node changes.
+//
 class IFMapMessage {
 public:
     static const int kObjectsPerMessage = 16;
@@ -20,7 +34,11 @@ public:
     // set the 'to' field in the message
     void SetReceiverInMsg(const std::string &cli_identifier);
     void SetObjectsPerMessage(int num);
-    void EncodeUpdate(const IFMapUpdate *update);
+    void EncodeUpdate(const IFMapUpdate *update, IFMapNodeState *state = NULL);
+    // Encode the current config of a node or a link as an update that is
+    // not in the update queue.
+    void EncodeNodeUpdate(IFMapNode *node, IFMapNodeState *state);
+    void EncodeLinkUpdate(const IFMapLink *link);
     bool IsFull();
     bool IsEmpty();
     void Reset();
@@ -33,14 +51,16 @@ private:
         UPDATE,
         DEL
     };
-    void Open();
-    void EncodeNode(const IFMapUpdate *update);
-    void EncodeLink(const IFMapUpdate *update);
+    static const char *OpName(Op op);
+    void SetOp(Op op_type);
+    void EncodeNode(IFMapNode *node, bool detail, IFMapNodeState *state);
+    void EncodeLink(const IFMapLink *link);
+    void SaveFragment(std::string *str);
 
     pugi::xml_document doc_;
-    pugi::xml_node config_;
-    Op op_type_;             // the current  type of op_node_
-    pugi::xml_node op_node_;
+    Op op_type_;             // the current type of op element in body_
+    std::string receiver_;
+    std::string body_;
     std::string str_;
     int node_count_;
     int objects_per_message_;
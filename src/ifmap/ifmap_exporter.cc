@@ -10,6 +10,7 @@
 #include "db/db.h"
 #include "db/db_table_partition.h"
 #include "ifmap/ifmap_client.h"
+#include "ifmap/ifmap_encoder.h"
 #include "ifmap/ifmap_graph_walker.h"
 #include "ifmap/ifmap_link.h"
 #include "ifmap/ifmap_log.h"
@@ -572,7 +573,7 @@ void IFMapExporter::LinkTableExport(DBTablePartBase *partition,
 
         IFMAP_DEBUG(LinkOper, "LinkRemove", left->ToString(), right->ToString(),
             s_left->interest().ToString(), s_right->interest().ToString());
-        walker_->LinkRemove(interest);
+        walker_->LinkRemove(left, right, interest);
 
         state->RemoveDependency();
         state->ClearValid();
@@ -617,6 +618,10 @@ void IFMapExporter::StateUpdateOnDequeue(IFMapUpdate *update,
 
     if (update->advertise().empty()) {
         state->Remove(update);
+        // Encoded node is not needed once all updates have been sent.
+        if (state->IsNode() && state->update_list().empty()) {
+            static_cast<IFMapNodeState *>(state)->ClearEncoded();
+        }
         if (update->IsDelete()) {
             DeleteStateIfAppropriate(table, db_entry, state);
         }
@@ -660,6 +665,92 @@ bool IFMapExporter::FilterNeighbor(IFMapNode *lnode, IFMapLink *link) {
     return walker_->FilterNeighbor(lnode, link);
 }
 
+static void SnapshotMessageAppend(IFMapMessage *message,
+                                  IFMapUpdateSender::MessageList *messages) {
+    message->Close();
+    messages->push_back(message->get_string());
+    message->Reset();
+}
+
+// The client has just joined the update queue at the tail_marker, so none of
+// the updates in the queue are meant for it yet and the interest graph of the
+// client can be computed in one walk from root. A node goes in the snapshot
+// only if its state reflects the last change of the node that was exported,
+// since the update queue sends every later change. A link goes in the
+// snapshot only after both of its nodes, like in the update queue.
+size_t IFMapExporter::ClientSnapshot(IFMapClient *client, IFMapNode *root) {
+    BitSet bset;
+    bset.set(client->index());
+    vector<IFMapNode *> nodes;
+    walker_->SnapshotWalk(root, bset, &nodes);
+
+    IFMapMessage message;
+    message.SetReceiverInMsg(client->identifier());
+    IFMapUpdateSender::MessageList messages;
+    size_t count = 0;
+
+    for (vector<IFMapNode *>::iterator iter = nodes.begin();
+         iter != nodes.end(); ++iter) {
+        IFMapNode *node = *iter;
+        IFMapNodeState *state = NodeStateLookup(node);
+        if (!IsFeasible(node) || !state->IsValid() ||
+            (state->crc() != node->GetConfigCrc())) {
+            node->table()->Change(node);
+            continue;
+        }
+        message.EncodeNodeUpdate(node, state);
+        StateAdvertisedOr(state, bset);
+        client->incr_update_nodes_sent();
+        count++;
+        if (message.IsFull()) {
+            SnapshotMessageAppend(&message, &messages);
+        }
+    }
+
+    DBGraph *graph = server_->graph();
+    for (vector<IFMapNode *>::iterator iter = nodes.begin();
+         iter != nodes.end(); ++iter) {
+        IFMapNode *node = *iter;
+        for (DBGraphVertex::edge_iterator e_iter = node->edge_list_begin(graph);
+             e_iter != node->edge_list_end(graph); ++e_iter) {
+            IFMapLink *link = static_cast<IFMapLink *>(e_iter.operator->());
+            // Each link is seen from both of its nodes. Both nodes have to be
+            // in the interest graph, so process the link from its left node.
+            if ((link->left() != node) || link->IsDeleted()) {
+                continue;
+            }
+            IFMapNodeState *s_left = NodeStateLookup(link->left());
+            IFMapNodeState *s_right = NodeStateLookup(link->right());
+            if ((s_right == NULL) || !s_right->interest().Contains(bset)) {
+                continue;
+            }
+            IFMapLinkState *state = LinkStateLookup(link);
+            if ((state == NULL) || !state->IsValid() ||
+                !s_left->advertised().Contains(bset) ||
+                !s_right->advertised().Contains(bset)) {
+                link_table_->Change(link);
+                continue;
+            }
+            message.EncodeLinkUpdate(link);
+            StateInterestOr(state, bset);
+            StateAdvertisedOr(state, bset);
+            client->incr_update_links_sent();
+            count++;
+            if (message.IsFull()) {
+                SnapshotMessageAppend(&message, &messages);
+            }
+        }
+    }
+    if (!message.IsEmpty()) {
+        SnapshotMessageAppend(&message, &messages);
+    }
+
+    IFMAP_DEBUG(IFMapClientSnapshot, client->identifier(), nodes.size(),
+                count, messages.size());
+    sender()->SendSnapshot(client->index(), &messages);
+    return count;
+}
+
 bool IFMapExporter::ConfigChanged(IFMapNode *node) {
     IFMapNodeState *state = NodeStateLookup(node);
     bool changed = false;
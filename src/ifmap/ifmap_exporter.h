@@ -68,9 +68,17 @@ public:
 
     DBTable *link_table() { return link_table_; }
     IFMapServer *server() { return server_; }
+    const IFMapGraphWalker *walker() const { return walker_.get(); }
 
     bool FilterNeighbor(IFMapNode *lnode, IFMapLink *link);
 
+    // Initial download of the config of a new client. The config reachable
+    // from root is sent to the client as a snapshot that does not go through
+    // the update queue. Nodes and links whose state is not in sync with the
+    // database are left to the update queue. Returns the number of objects
+    // in the snapshot.
+    size_t ClientSnapshot(IFMapClient *client, IFMapNode *root);
+
     void AddClientConfigTracker(int index);
     void DeleteClientConfigTracker(int index);
     void UpdateClientConfigTracker(IFMapState *state, const BitSet& client_bits,
@@ -4,6 +4,8 @@
 
 #include "ifmap/ifmap_graph_walker.h"
 
+#include <queue>
+
 #include <boost/assign/list_of.hpp>
 #include <boost/bind.hpp>
 
@@ -75,7 +77,9 @@ IFMapGraphWalker::IFMapGraphWalker(DBGraph *graph, IFMapExporter *exporter)
       link_delete_walk_trigger_(new TaskTrigger(
           boost::bind(&IFMapGraphWalker::LinkDeleteWalk, this),
           TaskScheduler::GetInstance()->GetTaskId("db::IFMapTable"), 0)),
-      walk_client_index_(BitSet::npos) {
+      walk_client_index_(BitSet::npos),
+      link_delete_walks_(0),
+      link_delete_walks_skipped_(0) {
     traversal_white_list_.reset(new IFMapTypenameWhiteList());
     AddNodesToWhitelist();
 }
@@ -106,6 +110,23 @@ void IFMapGraphWalker::ProcessLinkAdd(IFMapNode *lnode, IFMapNode *rnode,
                   filter);
 }
 
+void IFMapGraphWalker::SnapshotVertex(DBGraphVertex *vertex,
+                                      const BitSet &bset,
+                                      std::vector<IFMapNode *> *nodes) {
+    IFMapNode *node = static_cast<IFMapNode *>(vertex);
+    IFMapNodeState *state = exporter_->NodeStateLocate(node);
+    exporter_->StateInterestOr(state, bset);
+    nodes->push_back(node);
+}
+
+void IFMapGraphWalker::SnapshotWalk(IFMapNode *root, const BitSet &bset,
+                                    std::vector<IFMapNode *> *nodes) {
+    GraphPropagateFilter filter(exporter_, traversal_white_list_.get(), bset);
+    graph_->Visit(root,
+        boost::bind(&IFMapGraphWalker::SnapshotVertex, this, _1, bset, nodes),
+        0, filter);
+}
+
 void IFMapGraphWalker::LinkAdd(IFMapLink *link, IFMapNode *lnode, const BitSet &lhs,
                                IFMapNode *rnode, const BitSet &rhs) {
     IFMAP_DEBUG(LinkOper, "LinkAdd", lnode->ToString(), rnode->ToString(),
@@ -130,11 +151,99 @@ void IFMapGraphWalker::LinkAdd(IFMapLink *link, IFMapNode *lnode, const BitSet &
     }
 }
 
-void IFMapGraphWalker::LinkRemove(const BitSet &bset) {
-    OrLinkDeleteClients(bset);          // link_delete_clients_ | bset
+// The link has already been removed from the graph. Nodes that were
+// reachable before the delete remain reachable if both nodes of the link are
+// still reachable, in which case the interest of the client does not change.
+// Otherwise, the interest of the client is recomputed by a full walk.
+void IFMapGraphWalker::LinkRemove(IFMapNode *lnode, IFMapNode *rnode,
+                                  const BitSet &bset) {
+    BitSet walk_set;
+    for (size_t i = bset.find_first(); i != BitSet::npos;
+         i = bset.find_next(i)) {
+        if (link_delete_clients_.test(i)) {
+            continue;
+        }
+        IFMapNode *root = ClientRootNode(i);
+        if (root != NULL && IsReachable(root, lnode, i) &&
+            IsReachable(root, rnode, i)) {
+            link_delete_walks_skipped_++;
+            continue;
+        }
+        walk_set.set(i);
+    }
+    if (walk_set.empty()) {
+        return;
+    }
+    OrLinkDeleteClients(walk_set);      // link_delete_clients_ | walk_set
     link_delete_walk_trigger_->Set();
 }
 
+IFMapNode *IFMapGraphWalker::ClientRootNode(int client_index) {
+    IFMapServer *server = exporter_->server();
+    IFMapClient *client = server->GetClient(client_index);
+    if (client == NULL) {
+        return NULL;
+    }
+    IFMapTable *table = IFMapTable::FindTable(server->database(),
+                                              "virtual-router");
+    IFMapNode *node = table->FindNode(client->identifier());
+    if ((node == NULL) || !node->IsVertexValid()) {
+        return NULL;
+    }
+    return node;
+}
+
+// Check if node is reachable from root with the traversal rules. The search
+// follows the edges backwards, from node towards root, and is limited to the
+// nodes that the client is interested in since every node reachable from
+// root has the interest bit set. Gives up after visiting
+// kMaxReachableCheckNodes nodes, in which case node is treated as not
+// reachable.
+bool IFMapGraphWalker::IsReachable(IFMapNode *root, IFMapNode *node,
+                                   int client_index) {
+    if (!node->IsVertexValid() || !traversal_white_list_->VertexFilter(node)) {
+        return false;
+    }
+
+    set<DBGraphVertex *> visited;
+    std::queue<DBGraphVertex *> visit_q;
+    visited.insert(node);
+    visit_q.push(node);
+    while (!visit_q.empty()) {
+        DBGraphVertex *vertex = visit_q.front();
+        visit_q.pop();
+        if (vertex == root) {
+            return true;
+        }
+        for (DBGraphVertex::edge_iterator iter =
+             vertex->edge_list_begin(graph_);
+             iter != vertex->edge_list_end(graph_); ++iter) {
+            IFMapNode *source = static_cast<IFMapNode *>(iter.target());
+            if (visited.find(source) != visited.end()) {
+                continue;
+            }
+            if (!traversal_white_list_->VertexFilter(source) ||
+                !traversal_white_list_->EdgeFilter(source, vertex,
+                                                   iter.operator->())) {
+                continue;
+            }
+            if (source == root) {
+                return true;
+            }
+            IFMapNodeState *state = exporter_->NodeStateLookup(source);
+            if (state == NULL || !state->interest().test(client_index)) {
+                continue;
+            }
+            if (visited.size() == kMaxReachableCheckNodes) {
+                return false;
+            }
+            visited.insert(source);
+            visit_q.push(source);
+        }
+    }
+    return false;
+}
+
 // Check if the neighbor or link to neighbor should be filtered. Returns true
 // if rnode or link to rnode should be filtered.
 bool IFMapGraphWalker::FilterNeighbor(IFMapNode *lnode, IFMapLink *link) {
@@ -177,6 +286,7 @@ bool IFMapGraphWalker::LinkDeleteWalk() {
         IFMapClient *client = server->GetClient(i);
         assert(client);
         AddNewReachableNodesTracker(client->index());
+        link_delete_walks_++;
 
         IFMapTable *table = IFMapTable::FindTable(server->database(),
                                                   "virtual-router");
@@ -34,19 +34,37 @@ public:
     // list.
     void LinkAdd(IFMapLink *link, IFMapNode *lnode, const BitSet &lhs,
                  IFMapNode *rnode, const BitSet &rhs);
-    void LinkRemove(const BitSet &bset);
+    // When a link is removed, the clients in bset for which either node is
+    // no longer reachable are scheduled for a full walk of the graph.
+    void LinkRemove(IFMapNode *lnode, IFMapNode *rnode, const BitSet &bset);
+
+    // Set the interest of the client in bset on all the nodes reachable from
+    // root, and return the nodes in the order of the walk. Unlike LinkAdd,
+    // the nodes are not notified to the exporter.
+    void SnapshotWalk(IFMapNode *root, const BitSet &bset,
+                      std::vector<IFMapNode *> *nodes);
 
     bool FilterNeighbor(IFMapNode *lnode, IFMapLink *link);
     const IFMapTypenameWhiteList &get_traversal_white_list() const;
     void ResetLinkDeleteClients(const BitSet &bset);
 
+    uint64_t link_delete_walks() const { return link_delete_walks_; }
+    uint64_t link_delete_walks_skipped() const {
+        return link_delete_walks_skipped_;
+    }
+
 private:
     static const int kMaxLinkDeleteWalks = 1;
+    static const size_t kMaxReachableCheckNodes = 1024;
 
     void ProcessLinkAdd(IFMapNode *lnode, IFMapNode *rnode, const BitSet &bset);
     void JoinVertex(DBGraphVertex *vertex, const BitSet &bset);
+    void SnapshotVertex(DBGraphVertex *vertex, const BitSet &bset,
+                        std::vector<IFMapNode *> *nodes);
     void NotifyEdge(DBGraphEdge *edge, const BitSet &bset);
     void RecomputeInterest(DBGraphVertex *vertex, int bit);
+    IFMapNode *ClientRootNode(int client_index);
+    bool IsReachable(IFMapNode *root, IFMapNode *node, int client_index);
     void CleanupInterest(int client_index, IFMapNode *node,
                          IFMapNodeState *state);
     void AddNodesToWhitelist();
@@ -67,6 +85,8 @@ private:
     BitSet link_delete_clients_;
     size_t walk_client_index_;
     ReachableNodesTracker new_reachable_nodes_tracker_;
+    uint64_t link_delete_walks_;
+    uint64_t link_delete_walks_skipped_;
 };
 
 #endif /* defined(__ctrlplane__ifmap_graph_walker__) */
@@ -200,7 +200,7 @@ IFMapServer::IFMapServer(DB *db, DBGraph *graph,
           work_queue_(TaskScheduler::GetInstance()->GetTaskId("db::IFMapTable"),
               0, boost::bind(&IFMapServer::ClientWorker, this, _1)),
           io_service_(io_service), config_manager_(NULL),
-          ifmap_channel_manager_(NULL) {
+          ifmap_channel_manager_(NULL), client_snapshot_enable_(false) {
 }
 
 IFMapServer::~IFMapServer() {
@@ -264,7 +264,9 @@ bool IFMapServer::ProcessClientWork(bool add, IFMapClient *client) {
     if (add) {
         ClientRegister(client);
         ClientExporterSetup(client);
-        ClientGraphDownload(client);
+        if (!client_snapshot_enable_ || !ClientGraphSnapshot(client)) {
+            ClientGraphDownload(client);
+        }
     } else {
         RemoveSelfAddedLinksAndObjects(client);
         CleanupUuidMapper(client);
@@ -362,6 +364,21 @@ void IFMapServer::ClientGraphDownload(IFMapClient *client) {
     }
 }
 
+// Send the config of a new client as a snapshot instead of notifying the
+// links of the virtual-router. Returns false if the virtual-router node is
+// not present.
+bool IFMapServer::ClientGraphSnapshot(IFMapClient *client) {
+    IFMapTable *table = IFMapTable::FindTable(db_, "virtual-router");
+    assert(table);
+
+    IFMapNode *node = table->FindNode(client->identifier());
+    if ((node == NULL) || !node->IsVertexValid()) {
+        return false;
+    }
+    exporter_->ClientSnapshot(client, node);
+    return true;
+}
+
 void IFMapServer::ClientExporterSetup(IFMapClient *client) {
     exporter_->AddClientConfigTracker(client->index());
 }
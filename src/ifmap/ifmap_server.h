@@ -97,6 +97,12 @@ public:
     IFMapChannelManager *get_ifmap_channel_manager() {
         return ifmap_channel_manager_;
     }
+    // When enabled, new clients get their initial config as a snapshot
+    // that does not go through the update queue.
+    void set_client_snapshot_enable(bool enable) {
+        client_snapshot_enable_ = enable;
+    }
+    bool client_snapshot_enable() const { return client_snapshot_enable_; }
 
     uint64_t get_config_generation_number() {
         return config_manager_->GetGenerationNumber();
@@ -144,6 +150,7 @@ private:
     };
     bool ClientWorker(QueueEntry work_entry);
     void ClientGraphDownload(IFMapClient *client);
+    bool ClientGraphSnapshot(IFMapClient *client);
     void RemoveSelfAddedLinksAndObjects(IFMapClient *client);
     void CleanupUuidMapper(IFMapClient *client);
     void ClientExporterCleanup(int index);
@@ -165,6 +172,7 @@ private:
     ConfigClientManager *config_manager_;
     IFMapChannelManager *ifmap_channel_manager_;
     ClientHistory client_history_;
+    bool client_snapshot_enable_;
 };
 
 #endif /* defined(__ctrlplane__ifmap_server__) */
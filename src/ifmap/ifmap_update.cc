@@ -124,7 +124,24 @@ IFMapLink *IFMapState::GetIFMapLink() const {
 }
 
 IFMapNodeState::IFMapNodeState(IFMapNode *node)
-    : IFMapState(node) {
+    : IFMapState(node), encoded_crc_(0) {
+}
+
+const std::string *IFMapNodeState::GetEncoded() const {
+    if (encoded_.empty() || encoded_crc_ != crc()) {
+        return NULL;
+    }
+    return &encoded_;
+}
+
+void IFMapNodeState::SetEncoded(const std::string &encoded) {
+    encoded_ = encoded;
+    encoded_crc_ = crc();
+}
+
+void IFMapNodeState::ClearEncoded() {
+    std::string().swap(encoded_);
+    encoded_crc_ = 0;
 }
 
 bool IFMapNodeState::HasDependents() const {
@@ -197,9 +197,17 @@ public:
         return (update_list().empty() && IsInvalid() && !HasDependents());
     }
 
+    // Encoded xml of the node with its properties, shared by the messages
+    // to all clients. It is valid only for the crc at which it was encoded.
+    const std::string *GetEncoded() const;
+    void SetEncoded(const std::string &encoded);
+    void ClearEncoded();
+
 private:
     DEPENDENCY_LIST(IFMapLink, IFMapNodeState, dependents_);
     BitSet nmask_;          // new bitmask computed by graph traversal
+    std::string encoded_;
+    crc32type encoded_crc_;
 };
 
 class IFMapLinkState : public IFMapState {
@@ -87,23 +87,25 @@ void IFMapUpdateQueue::Dequeue(IFMapUpdate *update) {
 }
 
 IFMapMarker *IFMapUpdateQueue::GetMarker(int bit) {
-    MarkerMap::iterator loc = marker_map_.find(bit);
-    if (loc == marker_map_.end()) {
+    if ((size_t) bit >= marker_map_.size()) {
         return NULL;
     }
-    return loc->second;
+    return marker_map_[bit];
 }
 
 void IFMapUpdateQueue::Join(int bit) {
     IFMapMarker *marker = &tail_marker_;
     marker->mask.set(bit);
-    marker_map_.insert(std::make_pair(bit, marker));
+    if ((size_t) bit >= marker_map_.size()) {
+        marker_map_.resize(bit + 1, NULL);
+    }
+    assert(marker_map_[bit] == NULL);
+    marker_map_[bit] = marker;
 }
 
 void IFMapUpdateQueue::Leave(int bit) {
-    MarkerMap::iterator loc = marker_map_.find(bit);
-    assert(loc != marker_map_.end());
-    IFMapMarker *marker = loc->second;
+    IFMapMarker *marker = GetMarker(bit);
+    assert(marker != NULL);
 
     BitSet reset_bs;
     reset_bs.set(bit);
@@ -126,7 +128,7 @@ void IFMapUpdateQueue::Leave(int bit) {
         server_->exporter()->StateUpdateOnDequeue(update, reset_bs, true);
     }
 
-    marker_map_.erase(loc);
+    marker_map_[bit] = NULL;
     marker->mask.reset(bit);
     if ((marker != &tail_marker_)  && (marker->mask.empty())) {
         EraseFromList(marker);
@@ -144,9 +146,8 @@ void IFMapUpdateQueue::MarkerMerge(IFMapMarker *dst, IFMapMarker *src,
     dst->mask |= mmove;
     for (size_t i = mmove.find_first();
          i != BitSet::npos; i = mmove.find_next(i)) {
-        MarkerMap::iterator loc = marker_map_.find(i);
-        assert(loc != marker_map_.end());
-        loc->second = dst;
+        assert(marker_map_[i] != NULL);
+        marker_map_[i] = dst;
     }
     // Reset the bits in the src and get rid of it in case it's now empty.
     src->mask.Reset(mmove);
@@ -161,18 +162,36 @@ IFMapMarker* IFMapUpdateQueue::MarkerSplit(IFMapMarker *marker,
                                            IFMapListEntry *current,
                                            const BitSet &msplit, bool before) {
     assert(!msplit.empty());
+    marker->mask.Reset(msplit);
+    assert(!marker->mask.empty());
+
+    // If there is a marker right where the new one would go, the clients in
+    // msplit are at the same position as the clients of that marker. Merge
+    // them into it rather than inserting an adjacent marker, so that blocked
+    // clients do not fragment the queue into runs of markers that every
+    // subsequent Send has to split and merge again.
+    IFMapListEntry *neighbor = before ? Previous(current) : Next(current);
+    if ((neighbor != NULL) && neighbor->IsMarker() && (neighbor != marker) &&
+        (neighbor != &tail_marker_)) {
+        IFMapMarker *dst = static_cast<IFMapMarker *>(neighbor);
+        dst->mask |= msplit;
+        for (size_t i = msplit.find_first();
+             i != BitSet::npos; i = msplit.find_next(i)) {
+            assert(marker_map_[i] != NULL);
+            marker_map_[i] = dst;
+        }
+        return dst;
+    }
+
     IFMapMarker *new_marker = new IFMapMarker();
 
     // call to operator=()
     new_marker->mask = msplit;
-    marker->mask.Reset(msplit);
-    assert(!marker->mask.empty());
 
     for (size_t i = msplit.find_first();
          i != BitSet::npos; i = msplit.find_next(i)) {
-        MarkerMap::iterator loc = marker_map_.find(i);
-        assert(loc != marker_map_.end());
-        loc->second = new_marker;
+        assert(marker_map_[i] != NULL);
+        marker_map_[i] = new_marker;
     }
     if (before) {
         // Insert new_marker before current
@@ -5,7 +5,7 @@
 #ifndef __ctrlplane__ifmap_update_queue__
 #define __ctrlplane__ifmap_update_queue__
 
-#include <map>
+#include <vector>
 #include "ifmap/ifmap_update.h"
 
 class IFMapServer;
@@ -19,7 +19,9 @@ public:
     > MemberHook;
     typedef boost::intrusive::list<IFMapListEntry, MemberHook> List;
 
-    typedef std::map<int, IFMapMarker *> MarkerMap;
+    // Marker of every client, indexed by the client bit. Entries of
+    // clients that are not in the queue are NULL.
+    typedef std::vector<IFMapMarker *> MarkerMap;
 
     explicit IFMapUpdateQueue(IFMapServer *server);
 
@@ -56,12 +58,16 @@ public:
     void MoveMarkerAfter(IFMapMarker *marker, IFMapListEntry *current);
 
     // Removes a set of members from marker, creates a new marker with this set
-    // and inserts it 'before' current. Returns the new marker.
+    // and inserts it 'before' current. If the element before current is
+    // already a marker, the set is merged into that marker instead. Returns
+    // the marker that holds the set.
     IFMapMarker* MarkerSplitBefore(IFMapMarker *marker, IFMapListEntry *current,
                                    const BitSet &msplit);
 
     // Removes a set of members from marker, creates a new marker with this set
-    // and inserts it 'after' current. Returns the new marker.
+    // and inserts it 'after' current. If the element after current is
+    // already a marker, the set is merged into that marker instead. Returns
+    // the marker that holds the set.
     IFMapMarker *MarkerSplitAfter(IFMapMarker *marker, IFMapListEntry *current,
                                   const BitSet &msplit);
 
@@ -33,12 +33,26 @@ public:
     virtual bool Run() {
         BitSet send_scheduled;
         sender_->GetSendScheduled(&send_scheduled);
-        sender_->send_blocked_.Reset(send_scheduled);
+
+        // The snapshot of a client goes before the updates in the Q. Send
+        // the snapshots of all the scheduled clients before any Send(). A
+        // client with snapshot messages still pending stays blocked, so that
+        // Send() for another client sharing its marker does not give it the
+        // updates in the Q ahead of its snapshot.
+        BitSet send_ready;
         for (size_t i = send_scheduled.find_first(); i != BitSet::npos;
              i = send_scheduled.find_next(i)) {
+            if (sender_->SendSnapshotMessages(i)) {
+                send_ready.set(i);
+            }
+        }
+        sender_->send_blocked_.Reset(send_ready);
+
+        for (size_t i = send_ready.find_first(); i != BitSet::npos;
+             i = send_ready.find_next(i)) {
             // Dequeue from client marker (i).
             IFMAP_UPD_SENDER_TRACE(IFMapUSSendScheduled, "Send scheduled for",
-                send_scheduled.ToNumberedString(), "client", i,
+                send_ready.ToNumberedString(), "client", i,
                 sender_->queue_->GetMarker(i)->ToString());
             sender_->Send(sender_->queue_->GetMarker(i));
         }
@@ -94,6 +108,45 @@ void IFMapUpdateSender::CleanupClient(int index) {
     tbb::mutex::scoped_lock lock(mutex_);
     send_scheduled_.reset(index);
     send_blocked_.reset(index);
+    snapshots_.erase(index);
+}
+
+// Called in the context of the db::IFMapTable task, right after the client
+// joined the Q at the tail_marker. Marking the client as blocked makes Send()
+// leave the client's marker where it is, at the point at which the snapshot
+// was taken, until all the snapshot messages are sent.
+void IFMapUpdateSender::SendSnapshot(int index, MessageList *messages) {
+    if (messages->empty()) {
+        return;
+    }
+    MessageList &pending = snapshots_[index];
+    pending.splice(pending.end(), *messages);
+    SetSendBlocked(index);
+    SendActive(index);
+}
+
+// Returns true if the client has no snapshot messages left and is ready to
+// receive the updates in the Q. The client is blocked from the time the
+// snapshot is queued, and stays blocked if this returns false. SendActive()
+// for the client gets the rest of the snapshot sent.
+bool IFMapUpdateSender::SendSnapshotMessages(int index) {
+    SnapshotMap::iterator loc = snapshots_.find(index);
+    if (loc == snapshots_.end()) {
+        return true;
+    }
+    IFMapClient *client = server_->GetClient(index);
+    assert(client);
+
+    MessageList &messages = loc->second;
+    bool send_result = true;
+    while (send_result && !messages.empty()) {
+        send_result = client->SendUpdate(messages.front());
+        messages.pop_front();
+    }
+    if (messages.empty()) {
+        snapshots_.erase(loc);
+    }
+    return send_result;
 }
 
 // We return only under 2 conditions:
@@ -230,8 +283,13 @@ void IFMapUpdateSender::ProcessUpdate(IFMapUpdate *update,
                                       const BitSet &base_send_set) {
     LogAndCountSentUpdate(update, base_send_set);
 
-    // Append the contents of the update-node to the message.
-    message_->EncodeUpdate(update);
+    // Append the contents of the update-node to the message. Updates of
+    // nodes reuse the encoding cached in the node state.
+    IFMapNodeState *state = NULL;
+    if (update->IsUpdate() && update->data().IsNode()) {
+        state = server_->exporter()->NodeStateLookup(update->data().u.node);
+    }
+    message_->EncodeUpdate(update, state);
 
     // Clean up the node if everybody has seen it.
     update->AdvertiseReset(base_send_set);
@@ -257,7 +315,7 @@ void IFMapUpdateSender::SendUpdate(BitSet send_set, BitSet *blocked_set) {
         assert(client);
 
         message_->SetReceiverInMsg(client->identifier());
-        // Close the message to save the document as string
+        // Close the message to address the encoded objects to the client
         message_->Close();
 
         // Send the string version of the message to the client.
@@ -5,6 +5,9 @@
 #ifndef __ctrlplane__ifmap_update_sender__
 #define __ctrlplane__ifmap_update_sender__
 
+#include <list>
+#include <map>
+#include <string>
 #include <tbb/mutex.h>
 #include "base/bitset.h"
 #include "ifmap/ifmap_encoder.h"
@@ -18,6 +21,8 @@ class IFMapUpdateQueue;
 
 class IFMapUpdateSender {
 public:
+    typedef std::list<std::string> MessageList;
+
     IFMapUpdateSender(IFMapServer *server, IFMapUpdateQueue *queue);
     virtual ~IFMapUpdateSender();
 
@@ -30,6 +35,16 @@ public:
     // (after previously blocking).
     virtual void SendActive(int index);
 
+    // Queue the messages of the initial snapshot of a client for transmit.
+    // The client is held at its position in the update queue until all the
+    // messages are sent, so that the updates in the queue are applied on top
+    // of the snapshot.
+    void SendSnapshot(int index, MessageList *messages);
+
+    bool HasSnapshot(int index) const {
+        return snapshots_.find(index) != snapshots_.end();
+    }
+
     void CleanupClient(int index);
 
     void SetServer(IFMapServer *srv) { server_ = srv; }
@@ -43,6 +58,7 @@ public:
     }
 
 private:
+    typedef std::map<int, MessageList> SnapshotMap;
     class SendTask;
     friend class IFMapUpdateSenderTest;
 
@@ -50,6 +66,8 @@ private:
 
     void Send(IFMapMarker *imarker);
 
+    bool SendSnapshotMessages(int index);
+
     void SendUpdate(BitSet send_set, BitSet *blocked_set);
 
     IFMapMarker* ProcessMarker(IFMapMarker *marker, IFMapMarker *next_marker,
@@ -69,6 +87,11 @@ private:
     bool queue_active_;
     BitSet send_scheduled_;     // client-set for which send active was called
     BitSet send_blocked_;       // client-set for clients that are blocked
+    // Snapshot messages not sent yet, per client. Not protected by mutex_.
+    // It is accessed from SendSnapshot(), SendTask and CleanupClient(), which
+    // all run in db::IFMapTable task instance 0 (IFMapServer work_queue_ and
+    // SendTask) and hence never run concurrently.
+    SnapshotMap snapshots_;
 
     void SetSendBlocked(int client_index) {
         send_blocked_.set(client_index);
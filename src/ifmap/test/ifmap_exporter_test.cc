@@ -13,6 +13,7 @@
 #include "io/test/event_manager_test.h"
 #include "ifmap/ifmap_client.h"
 #include "ifmap/ifmap_factory.h"
+#include "ifmap/ifmap_graph_walker.h"
 #include "ifmap/ifmap_link_table.h"
 #include "ifmap/ifmap_server.h"
 #include "ifmap/ifmap_server_table.h"
@@ -1282,6 +1283,87 @@ TEST_F(IFMapExporterTest, ConfigTracker) {
     TASK_UTIL_EXPECT_EQ(LinkTableSize(), 10);
 }
 
+// Link delete that leaves both nodes of the link reachable does not need a
+// walk of the graph for the client.
+TEST_F(IFMapExporterTest, LinkDeleteReachable) {
+    server_->SetSender(new IFMapUpdateSenderMock(server_.get()));
+    TestClient c1("192.168.1.1");
+    ClientSetup(&c1);
+
+    IFMapMsgLink("virtual-machine", "virtual-machine-interface",
+                 "vm_x", "vm_x:veth0", "virtual-machine-interface-virtual-machine");
+    IFMapMsgLink("virtual-machine-interface", "virtual-network",
+                 "vm_x:veth0", "blue");
+    IFMapMsgLink("virtual-router", "virtual-machine", "192.168.1.1", "vm_x");
+    IFMapMsgLink("virtual-router", "virtual-machine-interface",
+                 "192.168.1.1", "vm_x:veth0");
+    task_util::WaitForIdle();
+
+    IFMapNode *blue = TableLookup("virtual-network", "blue");
+    ASSERT_TRUE(blue != NULL);
+    IFMapNodeState *state = exporter_->NodeStateLookup(blue);
+    ASSERT_TRUE(state != NULL);
+    TASK_UTIL_EXPECT_TRUE(state->interest().test(c1.index()));
+    const IFMapGraphWalker *walker = exporter_->walker();
+    uint64_t walks = walker->link_delete_walks();
+
+    // The interface is still reachable through the virtual-machine.
+    IFMapMsgUnlink("virtual-router", "virtual-machine-interface",
+                   "192.168.1.1", "vm_x:veth0");
+    task_util::WaitForIdle();
+    TASK_UTIL_EXPECT_EQ(1U, walker->link_delete_walks_skipped());
+    EXPECT_EQ(walks, walker->link_delete_walks());
+    EXPECT_TRUE(state->interest().test(c1.index()));
+
+    // Removing the only path to the virtual-machine needs a walk.
+    IFMapMsgUnlink("virtual-router", "virtual-machine", "192.168.1.1", "vm_x");
+    task_util::WaitForIdle();
+    TASK_UTIL_EXPECT_EQ(walks + 1, walker->link_delete_walks());
+    EXPECT_EQ(1U, walker->link_delete_walks_skipped());
+    TASK_UTIL_EXPECT_FALSE(state->interest().test(c1.index()));
+}
+
+// The config of a new client is sent as a snapshot, without updates in the
+// queue.
+TEST_F(IFMapExporterTest, ClientSnapshot) {
+    server_->SetSender(new IFMapUpdateSenderMock(server_.get()));
+    server_->set_client_snapshot_enable(true);
+
+    IFMapMsgLink("virtual-machine", "virtual-machine-interface",
+                 "vm_x", "vm_x:veth0", "virtual-machine-interface-virtual-machine");
+    IFMapMsgLink("virtual-machine-interface", "virtual-network",
+                 "vm_x:veth0", "blue");
+    IFMapMsgLink("virtual-router", "virtual-machine", "192.168.1.1", "vm_x");
+    task_util::WaitForIdle();
+
+    TestClient c1("192.168.1.1");
+    server_->AddClient(&c1);
+    task_util::WaitForIdle();
+
+    IFMapNode *blue = TableLookup("virtual-network", "blue");
+    ASSERT_TRUE(blue != NULL);
+    IFMapNodeState *state = exporter_->NodeStateLookup(blue);
+    ASSERT_TRUE(state != NULL);
+    EXPECT_TRUE(state->interest().test(c1.index()));
+    EXPECT_TRUE(state->advertised().test(c1.index()));
+    EXPECT_TRUE(state->update_list().empty());
+
+    IFMapLink *link = VerifyLink("virtual-machine-interface",
+                                 "virtual-network", "vm_x:veth0", "blue",
+                                 true);
+    IFMapLinkState *ls = exporter_->LinkStateLookup(link);
+    ASSERT_TRUE(ls != NULL);
+    EXPECT_TRUE(ls->advertised().test(c1.index()));
+
+    EXPECT_EQ(4U, c1.update_nodes_sent());
+    EXPECT_EQ(3U, c1.update_links_sent());
+    EXPECT_TRUE(server_->queue()->empty());
+
+    // The client stays blocked until the snapshot messages are sent.
+    EXPECT_TRUE(server_->sender()->HasSnapshot(c1.index()));
+    EXPECT_TRUE(server_->sender()->IsClientBlocked(c1.index()));
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     LoggingInit();
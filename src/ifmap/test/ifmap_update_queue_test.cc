@@ -440,6 +440,73 @@ TEST_F(IFMapUpdateQueueTest, MoveMarkerAfter) {
     delete(u2);
 }
 
+// Splitting a set next to an existing marker adds the set to that marker
+TEST_F(IFMapUpdateQueueTest, MarkerSplitCoalesce) {
+    IFMapTable::RequestKey key;
+    IFMapMarker *marker;
+
+    key.id_name = "a";
+    auto_ptr<DBEntry> n1(tbl_->AllocEntry(&key));
+    key.id_name = "b";
+    auto_ptr<DBEntry> n2(tbl_->AllocEntry(&key));
+
+    IFMapUpdate *u1 = CreateUpdate(n1.get());
+    IFMapUpdate *u2 = CreateUpdate(n2.get());
+
+    queue_->Join(1);     // client 1
+    queue_->Join(2);     // client 2
+    queue_->Join(3);     // client 3
+    queue_->Join(4);     // client 4
+    EXPECT_TRUE(queue_->GetMarker(0) == NULL);
+    EXPECT_TRUE(queue_->GetMarker(5) == NULL);
+
+    queue_->Enqueue(u1);
+    queue_->Enqueue(u2);
+    EXPECT_EQ(queue_->size(), 3); // 2 updates and 1 tail_marker
+
+    // Insert marker for client 1 before u2
+    BitSet rem_bs;
+    rem_bs.set(1);
+    marker = queue_->MarkerSplitBefore(queue_->tail_marker(), u2, rem_bs);
+    EXPECT_EQ(queue_->size(), 4); // 3 from before + 1 marker
+    EXPECT_TRUE(queue_->GetMarker(1) == marker);
+
+    // Client 2 goes to the same position. No new marker is created.
+    rem_bs.clear();
+    rem_bs.set(2);
+    EXPECT_TRUE(queue_->MarkerSplitBefore(queue_->tail_marker(), u2, rem_bs)
+                == marker);
+    EXPECT_EQ(queue_->size(), 4);
+    EXPECT_TRUE(queue_->GetMarker(2) == marker);
+
+    // Same position expressed as after u1
+    rem_bs.clear();
+    rem_bs.set(3);
+    EXPECT_TRUE(queue_->MarkerSplitAfter(queue_->tail_marker(), u1, rem_bs)
+                == marker);
+    EXPECT_EQ(queue_->size(), 4);
+    EXPECT_TRUE(queue_->GetMarker(3) == marker);
+    BitSet expected;
+    expected.set(1);
+    expected.set(2);
+    expected.set(3);
+    EXPECT_TRUE(marker->mask == expected);
+    EXPECT_TRUE(queue_->GetMarker(4) == queue_->tail_marker());
+
+    queue_->Dequeue(u1);
+    queue_->Dequeue(u2);
+
+    queue_->Leave(1);
+    queue_->Leave(2);
+    queue_->Leave(3);
+    EXPECT_EQ(queue_->size(), 1);
+    EXPECT_TRUE(queue_->GetMarker(1) == NULL);
+    queue_->Leave(4);
+
+    delete(u1);
+    delete(u2);
+}
+
 TEST_F(IFMapUpdateQueueTest, Next) {
     IFMapTable::RequestKey key;
 
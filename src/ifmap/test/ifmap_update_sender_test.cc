@@ -4,6 +4,8 @@
 
 #include "ifmap/ifmap_update_sender.h"
 
+#include <pugixml/pugixml.hpp>
+
 #include "base/logging.h"
 #include "base/task.h"
 #include "base/test/task_test_util.h"
@@ -12,6 +14,7 @@
 #include "db/db_table.h"
 #include "io/event_manager.h"
 #include "ifmap/ifmap_client.h"
+#include "ifmap/ifmap_encoder.h"
 #include "ifmap/ifmap_exporter.h"
 #include "ifmap/ifmap_link_table.h"
 #include "ifmap/ifmap_node.h"
@@ -37,10 +40,12 @@ public:
     virtual bool SendUpdate(const std::string &msg) {
         cout << "Sending " << endl << msg << endl;
         send_update_cnt_++;
+        messages_.push_back(msg);
         return send_success_;
     }
 
     int get_send_update_cnt() { return send_update_cnt_; }
+    const vector<string> &messages() const { return messages_; }
 
     // Control if you want to block or continue sending
     void set_send_success(bool succ) { send_success_ = succ; }
@@ -49,6 +54,7 @@ private:
     string identifier_;
     bool send_success_;
     int send_update_cnt_;
+    vector<string> messages_;
 };
 
 struct IFMapUpdateDeleter {
@@ -1231,6 +1237,163 @@ TEST_F(IFMapUpdateSenderTest, Bug228) {
     queue_->PrintQueue();
 }
 
+// Encoded node is cached in the node state and reused until the crc of the
+// node changes.
+// c0 and c1 share the tail marker. The snapshot of c1 must reach c1 before
+// the updates in the Q, even when the Send() for c0 traverses the Q first.
+TEST_F(IFMapUpdateSenderTest, SnapshotBeforeUpdates) {
+    TestClient c0("c0");
+    TestClient c1("c1");
+    server_.ClientRegister(&c0);
+    server_.ClientExporterSetup(&c0);
+    server_.ClientRegister(&c1);
+    server_.ClientExporterSetup(&c1);
+
+    IFMapUpdate *u1 = CreateUpdate("u1", true);
+    BitSet cli_bs;
+    cli_bs.set(c0.index());
+    cli_bs.set(c1.index());
+    u1->AdvertiseOr(cli_bs);
+
+    queue_->Join(c0.index());
+    queue_->Join(c1.index());
+    queue_->Enqueue(u1);
+    TASK_UTIL_EXPECT_EQ(2, queue_->size());
+    TASK_UTIL_EXPECT_TRUE(queue_->GetMarker(c0.index()) ==
+                          queue_->GetMarker(c1.index()));
+
+    // Schedule both clients for the same run of the send task.
+    IFMapUpdateSender::MessageList snapshot;
+    snapshot.push_back("snapshot-1");
+    snapshot.push_back("snapshot-2");
+    TaskScheduler::GetInstance()->Stop();
+    sender_->SendActive(c0.index());
+    sender_->SendSnapshot(c1.index(), &snapshot);
+    TaskScheduler::GetInstance()->Start();
+    task_util::WaitForIdle();
+
+    TASK_UTIL_EXPECT_EQ(1, queue_->size());
+    EXPECT_FALSE(sender_->HasSnapshot(c1.index()));
+    ASSERT_EQ(1U, c0.messages().size());
+    EXPECT_NE(string::npos, c0.messages()[0].find("<name>u1</name>"));
+    ASSERT_EQ(3U, c1.messages().size());
+    EXPECT_EQ("snapshot-1", c1.messages()[0]);
+    EXPECT_EQ("snapshot-2", c1.messages()[1]);
+    EXPECT_NE(string::npos, c1.messages()[2].find("<name>u1</name>"));
+
+    queue_->Leave(c0.index());
+    queue_->Leave(c1.index());
+}
+
+// A client that blocks in the middle of its snapshot gets no updates until
+// the rest of the snapshot is sent, while the other client on its marker
+// continues.
+TEST_F(IFMapUpdateSenderTest, SnapshotBlocked) {
+    TestClient c0("c0");
+    TestClient c1("c1");
+    server_.ClientRegister(&c0);
+    server_.ClientExporterSetup(&c0);
+    server_.ClientRegister(&c1);
+    server_.ClientExporterSetup(&c1);
+
+    IFMapUpdate *u1 = CreateUpdate("u1", true);
+    BitSet cli_bs;
+    cli_bs.set(c0.index());
+    cli_bs.set(c1.index());
+    u1->AdvertiseOr(cli_bs);
+
+    queue_->Join(c0.index());
+    queue_->Join(c1.index());
+    queue_->Enqueue(u1);
+
+    IFMapUpdateSender::MessageList snapshot;
+    snapshot.push_back("snapshot-1");
+    snapshot.push_back("snapshot-2");
+    c1.set_send_success(false);
+    TaskScheduler::GetInstance()->Stop();
+    sender_->SendActive(c0.index());
+    sender_->SendSnapshot(c1.index(), &snapshot);
+    TaskScheduler::GetInstance()->Start();
+    task_util::WaitForIdle();
+
+    // c0 got u1 and c1 is still blocked in its snapshot.
+    ASSERT_EQ(1U, c0.messages().size());
+    ASSERT_EQ(1U, c1.messages().size());
+    EXPECT_EQ("snapshot-1", c1.messages()[0]);
+    EXPECT_TRUE(sender_->HasSnapshot(c1.index()));
+    EXPECT_TRUE(sender_->IsClientBlocked(c1.index()));
+    TASK_UTIL_EXPECT_TRUE(queue_->GetMarker(c0.index()) ==
+                          queue_->tail_marker());
+    TASK_UTIL_EXPECT_TRUE(queue_->GetMarker(c1.index()) !=
+                          queue_->tail_marker());
+
+    // Unblock c1: the rest of the snapshot goes out and then u1.
+    c1.set_send_success(true);
+    sender_->SendActive(c1.index());
+    task_util::WaitForIdle();
+
+    TASK_UTIL_EXPECT_EQ(1, queue_->size());
+    EXPECT_FALSE(sender_->HasSnapshot(c1.index()));
+    EXPECT_FALSE(sender_->IsClientBlocked(c1.index()));
+    ASSERT_EQ(3U, c1.messages().size());
+    EXPECT_EQ("snapshot-2", c1.messages()[1]);
+    EXPECT_NE(string::npos, c1.messages()[2].find("<name>u1</name>"));
+    EXPECT_EQ(1U, c0.messages().size());
+
+    queue_->Leave(c0.index());
+    queue_->Leave(c1.index());
+}
+
+TEST_F(IFMapUpdateSenderTest, EncodedNodeCache) {
+    IFMapUpdate *u1 = CreateUpdate("u1", true);
+    queue_->Enqueue(u1);
+    IFMapNodeState *state =
+        server_.exporter()->NodeStateLookup(u1->data().u.node);
+    EXPECT_TRUE(state->GetEncoded() == NULL);
+
+    IFMapMessage message;
+    message.EncodeUpdate(u1, state);
+    ASSERT_TRUE(state->GetEncoded() != NULL);
+    string encoded = *state->GetEncoded();
+    EXPECT_NE(string::npos, encoded.find("<name>u1</name>"));
+
+    message.SetReceiverInMsg("c0");
+    message.Close();
+    string msg0 = message.get_string();
+    EXPECT_NE(string::npos, msg0.find(encoded));
+    message.SetReceiverInMsg("c1");
+    message.Close();
+    EXPECT_NE(string::npos, message.get_string().find("to=\"c1/config\""));
+
+    // The message must be well formed
+    pugi::xml_document doc;
+    ASSERT_TRUE(doc.load_buffer(msg0.data(), msg0.size()));
+    pugi::xml_node node = doc.child("iq").child("config").child("update").
+        child("node");
+    EXPECT_STREQ("virtual-network", node.attribute("type").value());
+    EXPECT_STREQ("u1", node.child("name").child_value());
+    EXPECT_STREQ("c0/config", doc.child("iq").attribute("to").value());
+
+    // Cached encoding is used for the next message
+    message.Reset();
+    message.EncodeUpdate(u1, state);
+    message.SetReceiverInMsg("c0");
+    message.Close();
+    EXPECT_EQ(msg0, message.get_string());
+
+    // Change in crc invalidates the cached encoding
+    IFMapState::crc32type crc = state->crc() + 1;
+    state->SetCrc(crc);
+    EXPECT_TRUE(state->GetEncoded() == NULL);
+    message.Reset();
+    message.EncodeUpdate(u1, state);
+    ASSERT_TRUE(state->GetEncoded() != NULL);
+    EXPECT_EQ(encoded, *state->GetEncoded());
+
+    state->ClearEncoded();
+    EXPECT_TRUE(state->GetEncoded() == NULL);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     bool success = RUN_ALL_TESTS();
@@ -147,6 +147,12 @@ public:
     // are pre-allocated to minimize compuation in ksync-tx-queue
     // pre-allocation is enabled only for flows for now
     virtual bool pre_alloc_rx_buffer() const { return false; }
+    // ksync-tx sends messages of entries with tx_priority ahead of other
+    // messages pending in the queue
+    virtual bool tx_priority() const { return false; }
+    // ksync-tx does not send messages with tx_priority ahead of messages of
+    // this entry. Set for objects referred to by entries with tx_priority
+    virtual bool tx_barrier() const { return false; }
     // ksync-tx supports multiple queues for KSync events. Get index of queue
     // to use
     virtual uint32_t GetTableIndex() const { return 0; }
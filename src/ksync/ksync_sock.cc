@@ -14,6 +14,7 @@
 #include "vr_os.h"
 #endif
 #include <sys/socket.h>
+#include <poll.h>
 
 #include <boost/bind.hpp>
 
@@ -168,6 +169,7 @@ KSyncSock::KSyncSock() :
     nl_client_(NULL), wait_tree_(), send_queue_(this),
     max_bulk_msg_count_(kMaxBulkMsgCount), max_bulk_buf_size_(kMaxBulkMsgSize),
     bulk_seq_no_(kInvalidBulkSeqNo), bulk_buf_size_(0), bulk_msg_count_(0),
+    bulk_msg_limit_(kMaxBulkMsgCount), bulk_buf_limit_(kMaxBulkMsgSize),
     rx_buff_(NULL), read_inline_(true), bulk_msg_context_(NULL),
     use_wait_tree_(true), process_data_inline_(false),
     ksync_bulk_sandesh_context_(), uve_bulk_sandesh_context_(),
@@ -464,6 +466,8 @@ void KSyncSock::SendAsync(KSyncEntry *entry, int msg_len, char *msg,
     } else {
         ioc->rx_buffer1_ = ioc->rx_buffer2_ = NULL;
     }
+    ioc->set_tx_priority(entry->tx_priority());
+    ioc->set_tx_barrier(entry->tx_barrier());
     send_queue_.Enqueue(ioc);
 }
 
@@ -481,24 +485,38 @@ void KSyncSock::WriteHandler(const boost::system::error_code& error,
 
 // End of messages in the work-queue. Send messages pending in bulk context
 void KSyncSock::OnEmptyQueue(bool done) {
-    if (bulk_seq_no_ == kInvalidBulkSeqNo)
-        return;
-
-    KSyncBulkMsgContext *bulk_message_context = NULL;
-    if (use_wait_tree_) {
-        if (read_inline_ == false) {
-            tbb::mutex::scoped_lock lock(mutex_);
-            WaitTree::iterator it = wait_tree_.find(bulk_seq_no_);
-            assert(it != wait_tree_.end());
-            bulk_message_context = &it->second;
+    if (bulk_seq_no_ != kInvalidBulkSeqNo) {
+        KSyncBulkMsgContext *bulk_message_context = NULL;
+        if (use_wait_tree_) {
+            if (read_inline_ == false) {
+                tbb::mutex::scoped_lock lock(mutex_);
+                WaitTree::iterator it = wait_tree_.find(bulk_seq_no_);
+                assert(it != wait_tree_.end());
+                bulk_message_context = &it->second;
+            } else {
+                bulk_message_context = bulk_msg_context_;
+            }
         } else {
-            bulk_message_context = bulk_msg_context_;
+            bulk_message_context = bulk_mctx_arr_[bmca_prod_];
         }
-    } else {
-        bulk_message_context = bulk_mctx_arr_[bmca_prod_];
+
+        SendBulkMessage(bulk_message_context, bulk_seq_no_);
     }
+    FlushSendBatch();
+}
 
-    SendBulkMessage(bulk_message_context, bulk_seq_no_);
+// Messages in a bulk context are grown beyond max_bulk_msg_count_ when more
+// messages are waiting in KSyncTxQueue. This reduces number of system calls
+// during bursts, without delaying messages when the queue is shallow. The
+// buffer limit of bulk context is scaled by same factor, else flow messages
+// would hit max_bulk_buf_size_ before the message limit.
+uint32_t KSyncSock::BulkMsgLimit() const {
+    size_t backlog = send_queue_.queue_len();
+    if (backlog <= max_bulk_msg_count_)
+        return max_bulk_msg_count_;
+    if (backlog >= kMaxAdaptiveBulkMsgCount)
+        return kMaxAdaptiveBulkMsgCount;
+    return backlog;
 }
 
 // Send messages accumilated in bulk context
@@ -551,6 +569,9 @@ KSyncBulkMsgContext *KSyncSock::LocateBulkContext
             bulk_seq_no_ = seqno;
             bulk_buf_size_ = 0;
             bulk_msg_count_ = 0;
+            bulk_msg_limit_ = BulkMsgLimit();
+            bulk_buf_limit_ =
+                (max_bulk_buf_size_ * bulk_msg_limit_) / max_bulk_msg_count_;
             bulk_msg_context_ = new KSyncBulkMsgContext(io_context_type,
                                                         work_queue_index);
         }
@@ -563,6 +584,9 @@ KSyncBulkMsgContext *KSyncSock::LocateBulkContext
             bulk_seq_no_ = seqno;
             bulk_buf_size_ = 0;
             bulk_msg_count_ = 0;
+            bulk_msg_limit_ = BulkMsgLimit();
+            bulk_buf_limit_ =
+                (max_bulk_buf_size_ * bulk_msg_limit_) / max_bulk_msg_count_;
 
             wait_tree_.insert(WaitTreePair(seqno,
                                        KSyncBulkMsgContext(io_context_type,
@@ -577,6 +601,9 @@ KSyncBulkMsgContext *KSyncSock::LocateBulkContext
             bulk_seq_no_ = seqno;
             bulk_buf_size_ = 0;
             bulk_msg_count_ = 0;
+            bulk_msg_limit_ = BulkMsgLimit();
+            bulk_buf_limit_ =
+                (max_bulk_buf_size_ * bulk_msg_limit_) / max_bulk_msg_count_;
 
             bulk_mctx_arr_[bmca_prod_] = new KSyncBulkMsgContext(io_context_type,
                                                             work_queue_index);
@@ -594,10 +621,10 @@ KSyncBulkMsgContext *KSyncSock::LocateBulkContext
 //  - false : if message cannot be added to bulk context
 bool KSyncSock::TryAddToBulk(KSyncBulkMsgContext *bulk_message_context,
                              IoContext *ioc) {
-    if ((bulk_buf_size_ + ioc->GetMsgLen()) >= max_bulk_buf_size_)
+    if ((bulk_buf_size_ + ioc->GetMsgLen()) >= bulk_buf_limit_)
         return false;
 
-    if (bulk_msg_count_ >= max_bulk_msg_count_)
+    if (bulk_msg_count_ >= bulk_msg_limit_)
         return false;
 
     if (bulk_message_context->io_context_type() != ioc->type())
@@ -648,7 +675,7 @@ bool KSyncSock::SendAsyncImpl(IoContext *ioc) {
 // KSyncSockNetlink routines
 /////////////////////////////////////////////////////////////////////////////
 KSyncSockNetlink::KSyncSockNetlink(boost::asio::io_service &ios, int protocol)
-    : sock_(ios, protocol) {
+    : sock_(ios, protocol), send_batch_count_(0) {
     ReceiveBuffForceSize set_rcv_buf;
     set_rcv_buf = KSYNC_SOCK_RECV_BUFF_SIZE;
     boost::system::error_code ec;
@@ -686,16 +713,88 @@ bool KSyncSockNetlink::Validate(char *data) {
 }
 
 //netlink socket class for interacting with kernel
+// Messages are held in send_batch_ and sent with a single sendmmsg when the
+// batch is full or KSyncTxQueue is drained. Responses are still matched to
+// bulk context with seqno in the WaitTree.
 void KSyncSockNetlink::AsyncSendTo(KSyncBufferList *iovec, uint32_t seq_no,
                                    HandlerCb cb) {
     ResetNetlink(nl_client_);
-    KSyncBufferList::iterator it = iovec->begin();
-    iovec->insert(it, buffer((char *)nl_client_->cl_buf,
-                             nl_client_->cl_buf_offset));
+    uint32_t header_len = nl_client_->cl_buf_offset;
     UpdateNetlink(nl_client_, bulk_buf_size_, seq_no);
 
-    boost::asio::netlink::raw::endpoint ep;
-    sock_.async_send_to(*iovec, ep, cb);
+    SendBatchEntry *entry = &send_batch_[send_batch_count_++];
+    assert(header_len <= kMaxHeaderLen);
+    memcpy(entry->header_, nl_client_->cl_buf, header_len);
+    entry->iovec_.clear();
+    struct iovec iov;
+    iov.iov_base = entry->header_;
+    iov.iov_len = header_len;
+    entry->iovec_.push_back(iov);
+    for (KSyncBufferList::iterator it = iovec->begin(); it != iovec->end();
+         ++it) {
+        iov.iov_base = buffer_cast<void *>(*it);
+        iov.iov_len = buffer_size(*it);
+        entry->iovec_.push_back(iov);
+    }
+    entry->cb_ = cb;
+
+    if (send_batch_count_ == kMaxSendBatch)
+        FlushSendBatch();
+}
+
+void KSyncSockNetlink::FlushSendBatch() {
+    if (send_batch_count_ == 0)
+        return;
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+
+    struct mmsghdr msgs[kMaxSendBatch];
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < send_batch_count_; i++) {
+        msgs[i].msg_hdr.msg_name = &addr;
+        msgs[i].msg_hdr.msg_namelen = sizeof(addr);
+        msgs[i].msg_hdr.msg_iov = &send_batch_[i].iovec_[0];
+        msgs[i].msg_hdr.msg_iovlen = send_batch_[i].iovec_.size();
+    }
+
+    // Socket is in non-blocking mode once asio starts async receive. Wait
+    // for socket to be writable if the kernel is out of buffers. The wait is
+    // bounded so that pending messages are failed once shutdown starts,
+    // instead of blocking KSyncTxQueue::Shutdown() forever
+    int sent = 0;
+    while (sent < send_batch_count_) {
+        int ret = SendMsgs(&msgs[sent], send_batch_count_ - sent);
+        if (ret < 0) {
+            int err = errno;
+            if (err == EINTR)
+                continue;
+            if ((err == EAGAIN || err == EWOULDBLOCK) && !IsShutdown()) {
+                struct pollfd pfd;
+                pfd.fd = sock_.native_handle();
+                pfd.events = POLLOUT;
+                pfd.revents = 0;
+                poll(&pfd, 1, kSendPollTimeoutMsec);
+                continue;
+            }
+            boost::system::error_code ec(err,
+                                         boost::system::system_category());
+            for (int i = sent; i < send_batch_count_; i++) {
+                send_batch_[i].cb_(ec, 0);
+            }
+            break;
+        }
+        for (int i = sent; i < sent + ret; i++) {
+            send_batch_[i].cb_(boost::system::error_code(), msgs[i].msg_len);
+        }
+        sent += ret;
+    }
+    send_batch_count_ = 0;
+}
+
+int KSyncSockNetlink::SendMsgs(struct mmsghdr *msgs, unsigned int count) {
+    return sendmmsg(sock_.native_handle(), msgs, count, 0);
 }
 
 size_t KSyncSockNetlink::SendTo(KSyncBufferList *iovec, uint32_t seq_no) {
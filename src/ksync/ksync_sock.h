@@ -5,6 +5,7 @@
 #ifndef ctrlplane_ksync_sock_h
 #define ctrlplane_ksync_sock_h
 
+#include <sys/uio.h>
 #include <vector>
 #include <boost/asio.hpp>
 #include <boost/asio/buffer.hpp>
@@ -105,17 +106,23 @@ public:
 
     IoContext() :
         sandesh_context_(NULL), msg_(NULL), msg_len_(0), seqno_(0),
-        type_(IOC_KSYNC), index_(0), rx_buffer1_(NULL), rx_buffer2_(NULL) {
+        type_(IOC_KSYNC), index_(0), tx_priority_(false), tx_barrier_(false),
+        tx_order_(0), rx_buffer1_(NULL),
+        rx_buffer2_(NULL) {
     }
     IoContext(char *msg, uint32_t len, uint32_t seq, AgentSandeshContext *ctx,
               Type type) :
         sandesh_context_(ctx), msg_(msg), msg_len_(len), seqno_(seq),
-        type_(type), index_(0), rx_buffer1_(NULL), rx_buffer2_(NULL) {
+        type_(type), index_(0), tx_priority_(false), tx_barrier_(false),
+        tx_order_(0), rx_buffer1_(NULL),
+        rx_buffer2_(NULL) {
     }
     IoContext(char *msg, uint32_t len, uint32_t seq, AgentSandeshContext *ctx,
               Type type, uint32_t index) :
         sandesh_context_(ctx), msg_(msg), msg_len_(len), seqno_(seq),
-        type_(type), index_(index), rx_buffer1_(NULL), rx_buffer2_(NULL) {
+        type_(type), index_(index), tx_priority_(false), tx_barrier_(false),
+        tx_order_(0), rx_buffer1_(NULL),
+        rx_buffer2_(NULL) {
     }
     virtual ~IoContext() {
         if (msg_ != NULL)
@@ -143,6 +150,12 @@ public:
     char *rx_buffer2() { return rx_buffer2_; }
     void reset_rx_buffer2() { rx_buffer2_ = NULL; }
     uint32_t index() const { return index_; }
+    bool tx_priority() const { return tx_priority_; }
+    void set_tx_priority(bool val) { tx_priority_ = val; }
+    bool tx_barrier() const { return tx_barrier_; }
+    void set_tx_barrier(bool val) { tx_barrier_ = val; }
+    size_t tx_order() const { return tx_order_; }
+    void set_tx_order(size_t order) { tx_order_ = order; }
 
     boost::intrusive::list_member_hook<> node_;
 
@@ -155,6 +168,12 @@ private:
     uint32_t seqno_;
     Type type_;
     uint32_t index_;
+    // Sent on the priority lane of KSyncTxQueue
+    bool tx_priority_;
+    // Priority lane messages are not sent ahead of this message
+    bool tx_barrier_;
+    // Number of barrier messages enqueued before this priority message
+    size_t tx_order_;
     // Buffers allocated to read the ksync responses for this IoContext.
     // As an optimization, KSync Tx Queue will use these buffers to minimize
     // computation in KSync Tx Queue context.
@@ -198,6 +217,8 @@ private:
  *   KSync Events are bunched if pass following constraints,
  *   - Number of KSync events is less than max_bulk_msg_count_
  *   - Total size of buffer for events is less than max_bulk_buf_size_
+ *     Both limits grow upto kMaxAdaptiveBulkMsgCount and
+ *     kMaxAdaptiveBulkMsgSize when KSyncTxQueue has a backlog
  *   - Type of IoContext is same.
  *     When type of IoContext is same, it also ensures that KSync Responses
  *     are processed in same WorkQueue.
@@ -319,6 +340,18 @@ public:
     const static unsigned kMaxBulkMsgCount = 16;
     // Max size of buffer that can be bunched together
     const static unsigned kMaxBulkMsgSize = (4*1024);
+    // Number of messages that can be bunched together when KSyncTxQueue has
+    // a backlog. Every IoContext can bring two rx-buffers into the bulk
+    // context, so this is bounded by the rx-buffers in a bulk context.
+    const static unsigned kMaxAdaptiveBulkMsgCount =
+        KSyncBulkMsgContext::kMaxRxBufferCount / 2;
+    // Max size of buffer bunched together with kMaxAdaptiveBulkMsgCount
+    // messages. Buffer limit grows in proportion to the message limit
+    const static unsigned kMaxAdaptiveBulkMsgSize =
+        (kMaxBulkMsgSize * kMaxAdaptiveBulkMsgCount) / kMaxBulkMsgCount;
+    // Max io-vectors to send a bulk context. One io-vector per message and
+    // one for the netlink header
+    const static unsigned kMaxBulkIovCount = kMaxAdaptiveBulkMsgCount + 1;
     // Sequence number to denote invalid builk-context
     const static unsigned kInvalidBulkSeqNo = 0xFFFFFFFF;
 
@@ -423,6 +456,7 @@ protected:
     bool ValidateAndEnqueue(char *data, KSyncBulkMsgContext *context);
     KSyncBulkSandeshContext *GetBulkSandeshContext(uint32_t seqno);
     void ProcessDataInline(char *data);
+    static bool IsShutdown() { return shutdown_; }
 
     tbb::mutex mutex_;
     nl_client *nl_client_;
@@ -446,6 +480,11 @@ protected:
     uint32_t bulk_buf_size_;
     // Current message count in bulk context
     uint32_t bulk_msg_count_;
+    // Max messages in current bulk context. Picked based on backlog in
+    // KSyncTxQueue when the bulk context is started
+    uint32_t bulk_msg_limit_;
+    // Max buffer size in current bulk context. Scaled with bulk_msg_limit_
+    uint32_t bulk_buf_limit_;
 
     uint32_t bmca_prod_;
     uint32_t bmca_cons_;
@@ -470,6 +509,12 @@ private:
     void WriteHandler(const boost::system::error_code& error,
                       size_t bytes_transferred);
 
+    // Messages sent with AsyncSendTo may be held by the transport to send
+    // several of them in one system call. Called when KSyncTxQueue is
+    // drained to send any message held.
+    virtual void FlushSendBatch() { }
+    uint32_t BulkMsgLimit() const;
+
     bool ProcessKernelData(KSyncBulkSandeshContext *ksync_context,
                            const KSyncRxData &data);
     bool ProcessRxData(KSyncRxQueueData data);
@@ -530,13 +575,36 @@ public:
                              HandlerCb cb);
     virtual std::size_t SendTo(KSyncBufferList *iovec, uint32_t seq_no);
     virtual void Receive(boost::asio::mutable_buffers_1);
+    virtual void FlushSendBatch();
 
     static void NetlinkDecoder(char *data, SandeshContext *ctxt);
     static void NetlinkBulkDecoder(char *data, SandeshContext *ctxt, bool more);
     static void Init(boost::asio::io_service &ios, int protocol, bool use_work_queue,
                      const std::string &cpu_pin_policy);
+protected:
+    // Max bulk messages sent in one sendmmsg call
+    static const int kMaxSendBatch = 16;
+    // Time to wait for socket to be writable before checking for shutdown
+    static const int kSendPollTimeoutMsec = 100;
+
+    // Sends messages in the batch. Returns number of messages sent, or -1
+    // with errno set. Tests override it to inspect the batches
+    virtual int SendMsgs(struct mmsghdr *msgs, unsigned int count);
+
 private:
+    static const size_t kMaxHeaderLen = 64;
+
+    // Bulk message held for sendmmsg. Netlink header is copied since
+    // nl_client_ is reused for next message.
+    struct SendBatchEntry {
+        char header_[kMaxHeaderLen];
+        std::vector<struct iovec> iovec_;
+        HandlerCb cb_;
+    };
+
     boost::asio::netlink::raw::socket sock_;
+    SendBatchEntry send_batch_[kMaxSendBatch];
+    int send_batch_count_;
 };
 
 //udp socket class for interacting with user vrouter
@@ -54,7 +54,7 @@ bool KSyncSockTcp::IsMoreData(char *data) {
 size_t KSyncSockTcp::SendTo(KSyncBufferList *iovec, uint32_t seq_no) {
     size_t len = 0, ret;
     struct msghdr msg;
-    struct iovec iov[max_bulk_msg_count_*2];
+    struct iovec iov[kMaxBulkIovCount];
     int i, fd;
 
     memset(&msg, 0, sizeof(msg));
@@ -68,6 +68,7 @@ size_t KSyncSockTcp::SendTo(KSyncBufferList *iovec, uint32_t seq_no) {
     iovec->insert(it, buffer((char *)nl_client_->cl_buf, offset));
 
     int count = iovec->size();
+    assert(count <= (int)kMaxBulkIovCount);
     for(i = 0; i < count; i++) {
         mutable_buffers_1 buf = iovec->at(i);
         size_t buf_size = boost::asio::buffer_size(buf);
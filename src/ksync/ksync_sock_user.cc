@@ -76,6 +76,7 @@ void KSyncSockTypeMap::ProcessSandesh(const uint8_t *parse_buf, size_t buf_len,
             LOG(DEBUG, "Incorrect decode len " << decode_len);
             break;
         }
+        msg_count_++;
         decode_buf += decode_len;
         decode_buf_len -= decode_len;
     }
@@ -518,6 +519,11 @@ int KSyncSockTypeMap::VxLanCount() {
     return sock->vxlan_map.size();
 }
 
+uint64_t KSyncSockTypeMap::MsgCount() {
+    KSyncSockTypeMap *sock = KSyncSockTypeMap::GetKSyncSockTypeMap();
+    return sock->msg_count_;
+}
+
 uint32_t KSyncSockTypeMap::GetSeqno(char *data) {
     struct nlmsghdr *nlh = (struct nlmsghdr *)data;
     return nlh->nlmsg_seq;
@@ -573,8 +579,8 @@ static int IoVectorToData(char *data, uint32_t len, KSyncBufferList *iovec) {
 //send or store in map
 void KSyncSockTypeMap::AsyncSendTo(KSyncBufferList *iovec, uint32_t seq_no,
                                    HandlerCb cb) {
-    char data[4096];
-    int data_len = IoVectorToData(data, 4096, iovec);
+    char data[kMaxAdaptiveBulkMsgSize];
+    int data_len = IoVectorToData(data, kMaxAdaptiveBulkMsgSize, iovec);
 
     KSyncUserSockContext ctx(seq_no);
     //parse and store info in map [done in Process() callbacks]
@@ -583,8 +589,8 @@ void KSyncSockTypeMap::AsyncSendTo(KSyncBufferList *iovec, uint32_t seq_no,
 
 //send or store in map
 std::size_t KSyncSockTypeMap::SendTo(KSyncBufferList *iovec, uint32_t seq_no) {
-    char data[4096];
-    int data_len = IoVectorToData(data, 4096, iovec);
+    char data[kMaxAdaptiveBulkMsgSize];
+    int data_len = IoVectorToData(data, kMaxAdaptiveBulkMsgSize, iovec);
     KSyncUserSockContext ctx(seq_no);
     //parse and store info in map [done in Process() callbacks]
     ProcessSandesh((const uint8_t *)(data), data_len, &ctx);
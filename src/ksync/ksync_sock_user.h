@@ -7,6 +7,7 @@
 
 #include <queue>
 
+#include <tbb/atomic.h>
 #include <tbb/mutex.h>
 #include <boost/asio.hpp>
 #include <boost/asio/buffer.hpp>
@@ -93,6 +94,7 @@ public:
     KSyncSockTypeMap(boost::asio::io_service &ios) : KSyncSock(), sock_(ios), ksync_error_() {
         block_msg_processing_ = false;
         is_incremental_index_ = false;
+        msg_count_ = 0;
     }
     ~KSyncSockTypeMap() {
         assert(nh_map.size() == 0);
@@ -180,6 +182,8 @@ public:
     static int MplsCount();
     static int RouteCount();
     static int VxLanCount();
+    // Number of sandesh messages received from agent
+    static uint64_t MsgCount();
     static KSyncSockTypeMap *GetKSyncSockTypeMap() { return singleton_; };
     static void Init(boost::asio::io_service &ios);
     static void Shutdown();
@@ -235,6 +239,7 @@ private:
     int ksync_error_[KSYNC_MAX_ENTRY_TYPE];
     bool block_msg_processing_;
     bool is_incremental_index_;
+    tbb::atomic<uint64_t> msg_count_;
     static KSyncSockTypeMap *singleton_;
     static vr_flow_entry *flow_table_;
     vr_bridge_entry *bridge_table_;
@@ -90,13 +90,18 @@ KSyncTxQueue::KSyncTxQueue(KSyncSock *sock) :
     event_fd_(-1),
     cpu_pin_policy_(),
     sock_(sock),
+    barrier_dequeues_(0),
+    priority_head_(NULL),
+    priority_burst_(0),
     enqueues_(0),
     dequeues_(0),
+    priority_dequeues_(0),
     write_events_(0),
     read_events_(0),
     busy_time_(0),
     measure_busy_time_(false) {
     queue_len_ = 0;
+    barrier_enqueues_ = 0;
     shutdown_ = false;
     ClearStats();
 }
@@ -150,7 +155,17 @@ bool KSyncTxQueue::EnqueueInternal(IoContext *io_context) {
         work_queue_->Enqueue(io_context);
         return true;
     }
-    queue_.push(io_context);
+    Lane lane = io_context->tx_priority() ? PRIORITY_LANE : NORMAL_LANE;
+    bool barrier = (lane == NORMAL_LANE && io_context->tx_barrier());
+    if (lane == PRIORITY_LANE) {
+        io_context->set_tx_order(barrier_enqueues_);
+    }
+    queue_[lane].push(io_context);
+    // Count the barrier only after it is in the normal lane. A priority
+    // message waiting for a barrier is then sure to find it in the queue
+    if (barrier) {
+        barrier_enqueues_++;
+    }
     enqueues_++;
     size_t ncount = queue_len_.fetch_and_increment() + 1;
     if (ncount > max_queue_len_)
@@ -172,6 +187,45 @@ bool KSyncTxQueue::EnqueueInternal(IoContext *io_context) {
     return true;
 }
 
+// Take message from priority lane, unless it must wait for barrier messages
+// enqueued before it
+bool KSyncTxQueue::DequeuePriority(IoContext **io_context) {
+    if (priority_head_ == NULL &&
+        queue_[PRIORITY_LANE].try_pop(priority_head_) == false) {
+        return false;
+    }
+    if (priority_head_->tx_order() > barrier_dequeues_) {
+        return false;
+    }
+
+    *io_context = priority_head_;
+    priority_head_ = NULL;
+    priority_burst_++;
+    priority_dequeues_++;
+    return true;
+}
+
+// Priority lane is checked before taking every message from normal lane.
+// Normal lane is checked after kMaxPriorityBurst messages from priority lane
+bool KSyncTxQueue::Dequeue(IoContext **io_context) {
+    if (priority_burst_ < kMaxPriorityBurst && DequeuePriority(io_context)) {
+        return true;
+    }
+
+    if (queue_[NORMAL_LANE].try_pop(*io_context)) {
+        if ((*io_context)->tx_barrier()) {
+            barrier_dequeues_++;
+        }
+        priority_burst_ = 0;
+        return true;
+    }
+
+    // Normal lane is empty. A priority message waits only for barriers
+    // present in normal lane, so it is not blocked now
+    priority_burst_ = 0;
+    return DequeuePriority(io_context);
+}
+
 bool KSyncTxQueue::Run() {
     set_thread_affinity(cpu_pin_policy_);
     while (1) {
@@ -193,7 +247,7 @@ bool KSyncTxQueue::Run() {
         if (measure_busy_time_)
             t1 = ClockMonotonicUsec();
         IoContext *io_context = NULL;
-        while (queue_.try_pop(io_context)) {
+        while (Dequeue(&io_context)) {
             dequeues_++;
             queue_len_ -= 1;
             sock_->SendAsyncImpl(io_context);
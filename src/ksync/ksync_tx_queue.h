@@ -38,6 +38,26 @@
 // when there is no data in the queue. This is an efficient implementation of
 // queue between agent and ksync
 //
+// Event-FD based queue has two lanes. Messages of entries with tx_priority
+// (flows) are queued to the priority lane and others to the normal lane. The
+// consumer checks the priority lane before taking every message from the
+// normal lane, so that a burst of route messages does not add latency to
+// flow setup. Both lanes are drained by the same thread since bulking and
+// response matching in KSyncSock are not thread-safe.
+//
+// Ordering rules between the lanes,
+// - Messages of an entry always use the same lane and an entry has atmost one
+//   message outstanding, so messages of an entry are never reordered.
+// - Flows do not track KSync dependencies. A flow refers to nexthop, mirror
+//   and qos-config indexes, and relies on those objects reaching vrouter
+//   before the flow. Entries of such objects set tx_barrier. A priority
+//   message is not taken ahead of barrier messages enqueued before it.
+//   Every priority message records number of barrier messages enqueued
+//   before it (tx_order) and waits till as many barriers are dequeued.
+// - Atmost kMaxPriorityBurst messages are taken from priority lane for every
+//   message from the normal lane, so that the normal lane is not starved
+//   during a flow burst.
+//
 #ifndef controller_src_ksync_ksync_tx_queue_h
 #define controller_src_ksync_ksync_tx_queue_h
 
@@ -55,6 +75,15 @@ class IoContext;
 class KSyncTxQueue {
 public:
     typedef tbb::concurrent_queue<IoContext *> Queue;
+    enum Lane {
+        PRIORITY_LANE,
+        NORMAL_LANE,
+        MAX_LANES
+    };
+
+    // Max messages taken from priority lane for every message from normal
+    // lane
+    static const size_t kMaxPriorityBurst = 32;
 
     KSyncTxQueue(KSyncSock *sock);
     ~KSyncTxQueue();
@@ -65,6 +94,7 @@ public:
 
     size_t enqueues() const { return enqueues_; }
     size_t dequeues() const { return dequeues_; }
+    size_t priority_dequeues() const { return priority_dequeues_; }
     uint32_t write_events() const { return write_events_; }
     uint32_t read_events() const { return read_events_; }
     size_t queue_len() const { return queue_len_; }
@@ -75,6 +105,7 @@ public:
         max_queue_len_ = 0;
         enqueues_ = 0;
         dequeues_ = 0;
+        priority_dequeues_ = 0;
         busy_time_ = 0;
         read_events_ = 0;
     }
@@ -84,21 +115,32 @@ public:
     }
 
 private:
+    friend class KSyncTxQueueTest;
     bool EnqueueInternal(IoContext *io_context);
+    bool Dequeue(IoContext **io_context);
+    bool DequeuePriority(IoContext **io_context);
 
     WorkQueue<IoContext *> *work_queue_;
     int event_fd_;
     // CPU pinning policy for netlink task
     std::string cpu_pin_policy_;
     KSyncSock *sock_;
-    Queue queue_;
+    Queue queue_[MAX_LANES];
     tbb::atomic<bool> shutdown_;
     pthread_t event_thread_;
     tbb::atomic<size_t> queue_len_;
     mutable size_t max_queue_len_;
+    // Number of barrier messages enqueued to and dequeued from normal lane
+    tbb::atomic<size_t> barrier_enqueues_;
+    size_t barrier_dequeues_;
+    // Head of priority lane waiting for barrier messages to be dequeued
+    IoContext *priority_head_;
+    // Messages taken from priority lane since last message from normal lane
+    size_t priority_burst_;
 
     mutable size_t enqueues_;
     mutable size_t dequeues_;
+    mutable size_t priority_dequeues_;
     mutable size_t write_events_;
     mutable size_t read_events_;
     mutable uint64_t busy_time_;
@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2018 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <linux/netlink.h>
+
+#include <map>
+#include <vector>
+
+#include <boost/bind.hpp>
+
+#include "base/logging.h"
+#include "base/test/task_test_util.h"
+#include "io/event_manager.h"
+#include "testing/gunit.h"
+
+#include "ksync/ksync_sock.h"
+
+using namespace std;
+using namespace boost::asio;
+
+EventManager *evm_;
+
+// Netlink socket that records the batches given to sendmmsg instead of
+// sending them to the kernel
+class TestKSyncSockNetlink : public KSyncSockNetlink {
+public:
+    struct SentMsg {
+        uint32_t seqno_;
+        vector<char *> payload_;
+    };
+
+    TestKSyncSockNetlink(io_service &ios) :
+        KSyncSockNetlink(ios, NETLINK_GENERIC), eagain_count_(0),
+        partial_send_(false) {
+    }
+    virtual ~TestKSyncSockNetlink() { }
+
+    static TestKSyncSockNetlink *Init(io_service &ios) {
+        TestKSyncSockNetlink *sock = new TestKSyncSockNetlink(ios);
+        KSyncSock::SetSockTableEntry(sock);
+        KSyncSock::Init(true, "");
+        KSyncSock::SetNetlinkFamilyId(24);
+        KSyncSock::Start(false);
+        return sock;
+    }
+
+    virtual int SendMsgs(struct mmsghdr *msgs, unsigned int count) {
+        if (eagain_count_ != 0) {
+            if (eagain_count_ > 0)
+                eagain_count_--;
+            errno = EAGAIN;
+            return -1;
+        }
+        if (partial_send_) {
+            partial_send_ = false;
+            count = 1;
+        }
+
+        batches_.push_back(count);
+        for (unsigned int i = 0; i < count; i++) {
+            struct iovec *iov = msgs[i].msg_hdr.msg_iov;
+            struct nlmsghdr *nlh = (struct nlmsghdr *)iov[0].iov_base;
+            SentMsg msg;
+            msg.seqno_ = nlh->nlmsg_seq;
+            msgs[i].msg_len = iov[0].iov_len;
+            for (size_t j = 1; j < msgs[i].msg_hdr.msg_iovlen; j++) {
+                msg.payload_.push_back((char *)iov[j].iov_base);
+                msgs[i].msg_len += iov[j].iov_len;
+            }
+            sent_.push_back(msg);
+        }
+        return count;
+    }
+
+    bool WaitTreeHas(uint32_t seqno) {
+        tbb::mutex::scoped_lock lock(mutex_);
+        return wait_tree_.find(seqno) != wait_tree_.end();
+    }
+
+    static int max_send_batch() { return kMaxSendBatch; }
+    // Fail next count sends with EAGAIN. -1 fails all sends
+    void set_eagain_count(int count) { eagain_count_ = count; }
+    // Send only one message in next sendmmsg call
+    void set_partial_send() { partial_send_ = true; }
+    const vector<int> &batches() const { return batches_; }
+    const vector<SentMsg> &sent() const { return sent_; }
+
+private:
+    int eagain_count_;
+    bool partial_send_;
+    vector<int> batches_;
+    vector<SentMsg> sent_;
+};
+
+class KSyncSockNetlinkTest : public ::testing::Test {
+protected:
+    KSyncSockNetlinkTest() : sock_(NULL), write_errors_(0) {
+    }
+
+    virtual void SetUp() {
+        sock_ = TestKSyncSockNetlink::Init(*evm_->io_service());
+    }
+
+    virtual void TearDown() {
+        // Socket is released and not deleted, since WaitTree has contexts
+        // pending response
+        if (KSyncSock::Get(0) != NULL) {
+            KSyncSock::Shutdown();
+        }
+    }
+
+    // Messages with different work-queue index are not bunched together
+    void Send(uint32_t index, uint32_t len) {
+        char *msg = (char *)malloc(len);
+        memset(msg, 0, len);
+        uint32_t seqno = sock_->AllocSeqNo(IoContext::IOC_KSYNC, index);
+        seqno_map_[msg] = seqno;
+        msgs_.push_back(msg);
+        sock_->GenericSend(new IoContext(msg, len, seqno, NULL,
+                                         IoContext::IOC_KSYNC, index));
+    }
+
+    void WriteHandler(const boost::system::error_code &ec, size_t len) {
+        if (ec) {
+            write_errors_++;
+        }
+    }
+
+    TestKSyncSockNetlink *sock_;
+    map<char *, uint32_t> seqno_map_;
+    vector<char *> msgs_;
+    int write_errors_;
+};
+
+// Bulk messages are held till KSyncTxQueue is drained and sent together
+TEST_F(KSyncSockNetlinkTest, FlushOnDrain) {
+    TaskScheduler::GetInstance()->Stop();
+    for (int i = 0; i < 3; i++) {
+        Send(i % 2, 64);
+    }
+    TaskScheduler::GetInstance()->Start();
+    task_util::WaitForIdle();
+
+    ASSERT_EQ(1U, sock_->batches().size());
+    EXPECT_EQ(3, sock_->batches()[0]);
+    ASSERT_EQ(3U, sock_->sent().size());
+    EXPECT_EQ(3U, sock_->WaitTreeSize());
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(seqno_map_[msgs_[i]], sock_->sent()[i].seqno_);
+    }
+}
+
+// Batch is sent as soon as it is full, rest of the bulk messages are sent
+// when KSyncTxQueue is drained
+TEST_F(KSyncSockNetlinkTest, FlushOnFullBatch) {
+    int count = TestKSyncSockNetlink::max_send_batch() + 1;
+    TaskScheduler::GetInstance()->Stop();
+    for (int i = 0; i < count; i++) {
+        Send(i % 2, 64);
+    }
+    TaskScheduler::GetInstance()->Start();
+    task_util::WaitForIdle();
+
+    ASSERT_EQ(2U, sock_->batches().size());
+    EXPECT_EQ(TestKSyncSockNetlink::max_send_batch(), sock_->batches()[0]);
+    EXPECT_EQ(1, sock_->batches()[1]);
+    EXPECT_EQ((size_t)count, sock_->sent().size());
+    EXPECT_EQ((uint32_t)count, sock_->WaitTreeSize());
+}
+
+// Every bulk message in a sendmmsg carries seqno of its bulk context, and
+// the context is in WaitTree to match the response
+TEST_F(KSyncSockNetlinkTest, MultiBulkSeqno) {
+    uint32_t count = KSyncSock::kMaxBulkMsgCount * 2 + 8;
+    TaskScheduler::GetInstance()->Stop();
+    for (uint32_t i = 0; i < count; i++) {
+        Send(0, 64);
+    }
+    TaskScheduler::GetInstance()->Start();
+    task_util::WaitForIdle();
+
+    ASSERT_EQ(1U, sock_->batches().size());
+    ASSERT_EQ(3U, sock_->sent().size());
+    EXPECT_EQ(3U, sock_->WaitTreeSize());
+
+    size_t next = 0;
+    for (size_t i = 0; i < sock_->sent().size(); i++) {
+        const TestKSyncSockNetlink::SentMsg &msg = sock_->sent()[i];
+        ASSERT_FALSE(msg.payload_.empty());
+        EXPECT_EQ(seqno_map_[msg.payload_[0]], msg.seqno_);
+        EXPECT_TRUE(sock_->WaitTreeHas(msg.seqno_));
+        // Messages of a bulk are in the order they were enqueued
+        for (size_t j = 0; j < msg.payload_.size(); j++) {
+            EXPECT_EQ(msgs_[next++], msg.payload_[j]);
+        }
+    }
+    EXPECT_EQ((size_t)count, next);
+    EXPECT_EQ((size_t)KSyncSock::kMaxBulkMsgCount,
+              sock_->sent()[0].payload_.size());
+    EXPECT_EQ(8U, sock_->sent()[2].payload_.size());
+}
+
+// sendmmsg is retried on EAGAIN and on partial send
+TEST_F(KSyncSockNetlinkTest, SendRetry) {
+    sock_->set_eagain_count(2);
+    sock_->set_partial_send();
+    TaskScheduler::GetInstance()->Stop();
+    for (int i = 0; i < 3; i++) {
+        Send(i % 2, 64);
+    }
+    TaskScheduler::GetInstance()->Start();
+    task_util::WaitForIdle();
+
+    ASSERT_EQ(2U, sock_->batches().size());
+    EXPECT_EQ(1, sock_->batches()[0]);
+    EXPECT_EQ(2, sock_->batches()[1]);
+    ASSERT_EQ(3U, sock_->sent().size());
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(seqno_map_[msgs_[i]], sock_->sent()[i].seqno_);
+    }
+}
+
+// Flush does not wait for socket to be writable after shutdown
+TEST_F(KSyncSockNetlinkTest, FlushOnShutdown) {
+    KSyncSock::Shutdown();
+    sock_->set_eagain_count(-1);
+
+    char data[64];
+    memset(data, 0, sizeof(data));
+    KSyncBufferList iovec;
+    iovec.push_back(buffer(data, sizeof(data)));
+    sock_->AsyncSendTo(&iovec, 10,
+                       boost::bind(&KSyncSockNetlinkTest::WriteHandler, this,
+                                   _1, _2));
+    sock_->FlushSendBatch();
+    EXPECT_EQ(1, write_errors_);
+    EXPECT_EQ(0U, sock_->sent().size());
+}
+
+class KSyncTxQueueTest : public ::testing::Test {
+protected:
+    KSyncTxQueueTest() : queue_(NULL) {
+    }
+
+    // Messages are taken from the lanes in the test thread. Event-fd only
+    // absorbs the notification to drain thread
+    virtual void SetUp() {
+        queue_.event_fd_ = eventfd(0, (EFD_CLOEXEC | EFD_SEMAPHORE));
+        ASSERT_GE(queue_.event_fd_, 0);
+    }
+
+    virtual void TearDown() {
+        Drain();
+        close(queue_.event_fd_);
+    }
+
+    // Sequence number of IoContext identifies the message
+    void Enqueue(uint32_t id, bool priority, bool barrier) {
+        IoContext *ioc = new IoContext(NULL, 0, id, NULL,
+                                       IoContext::IOC_KSYNC);
+        ioc->set_tx_priority(priority);
+        ioc->set_tx_barrier(barrier);
+        queue_.Enqueue(ioc);
+    }
+
+    // Returns the messages in the order they are taken from the queue
+    vector<uint32_t> Drain() {
+        vector<uint32_t> order;
+        IoContext *ioc = NULL;
+        while (queue_.Dequeue(&ioc)) {
+            order.push_back(ioc->GetSeqno());
+            queue_.queue_len_ -= 1;
+            delete ioc;
+        }
+        return order;
+    }
+
+    KSyncTxQueue queue_;
+};
+
+// Priority lane goes first and each lane keeps its order
+TEST_F(KSyncTxQueueTest, LaneOrder) {
+    Enqueue(1, false, false);
+    Enqueue(2, false, false);
+    Enqueue(101, true, false);
+    Enqueue(3, false, false);
+    Enqueue(102, true, false);
+    Enqueue(103, true, false);
+
+    vector<uint32_t> order = Drain();
+    uint32_t expected[] = {101, 102, 103, 1, 2, 3};
+    EXPECT_EQ(vector<uint32_t>(expected, expected + 6), order);
+    EXPECT_EQ(3U, queue_.priority_dequeues());
+    EXPECT_EQ(0U, queue_.queue_len());
+}
+
+// Messages enqueued for an entry are never reordered
+TEST_F(KSyncTxQueueTest, EntryOrder) {
+    for (uint32_t i = 0; i < 10; i++) {
+        Enqueue(100 + i, true, false);
+        Enqueue(i, false, (i % 3) == 0);
+    }
+
+    vector<uint32_t> order = Drain();
+    ASSERT_EQ(20U, order.size());
+    uint32_t last_priority = 0;
+    uint32_t last_normal = 0;
+    for (size_t i = 0; i < order.size(); i++) {
+        if (order[i] >= 100) {
+            EXPECT_LE(last_priority, order[i]);
+            last_priority = order[i];
+        } else {
+            EXPECT_LE(last_normal, order[i]);
+            last_normal = order[i];
+        }
+    }
+    EXPECT_EQ(10U, queue_.priority_dequeues());
+}
+
+// Priority message does not overtake a barrier message enqueued before it,
+// but overtakes other messages
+TEST_F(KSyncTxQueueTest, Barrier) {
+    Enqueue(1, false, false);
+    Enqueue(2, false, true);
+    Enqueue(3, false, false);
+    Enqueue(101, true, false);
+    Enqueue(4, false, true);
+    Enqueue(102, true, false);
+
+    vector<uint32_t> order = Drain();
+    uint32_t expected[] = {1, 2, 101, 3, 4, 102};
+    EXPECT_EQ(vector<uint32_t>(expected, expected + 6), order);
+    EXPECT_EQ(2U, queue_.priority_dequeues());
+}
+
+// Normal lane is served after kMaxPriorityBurst messages from priority lane
+TEST_F(KSyncTxQueueTest, PriorityBurst) {
+    const uint32_t burst = KSyncTxQueue::kMaxPriorityBurst;
+    Enqueue(1, false, false);
+    Enqueue(2, false, false);
+    for (uint32_t i = 0; i < burst * 2 + 1; i++) {
+        Enqueue(100 + i, true, false);
+    }
+
+    vector<uint32_t> order = Drain();
+    ASSERT_EQ(burst * 2 + 3, order.size());
+    EXPECT_EQ(1U, order[burst]);
+    EXPECT_EQ(2U, order[burst * 2 + 1]);
+    EXPECT_EQ(100 + burst * 2, order[burst * 2 + 2]);
+    EXPECT_EQ(burst * 2 + 1, queue_.priority_dequeues());
+}
+
+class TestKSyncSockTcp : public KSyncSockTcp {
+public:
+    TestKSyncSockTcp(EventManager *evm, ip::address ip_addr, int port) :
+        KSyncSockTcp(evm, ip_addr, port) {
+        InitNetlink(nl_client_);
+    }
+    virtual ~TestKSyncSockTcp() { }
+
+    size_t SendBulk(KSyncBufferList *iovec, uint32_t seqno, uint32_t len) {
+        bulk_buf_size_ = len;
+        return SendTo(iovec, seqno);
+    }
+};
+
+// A bulk of kMaxAdaptiveBulkMsgCount messages is sent in one sendmsg on the
+// TCP socket to user space vrouter
+TEST(KSyncSockTcpTest, MaxAdaptiveBulk) {
+    // Stand-in for vrouter. Accepts connection from KSyncSockTcp
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listen_fd, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(0, bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)));
+    ASSERT_EQ(0, listen(listen_fd, 1));
+    socklen_t addr_len = sizeof(addr);
+    ASSERT_EQ(0, getsockname(listen_fd, (struct sockaddr *)&addr, &addr_len));
+
+    TestKSyncSockTcp *sock =
+        new TestKSyncSockTcp(evm_, ip::address::from_string("127.0.0.1"),
+                             ntohs(addr.sin_port));
+    int fd = accept(listen_fd, NULL, NULL);
+    ASSERT_GE(fd, 0);
+    close(listen_fd);
+    TASK_UTIL_EXPECT_TRUE(sock->connect_complete());
+
+    const uint32_t kMsgLen = 128;
+    const uint32_t count = KSyncSock::kMaxAdaptiveBulkMsgCount;
+    vector<char> data(count * kMsgLen);
+    KSyncBufferList iovec;
+    for (uint32_t i = 0; i < count; i++) {
+        memset(&data[i * kMsgLen], i, kMsgLen);
+        iovec.push_back(buffer(&data[i * kMsgLen], kMsgLen));
+    }
+    size_t len = sock->SendBulk(&iovec, 100, data.size());
+    // One io-vector for netlink header and one per message
+    EXPECT_EQ((size_t)KSyncSock::kMaxBulkIovCount, iovec.size());
+    ASSERT_GT(len, data.size());
+
+    vector<char> rx(len);
+    size_t rx_len = 0;
+    while (rx_len < len) {
+        ssize_t ret = recv(fd, &rx[rx_len], len - rx_len, 0);
+        ASSERT_GT(ret, 0);
+        rx_len += ret;
+    }
+    struct nlmsghdr *nlh = (struct nlmsghdr *)&rx[0];
+    EXPECT_EQ(100U, nlh->nlmsg_seq);
+    EXPECT_EQ(0, memcmp(&rx[len - data.size()], &data[0], data.size()));
+
+    // Connection and socket are left open, KSyncSockTcp exits the process
+    // when the connection is closed
+}
+
+void *asio_poll(void *arg){
+    EventManager *evm = reinterpret_cast<EventManager *>(arg);
+    evm->Run();
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    LoggingInit();
+
+    EventManager evm;
+    evm_ = &evm;
+    pthread_t asio_thread;
+    assert(pthread_create(&asio_thread, NULL, asio_poll, &evm) == 0);
+
+    int ret = RUN_ALL_TESTS();
+    evm.Shutdown();
+    assert(pthread_join(asio_thread, NULL) == 0);
+    TaskScheduler::GetInstance()->Terminate();
+    return ret;
+}
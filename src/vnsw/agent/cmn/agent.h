@@ -376,6 +376,9 @@ public:
     static const uint32_t kDefaultTaskMonitorTimeout = (20000); //time-millisecs
     // Default number of tx-buffers on pkt0 interface
     static const uint32_t kPkt0TxBufferCount = 1000;
+    // Default number of packets read from pkt0 interface per wakeup. Batched
+    // receive is disabled when set to 0
+    static const uint32_t kPkt0RxBatchSize = 0;
     // Default value for cleanup of stale interface entries
     static const uint32_t kDefaultStaleInterfaceCleanupTimeout = 60;
 
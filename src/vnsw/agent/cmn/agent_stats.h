@@ -30,9 +30,8 @@ public:
         : agent_(agent), xmpp_reconnect_(), xmpp_in_msgs_(), xmpp_out_msgs_(),
         xmpp_config_in_msgs_(), sandesh_reconnects_(0U),
         sandesh_in_msgs_(0U), sandesh_out_msgs_(0U),
-        sandesh_http_sessions_(0U), nh_count_(0U), pkt_exceptions_(0U),
-        pkt_invalid_agent_hdr_(0U), pkt_invalid_interface_(0U),
-        pkt_no_handler_(0U), pkt_fragments_dropped_(0U), pkt_dropped_(0U),
+        sandesh_http_sessions_(0U), nh_count_(0U),
+        pkt_invalid_agent_hdr_(0U), pkt_no_handler_(0U), pkt_dropped_(0U),
         max_flow_count_(0),
         flow_drop_due_to_max_limit_(0), flow_drop_due_to_linklocal_limit_(0),
         flow_stats_update_timeout_(kFlowStatsUpdateInterval),
@@ -40,6 +39,9 @@ public:
         out_tpkts_(0U), out_bytes_(0U) {
         assert(singleton_ == NULL);
         singleton_ = this;
+        pkt_exceptions_ = 0;
+        pkt_invalid_interface_ = 0;
+        pkt_fragments_dropped_ = 0;
         flow_count_ = 0;
         flow_created_ = 0;
         flow_aged_ = 0;
@@ -214,12 +216,13 @@ private:
     // Number of NH created
     uint32_t nh_count_;
 
-    // Exception packet stats
-    uint64_t pkt_exceptions_;
+    // Exception packet stats. Flow traps are parsed in flow-table tasks
+    // in run-to-completion mode, so counters updated while parsing are atomic
+    tbb::atomic<uint64_t> pkt_exceptions_;
     uint64_t pkt_invalid_agent_hdr_;
-    uint64_t pkt_invalid_interface_;
+    tbb::atomic<uint64_t> pkt_invalid_interface_;
     uint64_t pkt_no_handler_;
-    uint64_t pkt_fragments_dropped_;
+    tbb::atomic<uint64_t> pkt_fragments_dropped_;
     uint64_t pkt_dropped_;
 
     // Flow stats
@@ -19,6 +19,7 @@
 #include "sandesh/sandesh_trace.h"
 #include "pkt/pkt_types.h"
 #include "pkt/pkt_init.h"
+#include "pkt/packet_buffer.h"
 #include "../pkt0_interface.h"
 
 #define TAP_TRACE(obj, ...)                                              \
@@ -151,6 +152,7 @@ void Pkt0Interface::InitControlInterface() {
     assert(ec == 0);
 
     VrouterControlInterface::InitControlInterface();
+    InitRxBatch();
     AsyncRead();
 }
 
@@ -161,3 +163,25 @@ void Pkt0Interface::SendImpl(uint8_t *buff, uint16_t buff_len, const PacketBuffe
                                         boost::asio::placeholders::error,
                                         boost::asio::placeholders::bytes_transferred, buff));
 }
+
+// Read packets from the tap device till it is empty or the batch is full
+uint32_t Pkt0Interface::ReadBatchImpl() {
+    uint32_t count = 0;
+    while (count < rx_batch_size_) {
+        ssize_t len = read(tap_fd_, rx_buffs_[count],
+                           PacketBufferManager::kRxBufferSize);
+        if (len < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                TAP_TRACE(Err, "Packet Tap Error <" +
+                          std::string(strerror(errno)) + "> reading packet");
+            }
+            break;
+        }
+        if (len == 0)
+            break;
+        rx_lens_[count++] = len;
+    }
+    return count;
+}
@@ -20,6 +20,7 @@
 #include "sandesh/sandesh_trace.h"
 #include "pkt/pkt_types.h"
 #include "pkt/pkt_init.h"
+#include "pkt/packet_buffer.h"
 #include "../pkt0_interface.h"
 
 #define TUN_INTF_CLONE_DEV "/dev/net/tun"
@@ -141,6 +142,7 @@ void Pkt0Interface::InitControlInterface() {
     assert(ec == 0);
 
     VrouterControlInterface::InitControlInterface();
+    InitRxBatch();
     AsyncRead();
 }
 
@@ -152,6 +154,56 @@ void Pkt0Interface::SendImpl(uint8_t *buff, uint16_t buff_len, const PacketBuffe
                                         boost::asio::placeholders::bytes_transferred, buff));
 }
 
+// Packet socket is drained with a single recvmmsg call. The tap device does
+// not support recvmmsg, so read packets one at a time till the device is
+// empty or the batch is full
+uint32_t Pkt0Interface::ReadBatchImpl() {
+    if (rx_socket_) {
+        struct mmsghdr msgs[kMaxRxBatchSize];
+        struct iovec iov[kMaxRxBatchSize];
+        memset(msgs, 0, sizeof(struct mmsghdr) * rx_batch_size_);
+        for (uint32_t i = 0; i < rx_batch_size_; i++) {
+            iov[i].iov_base = rx_buffs_[i];
+            iov[i].iov_len = PacketBufferManager::kRxBufferSize;
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int ret = recvmmsg(tap_fd_, msgs, rx_batch_size_, MSG_DONTWAIT, NULL);
+        if (ret < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                TAP_TRACE(Err, "Packet Tap Error <" +
+                          std::string(strerror(errno)) + "> reading packets");
+            }
+            return 0;
+        }
+
+        for (int i = 0; i < ret; i++) {
+            rx_lens_[i] = msgs[i].msg_len;
+        }
+        return ret;
+    }
+
+    uint32_t count = 0;
+    while (count < rx_batch_size_) {
+        ssize_t len = read(tap_fd_, rx_buffs_[count],
+                           PacketBufferManager::kRxBufferSize);
+        if (len < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                TAP_TRACE(Err, "Packet Tap Error <" +
+                          std::string(strerror(errno)) + "> reading packet");
+            }
+            break;
+        }
+        if (len == 0)
+            break;
+        rx_lens_[count++] = len;
+    }
+    return count;
+}
+
 void Pkt0RawInterface::InitControlInterface() {
     pkt_handler()->agent()->set_pkt_interface_name(name_);
 
@@ -207,5 +259,6 @@ void Pkt0RawInterface::InitControlInterface() {
     assert(ec == 0);
 
     VrouterControlInterface::InitControlInterface();
+    InitRxBatch();
     AsyncRead();
 }
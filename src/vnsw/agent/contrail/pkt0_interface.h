@@ -16,6 +16,8 @@
 class Pkt0Interface: public VrouterControlInterface {
 public:
     typedef std::vector<boost::asio::const_buffer> buffer_list;
+    // Upper limit on packets read per wakeup in batched receive mode
+    static const uint32_t kMaxRxBatchSize = 256;
 
     Pkt0Interface(const std::string &name, boost::asio::io_service *io);
     virtual ~Pkt0Interface();
@@ -27,13 +29,20 @@ public:
     const std::string &Name() const { return name_; }
     int Send(uint8_t *buff, uint16_t buff_len, const PacketBufferPtr &pkt);
     const unsigned char *mac_address() const { return mac_address_; }
+    uint32_t rx_batch_size() const { return rx_batch_size_; }
 protected:
     // Implements system specific send for Pkt0Interface
     void SendImpl(uint8_t *buff, uint16_t buff_len, const PacketBufferPtr &pkt,
                   buffer_list& buff_list);
+    // Implements system specific batched read for Pkt0Interface. Reads
+    // upto rx_batch_size_ packets into rx_buffs_ without blocking and
+    // returns the number of packets read
+    uint32_t ReadBatchImpl();
 
+    void InitRxBatch();
     void AsyncRead();
     void ReadHandler(const boost::system::error_code &err, std::size_t length);
+    void BatchReadHandler(const boost::system::error_code &err);
     void WriteHandler(const boost::system::error_code &error,
                       std::size_t length, uint8_t *buff);
 
@@ -45,6 +54,13 @@ protected:
 
     uint8_t *read_buff_;
     PktHandler *pkt_handler_;
+
+    // Batched receive. Enabled when rx_batch_size_ is non-zero
+    uint32_t rx_batch_size_;
+    // tap_fd_ is a packet socket instead of tap device
+    bool rx_socket_;
+    std::vector<uint8_t *> rx_buffs_;
+    std::vector<uint16_t> rx_lens_;
     DISALLOW_COPY_AND_ASSIGN(Pkt0Interface);
 };
 
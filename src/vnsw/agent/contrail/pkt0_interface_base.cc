@@ -17,6 +17,8 @@
 #include "sandesh/sandesh_trace.h"
 #include "pkt/pkt_types.h"
 #include "pkt/pkt_init.h"
+#include "pkt/packet_buffer.h"
+#include "init/agent_param.h"
 #include "pkt0_interface.h"
 
 using namespace boost::asio;
@@ -44,7 +46,8 @@ void Pkt0Socket::CreateMockAgent(const std::string& guid)
 
 Pkt0Interface::Pkt0Interface(const std::string &name,
                              boost::asio::io_service *io) :
-    name_(name), tap_fd_(-1), input_(*io), read_buff_(NULL), pkt_handler_(NULL) {
+    name_(name), tap_fd_(-1), input_(*io), read_buff_(NULL), pkt_handler_(NULL),
+    rx_batch_size_(0), rx_socket_(false) {
     memset(mac_address_, 0, sizeof(mac_address_));
 }
 
@@ -52,6 +55,31 @@ Pkt0Interface::~Pkt0Interface() {
     if (read_buff_) {
         delete [] read_buff_;
     }
+    for (std::vector<uint8_t *>::iterator it = rx_buffs_.begin();
+         it != rx_buffs_.end(); ++it) {
+        delete [] *it;
+    }
+}
+
+// Batched receive waits for the descriptor to be readable and then drains
+// upto rx_batch_size_ packets with non-blocking reads. Buffers come from the
+// PacketBufferManager rx pool and are recycled once the packets are freed
+void Pkt0Interface::InitRxBatch() {
+    rx_batch_size_ = pkt_handler()->agent()->params()->pkt0_rx_batch_size();
+    if (rx_batch_size_ > kMaxRxBatchSize) {
+        rx_batch_size_ = kMaxRxBatchSize;
+    }
+    if (rx_batch_size_ <= 1) {
+        rx_batch_size_ = 0;
+        return;
+    }
+
+    rx_buffs_.resize(rx_batch_size_, NULL);
+    rx_lens_.resize(rx_batch_size_, 0);
+
+    boost::system::error_code ec;
+    input_.non_blocking(true, ec);
+    assert(ec == 0);
 }
 
 void Pkt0Interface::IoShutdownControlInterface() {
@@ -74,6 +102,14 @@ void Pkt0Interface::WriteHandler(const boost::system::error_code &error,
 
 
 void Pkt0Interface::AsyncRead() {
+    if (rx_batch_size_) {
+        input_.async_read_some(
+                boost::asio::null_buffers(),
+                boost::bind(&Pkt0Interface::BatchReadHandler, this,
+                            boost::asio::placeholders::error));
+        return;
+    }
+
     read_buff_ = new uint8_t[kMaxPacketSize];
     input_.async_read_some(
             boost::asio::buffer(read_buff_, kMaxPacketSize),
@@ -106,6 +142,36 @@ void Pkt0Interface::ReadHandler(const boost::system::error_code &error,
     AsyncRead();
 }
 
+void Pkt0Interface::BatchReadHandler(const boost::system::error_code &error) {
+    if (error) {
+        TAP_TRACE(Err,
+                  "Packet Tap Error <" + error.message() + "> reading packet");
+        if (error == boost::system::errc::operation_canceled) {
+            return;
+        }
+        AsyncRead();
+        return;
+    }
+
+    PacketBufferManager *mgr =
+        pkt_handler()->agent()->pkt()->packet_buffer_manager();
+    for (uint32_t i = 0; i < rx_batch_size_; i++) {
+        if (rx_buffs_[i] == NULL)
+            rx_buffs_[i] = mgr->AllocateRxBuffer();
+    }
+
+    uint32_t count = ReadBatchImpl();
+    for (uint32_t i = 0; i < count; i++) {
+        PacketBufferPtr pkt(mgr->AllocateRxPacket(PktHandler::RX_PACKET,
+                                                  rx_buffs_[i], rx_lens_[i],
+                                                  0));
+        rx_buffs_[i] = NULL;
+        VrouterControlInterface::Process(pkt);
+    }
+
+    AsyncRead();
+}
+
 int Pkt0Interface::Send(uint8_t *buff, uint16_t buff_len,
                         const PacketBufferPtr &pkt) {
     std::vector<boost::asio::const_buffer> buff_list;
@@ -120,6 +186,7 @@ int Pkt0Interface::Send(uint8_t *buff, uint16_t buff_len,
 Pkt0RawInterface::Pkt0RawInterface(const std::string &name,
                                    boost::asio::io_service *io) :
     Pkt0Interface(name, io) {
+    rx_socket_ = true;
 }
 
 Pkt0RawInterface::~Pkt0RawInterface() {
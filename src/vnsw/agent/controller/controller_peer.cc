@@ -329,22 +329,15 @@ void AgentXmppChannel::ReceiveEvpnUpdate(XmlPugi *pugi) {
         return;
     }
 
-    //Call Auto-generated Code to return struct
-    auto_ptr<AutogenProperty> xparser(new AutogenProperty());
-    if (EnetItemsType::XmlParseProperty(node, &xparser) == false) {
-        CONTROLLER_TRACE(Trace, GetBgpPeerName(), vrf_name,
-                         "Xml Parsing for evpn Failed");
-        return;
-    }
-
-    EnetItemsType *items;
-    EnetItemType *item;
-
-    items = (static_cast<EnetItemsType *>(xparser.get()));
-    std::vector<EnetItemType>::iterator iter;
-    for (vector<EnetItemType>::iterator iter =items->item.begin();
-         iter != items->item.end(); iter++) {
-        item = &*iter;
+    // Decode the items one at a time into the parse arena of the channel
+    EnetItemType *item = &evpn_item_;
+    for (node = node.child("item"); node; node = node.next_sibling("item")) {
+        item->Clear();
+        if (item->XmlParse(node) == false) {
+            CONTROLLER_TRACE(Trace, GetBgpPeerName(), vrf_name,
+                             "Xml Parsing for evpn Failed");
+            return;
+        }
 
         boost::system::error_code ec;
         MacAddress mac = MacAddress(item->entry.nlri.mac);
@@ -458,24 +451,16 @@ void AgentXmppChannel::ReceiveMulticastUpdate(XmlPugi *pugi) {
         }
     }
 
-    //Call Auto-generated Code to return struct
-    auto_ptr<AutogenProperty> xparser(new AutogenProperty());
-    if (McastItemsType::XmlParseProperty(node, &xparser) == false) {
-        CONTROLLER_TRACE(Trace, GetBgpPeerName(), vrf_name,
-                        "Xml Parsing for Multicast Message Failed");
-        return;
-    }
-
-    McastItemsType *items;
-    McastItemType *item;
-
-    items = (static_cast<McastItemsType *>(xparser.get()));
-    std::vector<McastItemType>::iterator items_iter;
+    // Decode the items one at a time into the parse arena of the channel
+    McastItemType *item = &mcast_item_;
     boost::system::error_code ec;
-    for (items_iter = items->item.begin(); items_iter != items->item.end();
-            items_iter++) {
-
-        item = &*items_iter;
+    for (node = node.child("item"); node; node = node.next_sibling("item")) {
+        item->Clear();
+        if (item->XmlParse(node) == false) {
+            CONTROLLER_TRACE(Trace, GetBgpPeerName(), vrf_name,
+                            "Xml Parsing for Multicast Message Failed");
+            return;
+        }
 
         IpAddress g_address = IpAddress::from_string(item->entry.nlri.group, ec);
         if (ec.value() != 0) {
@@ -492,11 +477,11 @@ void AgentXmppChannel::ReceiveMulticastUpdate(XmlPugi *pugi) {
         }
 
         TunnelOlist olist;
-        std::vector<McastNextHopType>::iterator iter;
+        std::vector<McastNextHopType>::const_iterator iter;
         for (iter = item->entry.olist.next_hop.begin();
                 iter != item->entry.olist.next_hop.end(); iter++) {
 
-            McastNextHopType nh = *iter;
+            const McastNextHopType &nh = *iter;
             IpAddress addr = IpAddress::from_string(nh.address, ec);
             if (ec.value() != 0) {
                 CONTROLLER_TRACE(Trace, GetBgpPeerName(), vrf_name,
@@ -504,9 +489,7 @@ void AgentXmppChannel::ReceiveMulticastUpdate(XmlPugi *pugi) {
                 return;
             }
 
-            int label;
-            stringstream nh_label(nh.label);
-            nh_label >> label;
+            int label = strtoul(nh.label.c_str(), NULL, 10);
             TunnelType::TypeBmap encap = agent_->controller()->
                 GetTypeBitmap(nh.tunnel_encapsulation_list);
             olist.push_back(OlistTunnelEntry(boost::uuids::nil_uuid(), label,
@@ -723,21 +706,17 @@ void AgentXmppChannel::ReceiveV4V6Update(XmlPugi *pugi) {
             return;
         }
 
-        //Call Auto-generated Code to return struct
-        auto_ptr<AutogenProperty> xparser(new AutogenProperty());
-        if (ItemsType::XmlParseProperty(node, &xparser) == false) {
-            CONTROLLER_TRACE(Trace, GetBgpPeerName(), vrf_name,
-                             "Xml Parsing Failed");
-            return;
-        }
-        ItemsType *items;
-        ItemType *item;
-
-        items = (static_cast<ItemsType *>(xparser.get()));
-        for (vector<ItemType>::iterator iter =items->item.begin();
-                                        iter != items->item.end();
-                                        ++iter) {
-            item = &*iter;
+        // Decode the items one at a time into the parse arena of the
+        // channel, instead of building the list of all items in the message
+        ItemType *item = &unicast_item_;
+        for (node = node.child("item"); node;
+             node = node.next_sibling("item")) {
+            item->Clear();
+            if (item->XmlParse(node) == false) {
+                CONTROLLER_TRACE(Trace, GetBgpPeerName(), vrf_name,
+                                 "Xml Parsing Failed");
+                return;
+            }
             boost::system::error_code ec;
             int prefix_len;
 
@@ -833,21 +812,17 @@ void AgentXmppChannel::ReceiveInet4MplsUpdate(XmlPugi *pugi) {
             return;
         }
 
-        //Call Auto-generated Code to return struct
-        auto_ptr<AutogenProperty> xparser(new AutogenProperty());
-        if (ItemsType::XmlParseProperty(node, &xparser) == false) {
-            CONTROLLER_TRACE(Trace, GetBgpPeerName(), vrf_name,
-                             "Xml Parsing Failed");
-            return;
-        }
-        ItemsType *items;
-        ItemType *item;
-
-        items = (static_cast<ItemsType *>(xparser.get()));
-        for (vector<ItemType>::iterator iter =items->item.begin();
-                                        iter != items->item.end();
-                                        ++iter) {
-            item = &*iter;
+        // Decode the items one at a time into the parse arena of the
+        // channel, instead of building the list of all items in the message
+        ItemType *item = &unicast_item_;
+        for (node = node.child("item"); node;
+             node = node.next_sibling("item")) {
+            item->Clear();
+            if (item->XmlParse(node) == false) {
+                CONTROLLER_TRACE(Trace, GetBgpPeerName(), vrf_name,
+                                 "Xml Parsing Failed");
+                return;
+            }
             boost::system::error_code ec;
             int prefix_len;
 
@@ -16,6 +16,7 @@
 #include <oper/peer.h>
 #include <pugixml/pugixml.hpp>
 #include <xmpp_enet_types.h>
+#include <xmpp_multicast_types.h>
 #include <xmpp_unicast_types.h>
 #include <xmpp/xmpp_channel.h>
 
@@ -307,6 +308,12 @@ private:
     boost::scoped_ptr<EndOfRibRxTimer> end_of_rib_rx_timer_;
     boost::scoped_ptr<LlgrStaleTimer> llgr_stale_timer_;
     Agent *agent_;
+    // Parse arenas for the items of received route updates. Items are
+    // decoded one at a time and the arenas keep their buffers across
+    // messages, so routes are not decoded into freshly allocated structs.
+    autogen::ItemType unicast_item_;
+    autogen::EnetItemType evpn_item_;
+    autogen::McastItemType mcast_item_;
 };
 
 #endif // __CONTROLLER_PEER_H__
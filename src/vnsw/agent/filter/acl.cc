@@ -21,6 +21,7 @@
 #include <filter/acl_entry_match.h>
 #include <filter/acl_entry_spec.h>
 #include <filter/acl_entry.h>
+#include <filter/acl_classifier.h>
 
 #include <filter/acl.h>
 #include <cmn/agent_cmn.h>
@@ -116,6 +117,7 @@ DBEntry *AclTable::OperDBAdd(const DBRequest *req) {
          ++it) {
         acl->AddAclEntry(*it, acl->acl_entries_);
     }
+    acl->UpdateClassifier();
 
     AclSandeshData sandesh_data;
     acl->SetAclSandeshData(sandesh_data);
@@ -175,7 +177,9 @@ bool AclTable::OperDBOnChange(DBEntry *entry, const DBRequest *req) {
         }
     }
 
-    if (changed == false) {
+    if (changed) {
+        acl->UpdateClassifier();
+    } else {
         //Remove temporary create acl entries
         AclDBEntry::AclEntries::iterator iter;
         iter = entries.begin();
@@ -775,6 +779,7 @@ bool AclDBEntry::DeleteAclEntry(const uint32_t acl_entry_id)
             AclEntry *ae = iter.operator->();
             acl_entries_.erase(acl_entries_.iterator_to(*iter));
             ACL_TRACE(Info, "acl entry " + integerToString(acl_entry_id) + " deleted");
+            UpdateClassifier();
             delete ae;
             return true;
         }
@@ -785,6 +790,7 @@ bool AclDBEntry::DeleteAclEntry(const uint32_t acl_entry_id)
 
 void AclDBEntry::DeleteAllAclEntries()
 {
+    classifier_.reset();
     AclEntries::iterator iter;
     iter = acl_entries_.begin();
     while (iter != acl_entries_.end()) {
@@ -795,6 +801,108 @@ void AclDBEntry::DeleteAllAclEntries()
     return;
 }
 
+// Build classifier for large ACLs. Must be called whenever acl_entries_
+// is modified, since classifier holds pointers to the entries
+void AclDBEntry::UpdateClassifier() {
+    if (acl_entries_.size() < AclClassifier::kMinEntries) {
+        classifier_.reset();
+        return;
+    }
+
+    AclClassifier::EntryList list;
+    list.reserve(acl_entries_.size());
+    for (AclEntries::const_iterator it = acl_entries_.begin();
+         it != acl_entries_.end(); ++it) {
+        list.push_back(it.operator->());
+    }
+    if (classifier_.get() == NULL)
+        classifier_.reset(new AclClassifier());
+    classifier_->Build(list);
+}
+
+// Apply entry to the packet and update m_acl and info. Returns true if
+// entry is a terminal rule matching the packet
+bool AclDBEntry::ApplyAclEntry(const AclEntry &entry,
+                               const PacketHeader &packet_header,
+                               MatchAclParams &m_acl, FlowPolicyInfo *info,
+                               bool *ret_val) const {
+    /* Check  if packet and acl_entry address_family match */
+    if (entry.family() != Address::UNSPEC &&
+        packet_header.family != Address::UNSPEC &&
+        packet_header.family != entry.family()) {
+        return false;
+    }
+    const AclEntry::ActionList &al = entry.PacketMatch(packet_header, info);
+    AclEntry::ActionList::const_iterator al_it;
+    for (al_it = al.begin(); al_it != al.end(); ++al_it) {
+        TrafficAction *ta = static_cast<TrafficAction *>(*al_it.operator->());
+        m_acl.action_info.action |= 1 << ta->action();
+        if (ta->action_type() == TrafficAction::MIRROR_ACTION) {
+            MirrorAction *a = static_cast<MirrorAction *>(*al_it.operator->());
+            MirrorActionSpec as;
+            as.ip = a->GetIp();
+            as.port = a->GetPort();
+            as.vrf_name = a->vrf_name();
+            as.analyzer_name = a->GetAnalyzerName();
+            as.encap = a->GetEncap();
+            m_acl.action_info.mirror_l.push_back(as);
+        }
+        if (ta->action_type() == TrafficAction::VRF_TRANSLATE_ACTION) {
+            const VrfTranslateAction *a =
+                static_cast<VrfTranslateAction *>(*al_it.operator->());
+            VrfTranslateActionSpec vrf_translate_action(a->vrf_name(),
+                                                        a->ignore_acl());
+            m_acl.action_info.vrf_translate_action_ = vrf_translate_action;
+        }
+        if (ta->action_type() == TrafficAction::QOS_ACTION) {
+            const QosConfigAction *a =
+                static_cast<const QosConfigAction *>(*al_it.operator->());
+            if (a->qos_config_ref() != NULL) {
+                QosConfigActionSpec qos_action_spec(a->name());
+                if (a->qos_config_ref() &&
+                    a->qos_config_ref()->IsDeleted() == false) {
+                    qos_action_spec.set_id(a->qos_config_ref()->id());
+                    m_acl.action_info.qos_config_action_ = qos_action_spec;
+                }
+            }
+        }
+
+        if (info && ta->IsDrop()) {
+            if (!info->drop) {
+                info->drop = true;
+                info->terminal = false;
+                info->other = false;
+                info->uuid = entry.uuid();
+                info->acl_name = GetName();
+            }
+        }
+    }
+    if (!(al.empty())) {
+        *ret_val = true;
+        m_acl.ace_id_list.push_back(entry.id());
+        if (entry.IsTerminal()) {
+            m_acl.terminal_rule = true;
+            /* Set uuid only if it is NOT already set as
+             * drop/terminal uuid */
+            if (info && !info->drop && !info->terminal) {
+                info->terminal = true;
+                info->other = false;
+                info->uuid = entry.uuid();
+                info->acl_name = GetName();
+            }
+            return true;
+        }
+        /* If the ace action is not drop and if ace is not terminal rule
+         * then set the uuid with the first matching uuid */
+        if (info && !info->drop && !info->terminal && !info->other) {
+            info->other = true;
+            info->uuid = entry.uuid();
+            info->acl_name = GetName();
+        }
+    }
+    return false;
+}
+
 bool AclDBEntry::PacketMatch(const PacketHeader &packet_header,
                              MatchAclParams &m_acl, FlowPolicyInfo *info) const
 {
@@ -803,83 +911,23 @@ bool AclDBEntry::PacketMatch(const PacketHeader &packet_header,
     m_acl.terminal_rule = false;
     m_acl.action_info.action = 0;
 
+    // Classifier gives the entries that can match the packet in ACL order
+    if (classifier_.get() != NULL) {
+        AclClassifier::EntryList list;
+        classifier_->Lookup(packet_header, (info != NULL), &list);
+        for (AclClassifier::EntryList::const_iterator it = list.begin();
+             it != list.end(); ++it) {
+            if (ApplyAclEntry(**it, packet_header, m_acl, info, &ret_val))
+                return ret_val;
+        }
+        return ret_val;
+    }
+
     for (iter = acl_entries_.begin();
          iter != acl_entries_.end();
          ++iter) {
-        /* Check  if packet and acl_entry address_family match */
-        if (iter->family() != Address::UNSPEC &&
-            packet_header.family != Address::UNSPEC &&
-            packet_header.family != iter->family()) {
-            continue;
-        }
-        const AclEntry::ActionList &al = iter->PacketMatch(packet_header, info);
-    AclEntry::ActionList::const_iterator al_it;
-    for (al_it = al.begin(); al_it != al.end(); ++al_it) {
-         TrafficAction *ta = static_cast<TrafficAction *>(*al_it.operator->());
-         m_acl.action_info.action |= 1 << ta->action();
-         if (ta->action_type() == TrafficAction::MIRROR_ACTION) {
-             MirrorAction *a = static_cast<MirrorAction *>(*al_it.operator->());
-                 MirrorActionSpec as;
-         as.ip = a->GetIp();
-         as.port = a->GetPort();
-                 as.vrf_name = a->vrf_name();
-                 as.analyzer_name = a->GetAnalyzerName();
-                 as.encap = a->GetEncap();
-                 m_acl.action_info.mirror_l.push_back(as);
-         }
-         if (ta->action_type() == TrafficAction::VRF_TRANSLATE_ACTION) {
-             const VrfTranslateAction *a =
-                 static_cast<VrfTranslateAction *>(*al_it.operator->());
-             VrfTranslateActionSpec vrf_translate_action(a->vrf_name(),
-                                                         a->ignore_acl());
-             m_acl.action_info.vrf_translate_action_ = vrf_translate_action;
-         }
-         if (ta->action_type() == TrafficAction::QOS_ACTION) {
-             const QosConfigAction *a =
-                 static_cast<const QosConfigAction *>(*al_it.operator->());
-             if (a->qos_config_ref() != NULL) {
-                 QosConfigActionSpec qos_action_spec(a->name());
-                 if (a->qos_config_ref() &&
-                     a->qos_config_ref()->IsDeleted() == false) {
-                     qos_action_spec.set_id(a->qos_config_ref()->id());
-                     m_acl.action_info.qos_config_action_ = qos_action_spec;
-                 }
-             }
-         }
-
-         if (info && ta->IsDrop()) {
-             if (!info->drop) {
-                 info->drop = true;
-                 info->terminal = false;
-                 info->other = false;
-                 info->uuid = iter->uuid();
-                 info->acl_name = GetName();
-             }
-         }
-    }
-        if (!(al.empty())) {
-            ret_val = true;
-            m_acl.ace_id_list.push_back(iter->id());
-            if (iter->IsTerminal()) {
-                m_acl.terminal_rule = true;
-                /* Set uuid only if it is NOT already set as
-                 * drop/terminal uuid */
-                if (info && !info->drop && !info->terminal) {
-                    info->terminal = true;
-                    info->other = false;
-                    info->uuid = iter->uuid();
-                    info->acl_name = GetName();
-                }
-                return ret_val;
-            }
-            /* If the ace action is not drop and if ace is not terminal rule
-             * then set the uuid with the first matching uuid */
-            if (info && !info->drop && !info->terminal && !info->other) {
-                info->other = true;
-                info->uuid = iter->uuid();
-                info->acl_name = GetName();
-            }
-        }
+        if (ApplyAclEntry(*iter, packet_header, m_acl, info, &ret_val))
+            return ret_val;
     }
     return ret_val;
 }
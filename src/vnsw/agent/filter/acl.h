@@ -8,6 +8,7 @@
 #include <boost/intrusive/list.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/intrusive_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <tbb/atomic.h>
 
 #include <oper/oper_db.h>
@@ -16,6 +17,7 @@
 #include <filter/acl_entry_spec.h>
 #include <filter/acl_entry.h>
 #include <filter/packet_header.h>
+#include <filter/acl_classifier.h>
 
 struct FlowKey;
 class VnEntry;
@@ -135,12 +137,19 @@ public:
     bool IsQosConfigResolved();
     bool Isresolved();
     const AclEntry* GetAclEntryAtIndex(uint32_t) const;
+    const AclClassifier *classifier() const { return classifier_.get(); }
+    void UpdateClassifier();
 private:
     friend class AclTable;
+    bool ApplyAclEntry(const AclEntry &entry,
+                       const PacketHeader &packet_header,
+                       MatchAclParams &m_acl, FlowPolicyInfo *info,
+                       bool *ret_val) const;
     boost::uuids::uuid uuid_;
     bool dynamic_acl_;
     std::string name_;
     AclEntries acl_entries_;
+    boost::scoped_ptr<AclClassifier> classifier_;
     DISALLOW_COPY_AND_ASSIGN(AclDBEntry);
 };
 
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2017 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <algorithm>
+#include <netinet/in.h>
+
+#include <filter/acl_entry_match.h>
+#include <filter/acl_entry.h>
+#include <filter/packet_header.h>
+#include <filter/acl_classifier.h>
+
+// Protocol and port values are 16 bit
+static const uint32_t kMaxValue = 0xFFFF;
+
+static void AddRanges(const RangeSList &slist,
+                      std::vector<std::pair<uint32_t, uint32_t> > *list) {
+    for (RangeSList::const_iterator it = slist.begin(); it != slist.end();
+         ++it) {
+        list->push_back(std::make_pair((uint32_t)it->min, (uint32_t)it->max));
+    }
+}
+
+AclClassifier::AclClassifier() : words_(0) {
+}
+
+AclClassifier::~AclClassifier() {
+}
+
+void AclClassifier::SetBit(Bitmap *bitmap, uint32_t index) {
+    (*bitmap)[index / 64] |= (1ULL << (index % 64));
+}
+
+// An entry with a range covering all values is same as an entry without
+// a match on the dimension. An entry with empty list never matches
+void AclClassifier::Dimension::Build(const std::vector<RangeList> &ranges,
+                                     uint32_t words) {
+    any_.assign(words, 0);
+    bounds_.clear();
+    intervals_.clear();
+
+    bounds_.push_back(0);
+    for (uint32_t i = 0; i < ranges.size(); i++) {
+        for (RangeList::const_iterator it = ranges[i].begin();
+             it != ranges[i].end(); ++it) {
+            if (it->first > it->second)
+                continue;
+            bounds_.push_back(it->first);
+            if (it->second < kMaxValue)
+                bounds_.push_back(it->second + 1);
+        }
+    }
+    std::sort(bounds_.begin(), bounds_.end());
+    bounds_.erase(std::unique(bounds_.begin(), bounds_.end()), bounds_.end());
+    intervals_.resize(bounds_.size());
+
+    for (uint32_t i = 0; i < ranges.size(); i++) {
+        for (RangeList::const_iterator it = ranges[i].begin();
+             it != ranges[i].end(); ++it) {
+            if (it->first > it->second)
+                continue;
+            if (it->first == 0 && it->second >= kMaxValue) {
+                SetBit(&any_, i);
+                continue;
+            }
+
+            size_t lo = std::lower_bound(bounds_.begin(), bounds_.end(),
+                                         it->first) - bounds_.begin();
+            size_t hi = bounds_.size();
+            if (it->second < kMaxValue) {
+                hi = std::lower_bound(bounds_.begin(), bounds_.end(),
+                                      it->second + 1) - bounds_.begin();
+            }
+            for (size_t k = lo; k < hi; k++) {
+                IndexList &list = intervals_[k];
+                if (list.empty() || list.back() != i)
+                    list.push_back(i);
+            }
+        }
+    }
+}
+
+void AclClassifier::Dimension::Lookup(uint32_t value, Bitmap *bitmap) const {
+    for (size_t i = 0; i < any_.size(); i++) {
+        (*bitmap)[i] |= any_[i];
+    }
+
+    size_t k = std::upper_bound(bounds_.begin(), bounds_.end(), value) -
+        bounds_.begin() - 1;
+    const IndexList &list = intervals_[k];
+    for (IndexList::const_iterator it = list.begin(); it != list.end(); ++it) {
+        SetBit(bitmap, *it);
+    }
+}
+
+void AclClassifier::Build(const EntryList &entries) {
+    entries_ = entries;
+    words_ = (entries_.size() + 63) / 64;
+    inet_.assign(words_, 0);
+    inet6_.assign(words_, 0);
+    policy_info_.assign(words_, 0);
+
+    std::vector<RangeList> protocols(entries_.size());
+    std::vector<RangeList> dst_ports(entries_.size());
+    for (uint32_t i = 0; i < entries_.size(); i++) {
+        const AclEntry *entry = entries_[i];
+        if (entry->family() == Address::UNSPEC ||
+            entry->family() == Address::INET) {
+            SetBit(&inet_, i);
+        }
+        if (entry->family() == Address::UNSPEC ||
+            entry->family() == Address::INET6) {
+            SetBit(&inet6_, i);
+        }
+
+        bool protocol_match = false;
+        bool dst_port_match = false;
+        for (uint32_t j = 0; j < entry->match_count(); j++) {
+            const AclEntryMatch *match = entry->Get(j);
+            switch (match->type()) {
+            case AclEntryMatch::PROTOCOL_MATCH:
+                protocol_match = true;
+                AddRanges(static_cast<const ProtocolMatch *>(match)->
+                          protocol_ranges(), &protocols[i]);
+                break;
+
+            case AclEntryMatch::DESTINATION_PORT_MATCH:
+                dst_port_match = true;
+                AddRanges(static_cast<const DstPortMatch *>(match)->
+                          port_ranges(), &dst_ports[i]);
+                break;
+
+            case AclEntryMatch::ADDRESS_MATCH:
+                if (static_cast<const AddressMatch *>(match)->addr_type() ==
+                    AddressMatch::NETWORK_ID) {
+                    SetBit(&policy_info_, i);
+                }
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        if (protocol_match == false)
+            protocols[i].push_back(std::make_pair(0U, kMaxValue));
+        if (dst_port_match == false)
+            dst_ports[i].push_back(std::make_pair(0U, kMaxValue));
+    }
+
+    protocol_.Build(protocols, words_);
+    dst_port_.Build(dst_ports, words_);
+}
+
+void AclClassifier::Lookup(const PacketHeader &packet_header, bool policy_info,
+                           EntryList *list) const {
+    Bitmap match(words_, 0);
+    protocol_.Lookup(packet_header.protocol, &match);
+
+    // Port match is ignored for protocols other than TCP and UDP
+    if (packet_header.protocol == IPPROTO_TCP ||
+        packet_header.protocol == IPPROTO_UDP) {
+        Bitmap port(words_, 0);
+        dst_port_.Lookup(packet_header.dst_port, &port);
+        for (uint32_t i = 0; i < words_; i++) {
+            match[i] &= port[i];
+        }
+    }
+
+    const Bitmap *family = NULL;
+    if (packet_header.family == Address::INET) {
+        family = &inet_;
+    } else if (packet_header.family == Address::INET6) {
+        family = &inet6_;
+    }
+
+    for (uint32_t i = 0; i < words_; i++) {
+        uint64_t bits = match[i];
+        if (policy_info)
+            bits |= policy_info_[i];
+        if (family)
+            bits &= (*family)[i];
+        while (bits) {
+            uint32_t bit = __builtin_ctzll(bits);
+            list->push_back(entries_[(i * 64) + bit]);
+            bits &= (bits - 1);
+        }
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2017 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef __AGENT_ACL_CLASSIFIER_H__
+#define __AGENT_ACL_CLASSIFIER_H__
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+#include <base/util.h>
+
+struct PacketHeader;
+class AclEntry;
+
+// Pre-compiled classifier for the entries of an ACL.
+//
+// AclDBEntry::PacketMatch evaluates every AclEntry in order. With thousands
+// of entries, most of them fail on protocol or destination port. The
+// classifier indexes the entries on address family, protocol and
+// destination port so that a lookup returns only the entries that can
+// match the packet. The returned entries are still evaluated in ACL order
+// with AclEntry::PacketMatch, so the result is same as the linear walk.
+//
+// Each dimension is split into elementary intervals at the range
+// boundaries of all entries. Every interval keeps the list of entries whose
+// ranges cover it, and entries without a match on the dimension are kept
+// in a bitmap. A lookup is a binary search per dimension followed by
+// intersection of the bitmaps.
+//
+// Match on address of type NETWORK_ID updates the matching VN in
+// FlowPolicyInfo even when the entry does not match. Such entries are
+// always returned when the caller wants FlowPolicyInfo, so that the
+// information is same as the linear walk.
+//
+// The classifier is rebuilt whenever entries of the ACL change, and is
+// read-only afterwards.
+class AclClassifier {
+public:
+    // Minimum number of entries in the ACL to build classifier
+    static const uint32_t kMinEntries = 32;
+
+    typedef std::vector<const AclEntry *> EntryList;
+
+    AclClassifier();
+    ~AclClassifier();
+
+    // Build the classifier for entries given in ACL order
+    void Build(const EntryList &entries);
+    // Get entries that can match the packet in ACL order. Entries not
+    // returned do not match the packet
+    void Lookup(const PacketHeader &packet_header, bool policy_info,
+                EntryList *list) const;
+    size_t size() const { return entries_.size(); }
+
+private:
+    typedef std::vector<uint64_t> Bitmap;
+    typedef std::vector<std::pair<uint32_t, uint32_t> > RangeList;
+    typedef std::vector<uint32_t> IndexList;
+
+    // Index of entries on one dimension of the packet header
+    class Dimension {
+    public:
+        Dimension() { }
+        // ranges[i] is the list of ranges for entry i. Entry with a range
+        // covering all values matches any value
+        void Build(const std::vector<RangeList> &ranges, uint32_t words);
+        // Add entries matching value to bitmap
+        void Lookup(uint32_t value, Bitmap *bitmap) const;
+    private:
+        Bitmap any_;
+        std::vector<uint32_t> bounds_;
+        std::vector<IndexList> intervals_;
+        DISALLOW_COPY_AND_ASSIGN(Dimension);
+    };
+
+    static void SetBit(Bitmap *bitmap, uint32_t index);
+
+    EntryList entries_;
+    uint32_t words_;
+    Dimension protocol_;
+    Dimension dst_port_;
+    Bitmap inet_;
+    Bitmap inet6_;
+    Bitmap policy_info_;
+    DISALLOW_COPY_AND_ASSIGN(AclClassifier);
+};
+
+#endif // __AGENT_ACL_CLASSIFIER_H__
@@ -54,6 +54,7 @@ public:
         }
         return Compare(rhs);
     }
+    Type type() const { return type_; }
 private:
     Type type_;
 };
@@ -97,6 +98,7 @@ public:
     virtual bool Compare(const AclEntryMatch &rhs) const;
     bool CheckPortRanges(const uint16_t min_port,
                        const uint16_t max_port) const;
+    const RangeSList &port_ranges() const { return port_ranges_; }
 protected:
     RangeSList port_ranges_;
 };
@@ -125,6 +127,7 @@ public:
                FlowPolicyInfo *info) const;
     void SetAclEntryMatchSandeshData(AclEntrySandeshData &data);
     virtual bool Compare(const AclEntryMatch &rhs) const;
+    const RangeSList &protocol_ranges() const { return protocol_ranges_; }
 
 private:
     RangeSList protocol_ranges_;
@@ -242,6 +245,7 @@ public:
     size_t ip_list_size() const {
         return ip_list_.size();
     }
+    AddressType addr_type() const { return addr_type_; }
 private:
     AddressType addr_type_;
     bool src_;
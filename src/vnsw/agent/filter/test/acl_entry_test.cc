@@ -11,6 +11,7 @@
 #include "filter/packet_header.h"
 #include "filter/traffic_action.h"
 #include "filter/acl.h"
+#include "filter/acl_classifier.h"
 #include "oper/mirror_table.h"
 
 void RouterIdDepInit(Agent *agent) {
@@ -599,6 +600,96 @@ TEST_F(AclEntryTest, BasicIntrospecSgAclEntry) {
 }
 
 
+// Classifier must return every entry matching the packet in ACL order
+TEST_F(AclEntryTest, Classifier) {
+    AclClassifier::EntryList entries;
+    for (uint32_t i = 0; i < 96; i++) {
+        AclEntrySpec ae_spec;
+        ae_spec.id = i;
+        if (i % 3 == 1) {
+            ae_spec.family = Address::INET;
+        } else if (i % 3 == 2) {
+            ae_spec.family = Address::INET6;
+        }
+
+        RangeSpec protocol;
+        if (i % 4 != 0) {
+            protocol.min = protocol.max = (i % 4 == 1) ? IPPROTO_TCP :
+                ((i % 4 == 2) ? IPPROTO_UDP : IPPROTO_ICMP);
+            ae_spec.protocol.push_back(protocol);
+        }
+
+        RangeSpec port;
+        if (i == 5) {
+            port.min = 0;
+            port.max = 65535;
+            ae_spec.dst_port.push_back(port);
+        } else if (i % 5 != 0) {
+            port.min = i * 10;
+            port.max = (i * 10) + ((i % 7) * 50);
+            ae_spec.dst_port.push_back(port);
+        }
+
+        ActionSpec action;
+        action.ta_type = TrafficAction::SIMPLE_ACTION;
+        action.simple_action = TrafficAction::PASS;
+        ae_spec.action_l.push_back(action);
+
+        AclEntry *entry = new AclEntry();
+        entry->PopulateAclEntry(ae_spec);
+        entries.push_back(entry);
+    }
+
+    AclClassifier classifier;
+    classifier.Build(entries);
+    EXPECT_EQ(entries.size(), classifier.size());
+
+    uint8_t protocols[] = {IPPROTO_ICMP, IPPROTO_TCP, IPPROTO_UDP, 50};
+    uint16_t ports[] = {0, 15, 100, 300, 455, 960, 65535};
+    Address::Family families[] = {Address::INET, Address::INET6};
+    for (uint32_t f = 0; f < 2; f++) {
+    for (uint32_t p = 0; p < sizeof(protocols) / sizeof(protocols[0]); p++) {
+    for (uint32_t d = 0; d < sizeof(ports) / sizeof(ports[0]); d++) {
+        PacketHeader packet;
+        packet.family = families[f];
+        packet.protocol = protocols[p];
+        packet.dst_port = ports[d];
+
+        AclClassifier::EntryList list;
+        classifier.Lookup(packet, false, &list);
+
+        uint32_t index = 0;
+        for (uint32_t i = 0; i < entries.size(); i++) {
+            const AclEntry *entry = entries[i];
+            if (entry->family() != Address::UNSPEC &&
+                entry->family() != packet.family) {
+                continue;
+            }
+            if (entry->PacketMatch(packet, NULL).empty())
+                continue;
+
+            // Entry must be present in list, after the previous match
+            while (index < list.size() && list[index] != entry)
+                index++;
+            EXPECT_LT(index, list.size());
+        }
+    }
+    }
+    }
+
+    // Only entries without protocol match can match protocol 50
+    PacketHeader packet;
+    packet.family = Address::INET;
+    packet.protocol = 50;
+    AclClassifier::EntryList list;
+    classifier.Lookup(packet, false, &list);
+    EXPECT_EQ(16U, list.size());
+
+    for (uint32_t i = 0; i < entries.size(); i++) {
+        delete entries[i];
+    }
+}
+
 } // namespace
 
 int main (int argc, char **argv) {
@@ -71,12 +71,13 @@ def print_flow_entry(entry):
 
 def print_flow_entry_map(flow_table):
     table_ptr = gdb.parse_and_eval('(FlowTable *)' + str(flow_table))
-    flow_map = StdMapPrinter('flow_entry_map_', table_ptr['flow_entry_map_'])
-    it = flow_map.children()
+    slots = StdVectorPrinter('slots_', table_ptr['flow_entry_map_']['slots_'])
+    it = slots.children()
     try:
         while (it):
-            entry = next(it)[1]
-            print_flow_entry(entry)
+            entry = next(it)[1]['flow']
+            if entry != 0:
+                print_flow_entry(entry)
     except StopIteration:
         pass
 
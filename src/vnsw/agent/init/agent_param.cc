@@ -601,6 +601,8 @@ void AgentParam::ParseDefaultSectionArguments
                           "DEFAULT.mirror_client_port");
     GetOptValue<uint32_t>(var_map, pkt0_tx_buffer_count_,
                           "DEFAULT.pkt0_tx_buffers");
+    GetOptValue<uint32_t>(var_map, pkt0_rx_batch_size_,
+                          "DEFAULT.pkt0_rx_batch_size");
     GetOptValue<bool>(var_map, measure_queue_delay_,
                       "DEFAULT.measure_queue_delay");
     GetOptValue<string>(var_map, tunnel_type_,
@@ -680,6 +682,8 @@ void AgentParam::ParseFlowArguments
                           "FLOWS.update_tokens");
     GetOptValue<bool>(var_map, flow_hash_excl_rid_,
                       "FLOWS.hash_exclude_router_id");
+    GetOptValue<bool>(var_map, flow_run_to_completion_,
+                      "FLOWS.run_to_completion");
     GetOptValue<uint16_t>(var_map, max_sessions_per_aggregate_,
                           "FLOWS.max_sessions_per_aggregate");
     GetOptValue<uint16_t>(var_map, max_aggregates_per_session_endpoint_,
@@ -1606,6 +1610,7 @@ void AgentParam::LogConfig() const {
     LOG(DEBUG, "Maximum session endpoints   : " << max_endpoints_per_session_msg_);
     LOG(DEBUG, "Fabric SNAT hash table size : " << fabric_snat_hash_table_size_);
     LOG(DEBUG, "Flow excluding Router ID in hash    :" << flow_hash_excl_rid_);
+    LOG(DEBUG, "Flow setup run-to-completion : " << flow_run_to_completion_);
 
     if (agent_mode_ == VROUTER_AGENT)
         LOG(DEBUG, "Agent Mode                  : Vrouter");
@@ -1718,6 +1723,7 @@ AgentParam::AgentParam(bool enable_flow_options,
         enable_service_options_(enable_service_options),
         agent_mode_(agent_mode), gateway_mode_(NONE), vhost_(),
         pkt0_tx_buffer_count_(Agent::kPkt0TxBufferCount),
+        pkt0_rx_batch_size_(Agent::kPkt0RxBatchSize),
         measure_queue_delay_(false),
         agent_name_(),
         eth_port_no_arp_(false), eth_port_encap_type_(),
@@ -1765,6 +1771,7 @@ AgentParam::AgentParam(bool enable_flow_options,
         flow_thread_count_(Agent::kDefaultFlowThreadCount),
         flow_trace_enable_(true),
         flow_hash_excl_rid_(false),
+        flow_run_to_completion_(false),
         flow_latency_limit_(Agent::kDefaultFlowLatencyLimit),
         max_sessions_per_aggregate_(Agent::kMaxSessions),
         max_aggregates_per_session_endpoint_(Agent::kMaxSessionAggs),
@@ -1804,6 +1811,7 @@ AgentParam::AgentParam(bool enable_flow_options,
         loopback_ip_(), gateway_list_(AddressList(1, Ip4Address(0))) {
 
     uint32_t default_pkt0_tx_buffers = Agent::kPkt0TxBufferCount;
+    uint32_t default_pkt0_rx_batch_size = Agent::kPkt0RxBatchSize;
     uint32_t default_stale_interface_cleanup_timeout = Agent::kDefaultStaleInterfaceCleanupTimeout;
     uint32_t default_flow_update_tokens = Agent::kFlowUpdateTokens;
     uint32_t default_flow_del_tokens = Agent::kFlowDelTokens;
@@ -2115,6 +2123,8 @@ AgentParam::AgentParam(bool enable_flow_options,
          opt::bool_switch(&subnet_hosts_resolvable_)->default_value(true))
         ("DEFAULT.pkt0_tx_buffers", opt::value<uint32_t>()->default_value(default_pkt0_tx_buffers),
          "Number of tx-buffers for pkt0 interface")
+        ("DEFAULT.pkt0_rx_batch_size", opt::value<uint32_t>()->default_value(default_pkt0_rx_batch_size),
+         "Number of packets read from pkt0 interface per wakeup, 0 disables batching")
         ("DEFAULT.physical_interface_address",
           opt::value<string>()->default_value(""))
         ("DEFAULT.physical_interface_mac",
@@ -2225,6 +2235,10 @@ AgentParam::AgentParam(bool enable_flow_options,
              "Number of update-tokens")
             ("FLOWS.hash_exclude_router_id", opt::value<bool>(),
              "Exclude router-id in hash calculation")
+            ("FLOWS.run_to_completion", opt::value<bool>(),
+             "Parse and setup trapped flows in flow table task without "
+             "going through packet handler queue. Used only with vrouter "
+             "hash")
             ("FLOWS.index_sm_log_count", opt::value<uint16_t>()->default_value(Agent::kDefaultFlowIndexSmLogCount),
              "Index Sm Log Count")
             ("FLOWS.latency_limit", opt::value<uint16_t>()->default_value(Agent::kDefaultFlowLatencyLimit),
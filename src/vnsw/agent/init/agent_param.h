@@ -433,6 +433,11 @@ public:
 
     bool flow_use_rid_in_hash() const { return !flow_hash_excl_rid_; }
 
+    bool flow_run_to_completion() const { return flow_run_to_completion_; }
+    void set_flow_run_to_completion(bool val) {
+        flow_run_to_completion_ = val;
+    }
+
     uint16_t flow_task_latency_limit() const { return flow_latency_limit_; }
     void set_flow_task_latency_limit(uint16_t count) {
         flow_latency_limit_ = count;
@@ -505,6 +510,9 @@ public:
     // pkt0 tx buffer
     uint32_t pkt0_tx_buffer_count() const { return pkt0_tx_buffer_count_; }
     void set_pkt0_tx_buffer_count(uint32_t val) { pkt0_tx_buffer_count_ = val; }
+    // pkt0 rx batch
+    uint32_t pkt0_rx_batch_size() const { return pkt0_rx_batch_size_; }
+    void set_pkt0_rx_batch_size(uint32_t val) { pkt0_rx_batch_size_ = val; }
     bool measure_queue_delay() const { return measure_queue_delay_; }
     void set_measure_queue_delay(bool val) { measure_queue_delay_ = val; }
     const std::set<uint16_t>& nic_queue_list() const {
@@ -695,6 +703,8 @@ private:
     PortInfo vhost_;
     // Number of tx-buffers on pkt0 device
     uint32_t pkt0_tx_buffer_count_;
+    // Number of packets read from pkt0 device per wakeup
+    uint32_t pkt0_rx_batch_size_;
     bool measure_queue_delay_;
 
     std::string agent_name_;
@@ -794,6 +804,7 @@ private:
     uint16_t flow_thread_count_;
     bool flow_trace_enable_;
     bool flow_hash_excl_rid_;
+    bool flow_run_to_completion_;
     uint16_t flow_latency_limit_;
     uint16_t max_sessions_per_aggregate_;
     uint16_t max_aggregates_per_session_endpoint_;
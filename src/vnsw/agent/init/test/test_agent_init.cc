@@ -101,6 +101,7 @@ TEST_F(AgentParamTest, Agent_Conf_file_1) {
     EXPECT_TRUE(param.flow_trace_enable());
     EXPECT_EQ(param.pkt0_tx_buffer_count(), 2000);
     EXPECT_EQ(param.pkt0_tx_buffer_count(), 2000);
+    EXPECT_EQ(param.pkt0_rx_batch_size(), 32);
     EXPECT_EQ(param.get_nic_queue(1), 1);
     EXPECT_EQ(param.get_nic_queue(3), 1);
     EXPECT_EQ(param.get_nic_queue(8), 2);
@@ -174,6 +175,8 @@ TEST_F(AgentParamTest, Agent_Conf_file_2) {
     EXPECT_EQ(param.mirror_client_port(), 8097);
     // Default value for pkt0_tx_buffer_count
     EXPECT_EQ(param.pkt0_tx_buffer_count(), 1000);
+    // Batched receive on pkt0 is disabled by default
+    EXPECT_EQ(param.pkt0_rx_batch_size(), 0);
     EXPECT_EQ(param.services_queue_limit(), 1024);
     EXPECT_TRUE(param.sandesh_config().disable_object_logs);
 
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2018 Juniper Networks, Inc. All rights reserved.
+ */
+#include "block_free_list.h"
+
+const uint32_t BlockFreeList::kMaxThreshold;
+
+BlockFreeList::BlockFreeList(const char *name, size_t block_size) :
+    name_(name), block_size_(block_size), free_list_() {
+    free_count_ = 0;
+    total_alloc_ = 0;
+    total_reuse_ = 0;
+}
+
+BlockFreeList::~BlockFreeList() {
+    void *ptr = NULL;
+    while (free_list_.try_pop(ptr)) {
+        ::operator delete(ptr);
+    }
+}
+
+void *BlockFreeList::Allocate(size_t size) {
+    if (size > block_size_)
+        return ::operator new(size);
+
+    total_alloc_++;
+    void *ptr = NULL;
+    if (free_list_.try_pop(ptr)) {
+        free_count_--;
+        total_reuse_++;
+        return ptr;
+    }
+    return ::operator new(block_size_);
+}
+
+void BlockFreeList::Free(void *ptr, size_t size) {
+    if (ptr == NULL)
+        return;
+
+    if (size > block_size_) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    if (free_count_.fetch_and_increment() >= kMaxThreshold) {
+        free_count_--;
+        ::operator delete(ptr);
+        return;
+    }
+    free_list_.push(ptr);
+}
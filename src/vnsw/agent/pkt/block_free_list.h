@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2018 Juniper Networks, Inc. All rights reserved.
+ */
+#ifndef __AGENT_PKT_BLOCK_FREE_LIST_H__
+#define __AGENT_PKT_BLOCK_FREE_LIST_H__
+
+#include <stdint.h>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <tbb/atomic.h>
+#include <tbb/concurrent_queue.h>
+#include <base/util.h>
+
+////////////////////////////////////////////////////////////////////////////
+// Free-list of fixed size memory blocks
+// Per-flow objects (FlowEvent, PacketBuffer, nodes of per-flow trees) are
+// allocated and freed at flow setup rate, often in different tasks. The
+// free-list recycles memory of freed objects so that flow setup does not
+// hit malloc across the flow tasks.
+//
+// Since Allocate and Free happen from different tasks, blocks are kept in a
+// tbb::concurrent_queue. Number of blocks retained is limited to
+// kMaxThreshold. Objects larger than block_size are not pooled
+////////////////////////////////////////////////////////////////////////////
+class BlockFreeList {
+public:
+    static const uint32_t kMaxThreshold = (32 * 1000);
+
+    BlockFreeList(const char *name, size_t block_size);
+    virtual ~BlockFreeList();
+
+    void *Allocate(size_t size);
+    void Free(void *ptr, size_t size);
+
+    const char *name() const { return name_; }
+    size_t block_size() const { return block_size_; }
+    uint32_t free_count() const { return free_count_; }
+    uint64_t total_alloc() const { return total_alloc_; }
+    uint64_t total_reuse() const { return total_reuse_; }
+private:
+    typedef tbb::concurrent_queue<void *> FreeList;
+
+    const char *name_;
+    size_t block_size_;
+    FreeList free_list_;
+    tbb::atomic<uint32_t> free_count_;
+    tbb::atomic<uint64_t> total_alloc_;
+    tbb::atomic<uint64_t> total_reuse_;
+    DISALLOW_COPY_AND_ASSIGN(BlockFreeList);
+};
+
+////////////////////////////////////////////////////////////////////////////
+// Free-list identified by Tag, usually the class whose objects it holds.
+// The free-list is created on first call, with name and block_size passed
+// in that call.
+//
+// Per-flow objects can be freed while the process exits, after static
+// objects are destroyed. So, the free-list is never deleted
+////////////////////////////////////////////////////////////////////////////
+template <typename Tag>
+BlockFreeList *StaticBlockFreeList(const char *name, size_t block_size) {
+    static BlockFreeList *free_list = new BlockFreeList(name, block_size);
+    return free_list;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// STL allocator taking memory from a BlockFreeList
+// Pool is a class with a static method "BlockFreeList *free_list()". The
+// allocator is stateless, so that containers using it keep their interface.
+//
+// Node of a std::map holds the value along with rb-tree color and three
+// links. Use kMapNodeOverhead to size the free-list for map nodes
+////////////////////////////////////////////////////////////////////////////
+template <typename T, typename Pool>
+class BlockFreeListAllocator {
+public:
+    static const size_t kMapNodeOverhead = (4 * sizeof(void *));
+
+    typedef T value_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind {
+        typedef BlockFreeListAllocator<U, Pool> other;
+    };
+
+    BlockFreeListAllocator() { }
+    BlockFreeListAllocator(const BlockFreeListAllocator &) { }
+    template <typename U>
+    BlockFreeListAllocator(const BlockFreeListAllocator<U, Pool> &) { }
+
+    pointer address(reference x) const { return &x; }
+    const_pointer address(const_reference x) const { return &x; }
+
+    pointer allocate(size_type n, const void * = 0) {
+        void *ptr = Pool::free_list()->Allocate(n * sizeof(T));
+        return static_cast<pointer>(ptr);
+    }
+    void deallocate(pointer p, size_type n) {
+        Pool::free_list()->Free(p, n * sizeof(T));
+    }
+
+    size_type max_size() const {
+        return std::numeric_limits<size_type>::max() / sizeof(T);
+    }
+    void construct(pointer p, const T &val) { new(p) T(val); }
+    void destroy(pointer p) { p->~T(); }
+};
+
+template <typename T, typename U, typename Pool>
+inline bool operator==(const BlockFreeListAllocator<T, Pool> &,
+                       const BlockFreeListAllocator<U, Pool> &) {
+    return true;
+}
+
+template <typename T, typename U, typename Pool>
+inline bool operator!=(const BlockFreeListAllocator<T, Pool> &,
+                       const BlockFreeListAllocator<U, Pool> &) {
+    return false;
+}
+
+#endif // __AGENT_PKT_BLOCK_FREE_LIST_H__
@@ -579,10 +579,8 @@ void intrusive_ptr_release(FlowEntry *fe) {
                 proto->ForceEnqueueFreeFlowReference(ref);
                 return;
             }
-            FlowTable::FlowEntryMap::iterator it =
-                flow_table->flow_entry_map_.find(fe->key());
-            assert(it != flow_table->flow_entry_map_.end());
-            flow_table->flow_entry_map_.erase(it);
+            bool removed = flow_table->flow_entry_map_.Remove(fe);
+            assert(removed);
             flow_table->agent()->stats()->decr_flow_count();
         }
         flow_table->free_list()->Free(fe);
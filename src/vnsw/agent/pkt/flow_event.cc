@@ -14,6 +14,27 @@
 #include "flow_mgmt.h"
 #include "flow_event.h"
 
+//////////////////////////////////////////////////////////////////////////////
+// FlowEvent routines
+//////////////////////////////////////////////////////////////////////////////
+// Blocks are sized for FlowEventKSync, the most frequent derived event
+static BlockFreeList *GetFlowEventFreeList() {
+    return StaticBlockFreeList<FlowEvent>("FlowEvent",
+                                          sizeof(FlowEventKSync));
+}
+
+void *FlowEvent::operator new(size_t size) {
+    return GetFlowEventFreeList()->Allocate(size);
+}
+
+void FlowEvent::operator delete(void *ptr, size_t size) {
+    GetFlowEventFreeList()->Free(ptr, size);
+}
+
+const BlockFreeList *FlowEvent::free_list() {
+    return GetFlowEventFreeList();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // FlowEventQueue routines
 //////////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,7 @@
 #include <sys/resource.h>
 #include <ksync/ksync_entry.h>
 #include "flow_table.h"
+#include "block_free_list.h"
 
 class FlowTokenPool;
 
@@ -56,6 +57,10 @@ public:
         REENTRANT,
         // Need to resolve the Flow entry whic is depending on Mirror entry
         UNRESOLVED_FLOW_ENTRY,
+        // Flow trap from VRouter in run-to-completion mode. Packet is not
+        // parsed yet. Packet is parsed and flow is setup in the flow-table
+        // task itself
+        VROUTER_FLOW_TRAP,
     };
 
     FlowEvent() :
@@ -143,6 +148,11 @@ public:
     virtual ~FlowEvent() {
     }
 
+    // Memory for FlowEvent and derived classes is taken from free-list
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+    static const BlockFreeList *free_list();
+
     Event event() const { return event_; }
     FlowEntry *flow() const { return flow_.get(); }
     FlowEntryPtr &flow_ref() { return flow_; }
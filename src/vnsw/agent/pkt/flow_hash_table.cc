@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2016 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <boost/functional/hash.hpp>
+#include <pkt/flow_entry.h>
+#include <pkt/flow_hash_table.h>
+
+namespace {
+
+std::size_t HashIp(std::size_t hash, const IpAddress &ip) {
+    if (ip.is_v4()) {
+        boost::hash_combine(hash, ip.to_v4().to_ulong());
+    } else if (ip.is_v6()) {
+        Ip6Address::bytes_type bytes = ip.to_v6().to_bytes();
+        boost::hash_range(hash, bytes.begin(), bytes.end());
+    }
+    return hash;
+}
+
+// Slots are picked with the low order bits of the hash. Mix the bits so
+// that keys differing only in high order bits spread across the table.
+std::size_t Mix(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return static_cast<std::size_t>(hash);
+}
+
+}  // namespace
+
+FlowEntryHashTable::FlowEntryHashTable() :
+    slots_(kMinSlots), mask_(kMinSlots - 1), count_(0) {
+}
+
+FlowEntryHashTable::~FlowEntryHashTable() {
+    assert(count_ == 0);
+}
+
+std::size_t FlowEntryHashTable::Hash(const FlowKey &key) {
+    std::size_t hash = 0;
+    boost::hash_combine(hash, key.family);
+    boost::hash_combine(hash, key.nh);
+    hash = HashIp(hash, key.src_addr);
+    hash = HashIp(hash, key.dst_addr);
+    boost::hash_combine(hash, key.protocol);
+    boost::hash_combine(hash, key.src_port);
+    boost::hash_combine(hash, key.dst_port);
+    return Mix(hash);
+}
+
+// Returns index of slot holding the key, or the empty slot terminating the
+// probe sequence if key is not present
+size_t FlowEntryHashTable::FindSlot(const FlowKey &key, size_t hash) const {
+    size_t index = hash & mask_;
+    while (true) {
+        const Slot &slot = slots_[index];
+        if (slot.flow == NULL)
+            return index;
+        if (slot.hash == hash && slot.flow->key().IsEqual(key))
+            return index;
+        index = (index + 1) & mask_;
+    }
+}
+
+FlowEntry *FlowEntryHashTable::Find(const FlowKey &key) const {
+    return slots_[FindSlot(key, Hash(key))].flow;
+}
+
+void FlowEntryHashTable::InsertSlot(size_t hash, FlowEntry *flow) {
+    size_t index = hash & mask_;
+    while (slots_[index].flow != NULL) {
+        index = (index + 1) & mask_;
+    }
+    slots_[index].hash = hash;
+    slots_[index].flow = flow;
+}
+
+FlowEntry *FlowEntryHashTable::Insert(FlowEntry *flow, bool *inserted) {
+    size_t hash = Hash(flow->key());
+    size_t index = FindSlot(flow->key(), hash);
+    if (slots_[index].flow != NULL) {
+        *inserted = false;
+        return slots_[index].flow;
+    }
+
+    *inserted = true;
+    count_++;
+    if ((count_ * 100) > (slots_.size() * kMaxLoadPercent)) {
+        Resize(slots_.size() * 2);
+        InsertSlot(hash, flow);
+        return flow;
+    }
+    slots_[index].hash = hash;
+    slots_[index].flow = flow;
+    return flow;
+}
+
+// Backward-shift deletion. Move entries following the removed slot in the
+// probe sequence into the hole, unless the entry's home slot lies between
+// the hole and the entry
+void FlowEntryHashTable::RemoveSlot(size_t index) {
+    size_t hole = index;
+    size_t next = index;
+    while (true) {
+        next = (next + 1) & mask_;
+        Slot &slot = slots_[next];
+        if (slot.flow == NULL)
+            break;
+
+        size_t home = slot.hash & mask_;
+        bool in_place = (hole <= next) ? (hole < home && home <= next) :
+            (hole < home || home <= next);
+        if (in_place)
+            continue;
+
+        slots_[hole] = slot;
+        hole = next;
+    }
+    slots_[hole] = Slot();
+}
+
+bool FlowEntryHashTable::Remove(const FlowEntry *flow) {
+    size_t index = FindSlot(flow->key(), Hash(flow->key()));
+    if (slots_[index].flow != flow)
+        return false;
+
+    RemoveSlot(index);
+    count_--;
+    if (slots_.size() > kMinSlots &&
+        (count_ * 100) < (slots_.size() * kMinLoadPercent)) {
+        Resize(slots_.size() / 2);
+    }
+    return true;
+}
+
+void FlowEntryHashTable::Resize(size_t slot_count) {
+    SlotList slots(slot_count);
+    slots_.swap(slots);
+    mask_ = slot_count - 1;
+    for (SlotList::const_iterator it = slots.begin(); it != slots.end();
+         ++it) {
+        if (it->flow != NULL)
+            InsertSlot(it->hash, it->flow);
+    }
+}
+
+void FlowEntryHashTable::GetAll(FlowList *list) const {
+    list->reserve(list->size() + count_);
+    for (SlotList::const_iterator it = slots_.begin(); it != slots_.end();
+         ++it) {
+        if (it->flow != NULL)
+            list->push_back(it->flow);
+    }
+}
+
+void FlowEntryHashTable::GetNext(size_t *cursor, size_t count,
+                                 FlowList *list) const {
+    size_t index = *cursor;
+    while (index < slots_.size() && count > 0) {
+        FlowEntry *flow = slots_[index].flow;
+        if (flow != NULL) {
+            list->push_back(flow);
+            count--;
+        }
+        index++;
+    }
+    *cursor = index;
+}
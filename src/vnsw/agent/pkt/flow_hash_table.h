@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2016 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef __AGENT_PKT_FLOW_HASH_TABLE_H__
+#define __AGENT_PKT_FLOW_HASH_TABLE_H__
+
+#include <stdint.h>
+#include <vector>
+#include <base/util.h>
+
+struct FlowKey;
+class FlowEntry;
+
+/////////////////////////////////////////////////////////////////////////////
+// Index of flow-entries in a FlowTable keyed by FlowKey.
+//
+// The index is an open-addressed hash table with linear probing. Each slot
+// holds the hash of the key along with the flow-entry, so a probe sequence
+// is a walk over contiguous memory and the flow-entry is dereferenced only
+// when the hash matches. Entries are removed with backward-shift deletion,
+// hence there are no tombstones and lookups never degrade with churn.
+//
+// The table grows when load exceeds kMaxLoadPercent and shrinks when it
+// falls below kMinLoadPercent, but never below kMinSlots.
+//
+// The hash table does not maintain any order. Introspect pages through
+// flows in slot order with GetNext, resuming each page from the slot cursor
+// returned by the previous page. Cost of a page is proportional to the
+// slots walked and not to the size of the table. Flows added or removed
+// between pages, or a resize, can move flows across the cursor, so such
+// flows may be skipped or repeated in the pages that follow.
+//
+// The table is not thread-safe. All modifications are done in the context
+// of the FlowTable task, same as the std::map it replaces.
+/////////////////////////////////////////////////////////////////////////////
+class FlowEntryHashTable {
+public:
+    static const uint32_t kMinSlots = 1024;
+    static const uint32_t kMaxLoadPercent = 70;
+    static const uint32_t kMinLoadPercent = 10;
+
+    typedef std::vector<FlowEntry *> FlowList;
+
+    FlowEntryHashTable();
+    ~FlowEntryHashTable();
+
+    // Find flow-entry with given key. Returns NULL if not present
+    FlowEntry *Find(const FlowKey &key) const;
+    // Add flow to the table if there is no flow with same key. Returns the
+    // flow-entry present in the table for the key
+    FlowEntry *Insert(FlowEntry *flow, bool *inserted);
+    // Remove the flow from table. Returns false if flow is not in the table
+    bool Remove(const FlowEntry *flow);
+
+    // Get all flows in the table. Flows are not in any specific order
+    void GetAll(FlowList *list) const;
+    // Get upto count flows in slot order starting at slot given by cursor.
+    // cursor is updated to the slot to resume from in the next call and is
+    // set to slot_count() when there are no more flows
+    void GetNext(size_t *cursor, size_t count, FlowList *list) const;
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    size_t slot_count() const { return slots_.size(); }
+
+    static size_t Hash(const FlowKey &key);
+
+private:
+    struct Slot {
+        Slot() : hash(0), flow(NULL) { }
+        size_t hash;
+        FlowEntry *flow;
+    };
+    typedef std::vector<Slot> SlotList;
+
+    size_t FindSlot(const FlowKey &key, size_t hash) const;
+    void InsertSlot(size_t hash, FlowEntry *flow);
+    void RemoveSlot(size_t index);
+    void Resize(size_t slot_count);
+
+    SlotList slots_;
+    size_t mask_;
+    size_t count_;
+    DISALLOW_COPY_AND_ASSIGN(FlowEntryHashTable);
+};
+
+#endif //  __AGENT_PKT_FLOW_HASH_TABLE_H__
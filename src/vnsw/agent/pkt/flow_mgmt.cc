@@ -15,6 +15,23 @@
 #include "vrouter/flow_stats/flow_stats_collector.h"
 
 FlowMgmtManager::FlowMgmtQueue *FlowMgmtManager::log_queue_;
+
+static BlockFreeList *GetFlowMgmtRequestFreeList() {
+    return StaticBlockFreeList<FlowMgmtRequest>("FlowMgmtRequest",
+                                                sizeof(FlowMgmtRequest));
+}
+
+void *FlowMgmtRequest::operator new(size_t size) {
+    return GetFlowMgmtRequestFreeList()->Allocate(size);
+}
+
+void FlowMgmtRequest::operator delete(void *ptr, size_t size) {
+    GetFlowMgmtRequestFreeList()->Free(ptr, size);
+}
+
+const BlockFreeList *FlowMgmtRequest::free_list() {
+    return GetFlowMgmtRequestFreeList();
+}
 /////////////////////////////////////////////////////////////////////////////
 // FlowMgmtManager methods
 /////////////////////////////////////////////////////////////////////////////
@@ -69,6 +69,13 @@ public:
 
     virtual ~FlowMgmtRequest() { }
 
+    // A FlowMgmtRequest is allocated for every flow add/change/delete.
+    // Memory for FlowMgmtRequest is taken from free-list. Requests of
+    // derived classes are larger than the block and are not pooled
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+    static const BlockFreeList *free_list();
+
     // At the end of Flow Management Request, we may enqueue a response message
     // back to FlowTable module. Compute the message type to be enqueued in
     // response. Returns INVALID if no message to be enqueued
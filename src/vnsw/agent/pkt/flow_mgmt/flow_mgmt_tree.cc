@@ -8,6 +8,12 @@
 #include <pkt/flow_mgmt/flow_mgmt_request.h>
 #include <pkt/flow_mgmt.h>
 
+BlockFreeList *FlowMgmtKeyTreePool::free_list() {
+    return StaticBlockFreeList<FlowMgmtKeyTreePool>("FlowMgmtKeyTree",
+               sizeof(FlowMgmtKeyTree::value_type) +
+               FlowMgmtKeyTreeAllocator::kMapNodeOverhead);
+}
+
 FlowMgmtEntry *FlowMgmtTree::Find(FlowMgmtKey *key) {
     Tree::iterator it = tree_.find(key);
     if (it == tree_.end())
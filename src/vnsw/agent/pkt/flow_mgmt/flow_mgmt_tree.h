@@ -7,6 +7,7 @@
 
 #include <cstdlib>
 #include <map>
+#include <pkt/block_free_list.h>
 #include <pkt/flow_mgmt/flow_mgmt_key.h>
 
 class FlowMgmtKeyNode;
@@ -14,7 +15,16 @@ class FlowMgmtEntry;
 
 class BgpAsAServiceFlowMgmtRequest;
 
-typedef std::map<FlowMgmtKey *, FlowMgmtKeyNode *, FlowMgmtKeyCmp> FlowMgmtKeyTree;
+// A FlowMgmtKeyTree is built for every flow add/change, and one is retained
+// per flow in FlowEntryInfo. Nodes of the tree are taken from a free-list
+struct FlowMgmtKeyTreePool {
+    static BlockFreeList *free_list();
+};
+typedef BlockFreeListAllocator<
+    std::pair<FlowMgmtKey *const, FlowMgmtKeyNode *>, FlowMgmtKeyTreePool>
+    FlowMgmtKeyTreeAllocator;
+typedef std::map<FlowMgmtKey *, FlowMgmtKeyNode *, FlowMgmtKeyCmp,
+                 FlowMgmtKeyTreeAllocator> FlowMgmtKeyTree;
 
 class FlowMgmtTree {
 public:
@@ -227,6 +227,25 @@ bool FlowProto::Enqueue(PktInfoPtr msg) {
     return true;
 }
 
+// Flow traps are set up in run-to-completion mode only when flow-table is
+// picked from the flow-handle (vrouter hash). Otherwise the flow-table is
+// picked from hash of the flow-key, which is known only after the packet is
+// parsed, and most of the traps would need another hop to the right table
+bool FlowProto::FlowTrapRunToCompletion() const {
+    return use_vrouter_hash_ && agent_->params()->flow_run_to_completion();
+}
+
+// Run-to-completion mode. Packet is not parsed yet, pick flow-table from the
+// flow-handle. The flow-table task parses the packet and sets up the flow
+void FlowProto::EnqueueFlowTrap(const AgentHdr &hdr,
+                                const PacketBufferPtr &buff) {
+    PktInfoPtr msg(new PktInfo(buff, hdr));
+    uint32_t count = flow_table_list_.size();
+    uint32_t index = (hdr.cmd_param / count) % count;
+    EnqueueFlowEvent(new FlowEvent(FlowEvent::VROUTER_FLOW_TRAP, msg, NULL,
+                                   index));
+}
+
 void FlowProto::DisableFlowEventQueue(uint32_t index, bool disabled) {
     flow_event_queue_[index]->set_disable(disabled);
     flow_tokenless_queue_[index]->set_disable(disabled);
@@ -360,6 +379,7 @@ void FlowProto::EnqueueFlowEvent(FlowEvent *event) {
         break;
     }
 
+    case FlowEvent::VROUTER_FLOW_TRAP:
     case FlowEvent::REENTRANT: {
         queue = flow_event_queue_[event->table_index()];
         break;
@@ -408,6 +428,34 @@ bool FlowProto::FlowEventHandler(FlowEvent *req, FlowTable *table) {
         break;
     }
 
+    case FlowEvent::VROUTER_FLOW_TRAP: {
+        PktInfoPtr info = req->pkt_info();
+        PktHandler *pkt_handler = agent_->pkt()->pkt_handler();
+        if (pkt_handler->ProcessFlowTrap(info) == false)
+            break;
+
+        if (Validate(info.get()) == false)
+            break;
+
+        FreeBuffer(info.get());
+        uint32_t index = FlowTableIndex(info->ip_saddr, info->ip_daddr,
+                                        info->ip_proto, info->sport,
+                                        info->dport,
+                                        info->agent_hdr.cmd_param);
+        stats_.add_count_++;
+        // Table differs only if vrouter hash was turned off after the trap
+        // was enqueued. Packet is parsed already, move it to the right table
+        if (index != table->table_index()) {
+            EnqueueReentrant(info, index);
+            break;
+        }
+
+        FlowHandler *handler = new FlowHandler(agent(), info, io_, this,
+                                               table->table_index());
+        RunProtoHandler(handler);
+        break;
+    }
+
     case FlowEvent::REENTRANT: {
         FlowHandler *handler = new FlowHandler(agent(), req->pkt_info(), io_,
                                                this, table->table_index());
@@ -714,6 +762,7 @@ bool FlowProto::ShouldTrace(const FlowEntry *flow, const FlowEntry *rflow) {
 TokenPtr FlowProto::GetToken(FlowEvent::Event event) {
     switch (event) {
     case FlowEvent::VROUTER_FLOW_MSG:
+    case FlowEvent::VROUTER_FLOW_TRAP:
     case FlowEvent::AUDIT_FLOW:
     case FlowEvent::REENTRANT:
         return add_tokens_.GetToken(NULL);
@@ -60,6 +60,8 @@ public:
     FlowHandler *AllocProtoHandler(PktInfoPtr info,
                                    boost::asio::io_service &io);
     bool Enqueue(PktInfoPtr msg);
+    bool FlowTrapRunToCompletion() const;
+    void EnqueueFlowTrap(const AgentHdr &hdr, const PacketBufferPtr &buff);
 
     FlowEntry *Find(const FlowKey &key, uint32_t table_index) const;
     uint16_t FlowTableIndex(const IpAddress &sip, const IpAddress &dip,
@@ -126,6 +128,7 @@ public:
     PortTableManager* port_table_manager() {
         return &port_table_manager_;
     }
+    void set_use_vrouter_hash(bool val) { use_vrouter_hash_ = val; }
 
 private:
     friend class SandeshIPv4FlowFilterRequest;
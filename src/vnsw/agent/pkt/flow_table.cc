@@ -70,7 +70,7 @@ FlowTable::FlowTable(Agent *agent, uint16_t table_index) :
 }
 
 FlowTable::~FlowTable() {
-    assert(flow_entry_map_.size() == 0);
+    assert(flow_entry_map_.empty());
 }
 
 void FlowTable::Init() {
@@ -135,14 +135,7 @@ void FlowTable::GetMutexSeq(tbb::mutex &mutex1, tbb::mutex &mutex2,
 
 FlowEntry *FlowTable::Find(const FlowKey &key) {
     assert(ConcurrencyCheck(flow_task_id_) == true);
-    FlowEntryMap::iterator it;
-
-    it = flow_entry_map_.find(key);
-    if (it != flow_entry_map_.end()) {
-        return it->second;
-    } else {
-        return NULL;
-    }
+    return flow_entry_map_.Find(key);
 }
 
 void FlowTable::Copy(FlowEntry *lhs, FlowEntry *rhs, bool update) {
@@ -161,15 +154,14 @@ void FlowTable::Copy(FlowEntry *lhs, FlowEntry *rhs, bool update) {
 
 FlowEntry *FlowTable::Locate(FlowEntry *flow, uint64_t time) {
     assert(ConcurrencyCheck(flow_task_id_) == true);
-    std::pair<FlowEntryMap::iterator, bool> ret;
-    ret = flow_entry_map_.insert(FlowEntryMapPair(flow->key(), flow));
-    if (ret.second == true) {
+    bool inserted = false;
+    FlowEntry *ret = flow_entry_map_.Insert(flow, &inserted);
+    if (inserted == true) {
         agent_->stats()->incr_flow_created();
-        ret.first->second->set_on_tree();
-        return flow;
+        ret->set_on_tree();
     }
 
-    return ret.first->second;
+    return ret;
 }
 
 void FlowTable::Add(FlowEntry *flow, FlowEntry *rflow) {
@@ -426,18 +418,24 @@ bool FlowTable::Delete(const FlowKey &key, bool del_reverse_flow) {
     return DeleteUnLocked(del_reverse_flow, flow, rflow);
 }
 
+// Deleting a flow can release the last reference and remove it from the
+// hash table. Take a snapshot with references held before deleting.
 void FlowTable::DeleteAll() {
-    FlowEntryMap::iterator it;
+    FlowList list;
+    flow_entry_map_.GetAll(&list);
+    std::vector<FlowEntryPtr> flows(list.begin(), list.end());
 
-    it = flow_entry_map_.begin();
-    while (it != flow_entry_map_.end()) {
-        FlowEntry *entry = it->second;
-        FlowEntry *reverse_entry = NULL;
+    std::vector<FlowEntryPtr>::iterator it = flows.begin();
+    while (it != flows.end()) {
+        FlowEntry *entry = it->get();
         ++it;
-        if (it != flow_entry_map_.end() &&
-            it->second == entry->reverse_flow_entry()) {
-            reverse_entry = it->second;
-            ++it;
+        if (entry->deleted())
+            continue;
+
+        FlowEntry *reverse_entry = entry->reverse_flow_entry();
+        if (reverse_entry == entry ||
+            (reverse_entry && reverse_entry->flow_table() != this)) {
+            reverse_entry = NULL;
         }
         FLOW_LOCK(entry, reverse_entry, FlowEvent::DELETE_FLOW);
         DeleteUnLocked(true, entry, reverse_entry);
@@ -37,6 +37,7 @@
 #include <pkt/pkt_init.h>
 #include <pkt/pkt_flow_info.h>
 #include <pkt/flow_entry.h>
+#include <pkt/flow_hash_table.h>
 #include <sandesh/sandesh_trace.h>
 #include <oper/vn.h>
 #include <oper/vm.h>
@@ -154,8 +155,8 @@ public:
     static const uint32_t kPortNatFlowTableInstance = 0;
     static const uint32_t kInvalidFlowTableInstance = 0xFF;
 
-    typedef std::map<FlowKey, FlowEntry *, Inet4FlowKeyCmp> FlowEntryMap;
-    typedef std::pair<FlowKey, FlowEntry *> FlowEntryMapPair;
+    typedef FlowEntryHashTable FlowEntryMap;
+    typedef FlowEntryHashTable::FlowList FlowList;
     typedef boost::function<bool(FlowEntry *flow)> FlowEntryCb;
     typedef std::vector<FlowEntryPtr> FlowIndexTree;
 
@@ -197,11 +198,9 @@ public:
     Agent *agent() const { return agent_; }
     uint16_t table_index() const { return table_index_; }
     size_t Size() { return flow_entry_map_.size(); }
-    FlowTable::FlowEntryMap::iterator begin() {
-        return flow_entry_map_.begin();
-    }
-    FlowTable::FlowEntryMap::iterator end() {
-        return flow_entry_map_.end();
+    // Get upto count flows starting at slot cursor. See FlowEntryHashTable
+    void GetNextFlows(size_t *cursor, size_t count, FlowList *list) const {
+        flow_entry_map_.GetNext(cursor, count, list);
     }
 
     const LinkLocalFlowInfoMap &linklocal_flow_info_map() {
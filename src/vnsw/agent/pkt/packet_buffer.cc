@@ -3,14 +3,39 @@
  */
 #include <string>
 #include <boost/shared_ptr.hpp>
+#include <boost/static_assert.hpp>
+#include <pkt/block_free_list.h>
 #include <pkt/packet_buffer.h>
 #include <pkt/control_interface.h>
 
+BOOST_STATIC_ASSERT(PacketBufferManager::kRxBufferSize ==
+                    ControlInterface::kMaxPacketSize);
+
+namespace {
+
+// Deleter for shared_array returning rx buffer to the manager
+struct RxBufferDeleter {
+    explicit RxBufferDeleter(PacketBufferManager *mgr) : mgr_(mgr) { }
+    void operator()(uint8_t *buff) const { mgr_->FreeRxBuffer(buff); }
+    PacketBufferManager *mgr_;
+};
+
+BlockFreeList *GetPacketBufferFreeList() {
+    return StaticBlockFreeList<PacketBuffer>("PacketBuffer",
+                                             sizeof(PacketBuffer));
+}
+
+}  // namespace
+
 PacketBufferManager::PacketBufferManager(PktModule *pkt_module) :
-    alloc_(0), free_(0), pkt_module_(pkt_module) {
+    alloc_(0), free_(0), pkt_module_(pkt_module), rx_buffer_alloc_(0) {
 }
 
 PacketBufferManager::~PacketBufferManager() {
+    for (std::vector<uint8_t *>::iterator it = rx_buffer_pool_.begin();
+         it != rx_buffer_pool_.end(); ++it) {
+        delete [] *it;
+    }
 }
 
 PacketBufferPtr PacketBufferManager::Allocate(uint32_t module, uint16_t len,
@@ -35,6 +60,40 @@ void PacketBufferManager::FreeIndication(PacketBuffer *pkt) {
     free_++;
 }
 
+uint8_t *PacketBufferManager::AllocateRxBuffer() {
+    {
+        tbb::mutex::scoped_lock lock(rx_buffer_mutex_);
+        if (rx_buffer_pool_.empty() == false) {
+            uint8_t *buff = rx_buffer_pool_.back();
+            rx_buffer_pool_.pop_back();
+            return buff;
+        }
+        rx_buffer_alloc_++;
+    }
+    return new uint8_t[kRxBufferSize];
+}
+
+void PacketBufferManager::FreeRxBuffer(uint8_t *buff) {
+    {
+        tbb::mutex::scoped_lock lock(rx_buffer_mutex_);
+        if (rx_buffer_pool_.size() < kMaxRxBufferPool) {
+            rx_buffer_pool_.push_back(buff);
+            return;
+        }
+    }
+    delete [] buff;
+}
+
+PacketBufferPtr PacketBufferManager::AllocateRxPacket(uint32_t module,
+                                                      uint8_t *buff,
+                                                      uint16_t data_len,
+                                                      uint32_t mdata) {
+    PacketBufferPtr ptr(new PacketBuffer(this, module, buff, data_len,
+                                         mdata));
+    alloc_++;
+    return ptr;
+}
+
 PacketBuffer::PacketBuffer(PacketBufferManager *mgr, uint32_t module,
                            uint16_t len, uint32_t mdata) :
     buffer_(new uint8_t[len]), buffer_len_(len), data_(buffer_.get()),
@@ -48,6 +107,25 @@ PacketBuffer::PacketBuffer(PacketBufferManager *mgr, uint32_t module,
     data_len_(data_len), module_(module), mdata_(mdata), mgr_(mgr) {
 }
 
+PacketBuffer::PacketBuffer(PacketBufferManager *mgr, uint32_t module,
+                           uint8_t *buff, uint16_t data_len, uint32_t mdata) :
+    buffer_(buff, RxBufferDeleter(mgr)),
+    buffer_len_(PacketBufferManager::kRxBufferSize), data_(buffer_.get()),
+    data_len_(data_len), module_(module), mdata_(mdata), mgr_(mgr) {
+}
+
+void *PacketBuffer::operator new(size_t size) {
+    return GetPacketBufferFreeList()->Allocate(size);
+}
+
+void PacketBuffer::operator delete(void *ptr, size_t size) {
+    GetPacketBufferFreeList()->Free(ptr, size);
+}
+
+const BlockFreeList *PacketBuffer::free_list() {
+    return GetPacketBufferFreeList();
+}
+
 PacketBuffer::~PacketBuffer() {
     mgr_->FreeIndication(this);
     data_ = NULL;
@@ -8,9 +8,12 @@
 #include <string>
 #include <stdint.h>
 #include <boost/shared_ptr.hpp>
+#include <vector>
 #include <boost/shared_array.hpp>
+#include <tbb/mutex.h>
 #include <base/util.h>
 
+class BlockFreeList;
 class PacketBuffer;
 class PacketBufferManager;
 struct AgentHdr;
@@ -23,6 +26,12 @@ public:
     static const uint32_t kDefaultBufferLen = 1024;
     virtual ~PacketBuffer();
 
+    // A PacketBuffer is allocated for every packet trapped. Memory for
+    // PacketBuffer is taken from free-list
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+    static const BlockFreeList *free_list();
+
     uint8_t *buffer() const { return buffer_.get(); }
     uint16_t buffer_len() const { return buffer_len_; }
 
@@ -44,6 +53,11 @@ private:
                  uint16_t len, uint16_t data_offset, uint16_t data_len,
                  uint32_t mdata);
 
+    // Create PacketBuffer from memory got with AllocateRxBuffer. Memory is
+    // returned to the manager when the buffer is freed
+    PacketBuffer(PacketBufferManager *mgr, uint32_t module, uint8_t *buff,
+                 uint16_t data_len, uint32_t mdata);
+
     boost::shared_array<uint8_t> buffer_;
     uint16_t buffer_len_;
 
@@ -58,6 +72,12 @@ private:
 
 class PacketBufferManager {
 public:
+    // Size of buffers used to receive packets. Matches the max packet size
+    // on control interface
+    static const uint16_t kRxBufferSize = 9060;
+    // Max number of free rx buffers retained for reuse
+    static const uint32_t kMaxRxBufferPool = 1024;
+
     PacketBufferManager(PktModule *pkt_module);
     virtual ~PacketBufferManager();
 
@@ -66,6 +86,17 @@ public:
     PacketBufferPtr Allocate(uint32_t module, uint8_t *buff, uint16_t len,
                              uint16_t data_offset, uint16_t data_len,
                              uint32_t mdata);
+
+    // Rx buffers of kRxBufferSize bytes. Batched receive paths allocate
+    // buffers here and wrap them with AllocateRxPacket. The memory is put
+    // back in a pool when the packet is freed, avoiding allocation of large
+    // buffers per packet received
+    uint8_t *AllocateRxBuffer();
+    void FreeRxBuffer(uint8_t *buff);
+    PacketBufferPtr AllocateRxPacket(uint32_t module, uint8_t *buff,
+                                     uint16_t data_len, uint32_t mdata);
+    uint32_t rx_buffer_pool_size() const { return rx_buffer_pool_.size(); }
+    uint64_t rx_buffer_alloc() const { return rx_buffer_alloc_; }
 private:
     friend class PacketBuffer;
     void FreeIndication(PacketBuffer *);
@@ -74,6 +105,12 @@ private:
     uint64_t free_;
     PktModule *pkt_module_;
 
+    // Packets are freed from multiple tasks, hence the pool is protected
+    // by mutex
+    tbb::mutex rx_buffer_mutex_;
+    std::vector<uint8_t *> rx_buffer_pool_;
+    uint64_t rx_buffer_alloc_;
+
     DISALLOW_COPY_AND_ASSIGN(PacketBufferManager);
 };
 
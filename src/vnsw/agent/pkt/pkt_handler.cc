@@ -20,6 +20,7 @@
 #include "oper/vrf.h"
 #include "oper/tunnel_nh.h"
 #include "pkt/control_interface.h"
+#include "pkt/block_free_list.h"
 #include "pkt/pkt_handler.h"
 #include "pkt/proto.h"
 #include "pkt/flow_table.h"
@@ -411,6 +412,11 @@ void PktHandler::HandleRcvPkt(const AgentHdr &hdr, const PacketBufferPtr &buff){
     // so that its job run without dependence on dB tasks
     if (IsBfdkeepalivePkt(hdr)) {
         work_queue_bfd_ka_.Enqueue(info);
+    } else if (IsFlowPacket(hdr) &&
+               agent_->pkt()->get_flow_proto()->FlowTrapRunToCompletion()) {
+        // In run-to-completion mode, flow traps bypass the work_queue_. The
+        // flow-table task parses the packet and sets up the flow
+        agent_->pkt()->get_flow_proto()->EnqueueFlowTrap(hdr, buff);
     } else {
         work_queue_.Enqueue(info);
     }
@@ -430,6 +436,33 @@ bool PktHandler::ProcessPacket(boost::shared_ptr<PacketBufferEnqueueItem> item)
 
     return true;
 }
+// Parse a flow trap in run-to-completion mode. Invoked from flow-table task,
+// which runs in exclusion with DB. Returns true if packet must be processed
+// by flow module. Other packets are given back to work_queue_ so that they
+// take the regular path.
+//
+// Flow module is not invoked with Enqueue in this mode, so packet trace is
+// added here
+bool PktHandler::ProcessFlowTrap(boost::shared_ptr<PktInfo> pkt_info) {
+    const AgentHdr hdr = pkt_info->agent_hdr;
+    PacketBufferPtr buff = pkt_info->packet_buffer_ptr();
+    PktModuleName mod = ParsePacket(hdr, pkt_info.get(), buff->data());
+    if (mod != FLOW) {
+        boost::shared_ptr<PacketBufferEnqueueItem>
+            info(new PacketBufferEnqueueItem(hdr, buff));
+        work_queue_.Enqueue(info);
+        return false;
+    }
+
+    agent_->stats()->incr_pkt_exceptions();
+    pkt_info->packet_buffer()->set_module(mod);
+    stats_.PktRcvd(mod);
+    tbb::mutex::scoped_lock lock(flow_trap_trace_mutex_);
+    pkt_trace_.at(mod).AddPktTrace(PktTrace::In, pkt_info->len,
+                                   buff->data(), &hdr);
+    return true;
+}
+
 // Process BFD keepalives (BFD packets with state 'UP') in a seperate task
 // that is independent of Db Task
 bool PktHandler::ProcessBfdDataPacket(boost::shared_ptr<PacketBufferEnqueueItem> item) {
@@ -1297,6 +1330,22 @@ void PktHandler::PktStats::PktQThresholdExceeded(PktModuleName mod) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static BlockFreeList *GetPktInfoFreeList() {
+    return StaticBlockFreeList<PktInfo>("PktInfo", sizeof(PktInfo));
+}
+
+void *PktInfo::operator new(size_t size) {
+    return GetPktInfoFreeList()->Allocate(size);
+}
+
+void PktInfo::operator delete(void *ptr, size_t size) {
+    GetPktInfoFreeList()->Free(ptr, size);
+}
+
+const BlockFreeList *PktInfo::free_list() {
+    return GetPktInfoFreeList();
+}
+
 PktInfo::PktInfo(const PacketBufferPtr &buff) :
     module(PktHandler::INVALID),
     pkt(buff->data()), len(buff->data_len()), max_pkt_len(buff->buffer_len()),
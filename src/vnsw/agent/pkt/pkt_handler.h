@@ -14,6 +14,7 @@
 #include <netinet/igmp.h>
 
 #include <tbb/atomic.h>
+#include <tbb/mutex.h>
 #include <boost/array.hpp>
 
 #include <base/address.h>
@@ -250,7 +251,8 @@ public:
 
     struct PktStats {
         uint32_t sent[MAX_MODULES];
-        uint32_t received[MAX_MODULES];
+        // Updated from flow-table tasks in run-to-completion mode
+        tbb::atomic<uint32_t> received[MAX_MODULES];
         uint32_t q_threshold_exceeded[MAX_MODULES];
         uint32_t dropped;
         void Reset() {
@@ -291,6 +293,7 @@ public:
                      PktType::Type &pkt_type, uint8_t *pkt);
     bool ProcessPacket(boost::shared_ptr<PacketBufferEnqueueItem> item);
     bool ProcessBfdDataPacket(boost::shared_ptr<PacketBufferEnqueueItem> item);
+    bool ProcessFlowTrap(boost::shared_ptr<PktInfo> pkt_info);
 // identify pkt type and send to the registered handler
     void HandleRcvPkt(const AgentHdr &hdr, const PacketBufferPtr &buff);
     void SendMessage(PktModuleName mod, InterTaskMsg *msg);
@@ -364,6 +367,8 @@ private:
 
     PktStats stats_;
     boost::array<PktTrace, MAX_MODULES> pkt_trace_;
+    // Flow traps are traced from flow-table tasks in run-to-completion mode
+    tbb::mutex flow_trap_trace_mutex_;
     DBTableBase::ListenerId iid_;
 
     Agent *agent_;
@@ -438,6 +443,12 @@ struct PktInfo {
     PktInfo(PktHandler::PktModuleName module, InterTaskMsg *msg);
     virtual ~PktInfo();
 
+    // A PktInfo is allocated for every packet trapped. Memory for PktInfo is
+    // taken from free-list
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+    static const BlockFreeList *free_list();
+
     const AgentHdr &GetAgentHdr() const;
     void UpdateHeaderPtr();
     std::size_t hash(const Agent *agent,
@@ -6,6 +6,8 @@
 #include <pkt/flow_mgmt.h>
 #include <pkt/flow_mgmt/flow_entry_info.h>
 #include <pkt/flow_mgmt/flow_mgmt_entry.h>
+#include <pkt/flow_mgmt/flow_mgmt_request.h>
+#include <pkt/packet_buffer.h>
 #include <vector>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <sstream>
@@ -162,7 +164,7 @@ static string InetRouteFlowMgmtKeyToString(uint16_t id,
     }\
     data.set_underlay_gw_index(fe->data().underlay_gw_index_);\
 
-const std::string PktSandeshFlow::start_key = "0-0-0-0-0-0.0.0.0-0.0.0.0";
+const std::string PktSandeshFlow::start_key = "0-0";
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -283,7 +285,7 @@ PktSandeshFlow::PktSandeshFlow(Agent *agent, FlowRecordsResp *obj,
                                std::string resp_ctx, std::string key):
     Task((TaskScheduler::GetInstance()->GetTaskId("Agent::PktFlowResponder")),
           0), resp_obj_(obj), resp_data_(resp_ctx),
-    flow_iteration_key_(), key_valid_(false), delete_op_(false), agent_(agent),
+    flow_iteration_slot_(0), key_valid_(false), delete_op_(false), agent_(agent),
     partition_id_(0) {
     if (key != agent_->NullString()) {
         if (SetFlowKey(key)) {
@@ -308,15 +310,12 @@ void PktSandeshFlow::SendResponse(SandeshResponse *resp) {
     resp->Response();
 }
 
-string PktSandeshFlow::GetFlowKey(const FlowKey &key, uint16_t partition_id) {
+// Flow key used for paging is the partition and the slot in flow table of
+// partition to resume from
+string PktSandeshFlow::GetFlowKey(uint16_t partition_id, size_t slot) {
     std::stringstream ss;
     ss << partition_id << kDelimiter;
-    ss << key.nh << kDelimiter;
-    ss << key.src_port << kDelimiter;
-    ss << key.dst_port << kDelimiter;
-    ss << (uint16_t)key.protocol << kDelimiter;
-    ss << key.src_addr.to_string() << kDelimiter;
-    ss << key.dst_addr.to_string();
+    ss << slot;
     return ss.str();
 }
 
@@ -325,48 +324,22 @@ bool PktSandeshFlow::SetFlowKey(string key) {
 
     const char ch = kDelimiter;
     size_t n = std::count(key.begin(), key.end(), ch);
-    if (n != 6) {
+    if (n != 1) {
         return false;
     }
     std::stringstream ss(key);
-    string item, sip, dip;
-    uint32_t proto = 0;
+    string item;
 
     if (getline(ss, item, ch)) {
         istringstream(item) >> partition_id_;
     }
     if (getline(ss, item, ch)) {
-        istringstream(item) >> flow_iteration_key_.nh;
-    }
-    if (getline(ss, item, ch)) {
-        istringstream(item) >> flow_iteration_key_.src_port;
-    }
-    if (getline(ss, item, ch)) {
-        istringstream(item) >> flow_iteration_key_.dst_port;
-    }
-    if (getline(ss, item, ch)) {
-        istringstream(item) >> proto;
-    }
-    if (getline(ss, item, ch)) {
-        sip = item;
+        istringstream(item) >> flow_iteration_slot_;
     }
-    if (getline(ss, item, ch)) {
-        dip = item;
-    }
-    boost::system::error_code ec;
-    flow_iteration_key_.src_addr = IpAddress::from_string(sip.c_str(), ec);
-    flow_iteration_key_.dst_addr = IpAddress::from_string(dip.c_str(), ec);
-    if (flow_iteration_key_.src_addr.is_v4()) {
-        flow_iteration_key_.family = Address::INET;
-    } else if (flow_iteration_key_.src_addr.is_v6()) {
-        flow_iteration_key_.family = Address::INET6;
-    }
-    flow_iteration_key_.protocol = proto;
     return true;
 }
 
 bool PktSandeshFlow::Run() {
-    FlowTable::FlowEntryMap::iterator it;
     std::vector<SandeshFlowData>& list =
         const_cast<std::vector<SandeshFlowData>&>(resp_obj_->get_flow_list());
     int count = 0;
@@ -389,54 +362,48 @@ bool PktSandeshFlow::Run() {
         return true;
     }
 
-    if (key_valid_)  {
-        it = flow_obj->flow_entry_map_.upper_bound(flow_iteration_key_);
-    } else {
+    if (!key_valid_)  {
          FlowErrorResp *resp = new FlowErrorResp();
          SendResponse(resp);
          return true;
     }
 
-    while (it == flow_obj->flow_entry_map_.end() &&
-          ++partition_id_ < agent_->flow_thread_count()) {
-         flow_obj = agent_->pkt()->flow_table(partition_id_);
-         it =  flow_obj->flow_entry_map_.begin();
-    }
-
-    while (it != flow_obj->flow_entry_map_.end()) {
-        FlowEntry *fe = it->second;
-        FlowStatsCollector *fec = fe->fsc();
-        const FlowExportInfo *info = NULL;
-        if (fec) {
-            info = fec->FindFlowExportInfo(fe);
+    FlowTable::FlowList flows;
+    size_t cursor = flow_iteration_slot_;
+    while (true) {
+        flows.clear();
+        flow_obj->GetNextFlows(&cursor, kMaxFlowResponse - count, &flows);
+
+        FlowTable::FlowList::iterator it = flows.begin();
+        while (it != flows.end()) {
+            FlowEntry *fe = *it;
+            FlowStatsCollector *fec = fe->fsc();
+            const FlowExportInfo *info = NULL;
+            if (fec) {
+                info = fec->FindFlowExportInfo(fe);
+            }
+            SetSandeshFlowData(list, fe, info);
+            ++it;
+            count++;
         }
-        SetSandeshFlowData(list, fe, info);
-        ++it;
-        count++;
-        if (count == kMaxFlowResponse) {
-            if (it != flow_obj->flow_entry_map_.end()) {
-                resp_obj_->set_flow_key(GetFlowKey(fe->key(), partition_id_));
-                flow_key_set = true;
 
+        if (count == kMaxFlowResponse) {
+            // Look ahead for a flow to resume the next page from
+            flows.clear();
+            flow_obj->GetNextFlows(&cursor, 1, &flows);
+            if (flows.empty() == false) {
+                resp_obj_->set_flow_key(GetFlowKey(partition_id_, cursor - 1));
             } else {
-                FlowKey key;
-                resp_obj_->set_flow_key(GetFlowKey(key, ++partition_id_));
-                flow_key_set = true;
+                resp_obj_->set_flow_key(GetFlowKey(++partition_id_, 0));
             }
+            flow_key_set = true;
             break;
         }
 
-        while (it == flow_obj->flow_entry_map_.end()) {
-            if (++partition_id_ < agent_->flow_thread_count()) {
-                flow_obj = agent_->pkt()->flow_table(partition_id_);
-                it = flow_obj->flow_entry_map_.begin();
-                if (it != flow_obj->flow_entry_map_.end()) {
-                    break;
-                }
-            } else {
-              break;
-           }
-        }
+        if (++partition_id_ >= agent_->flow_thread_count())
+            break;
+        flow_obj = agent_->pkt()->flow_table(partition_id_);
+        cursor = 0;
     }
 
     if (!flow_key_set) {
@@ -496,18 +463,17 @@ void FetchFlowRecord::HandleRequest() const {
     key.dst_port = (unsigned)get_dst_port();
     key.protocol = get_protocol();
 
-    FlowTable::FlowEntryMap::iterator it;
+    FlowEntry *fe = NULL;
     for (int i = 0; i < agent->flow_thread_count(); i++) {
         flow_obj = agent->pkt()->flow_table(i);
-        it = flow_obj->flow_entry_map_.find(key);
-        if (it != flow_obj->flow_entry_map_.end())
+        fe = flow_obj->flow_entry_map_.Find(key);
+        if (fe != NULL)
             break;
     }
 
     SandeshResponse *resp;
-    if (flow_obj && it != flow_obj->flow_entry_map_.end()) {
+    if (fe != NULL) {
        FlowRecordResp *flow_resp = new FlowRecordResp();
-       FlowEntry *fe = it->second;
        FlowStatsCollector *fec = fe->fsc();
        const FlowExportInfo *info = NULL;
        if (fec) {
@@ -602,60 +568,50 @@ bool PktSandeshFlowStats::Run() {
         return true;
     }
 
-    FlowTable::FlowEntryMap::iterator it;
-    if (key_valid_)  {
-        it = flow_obj->flow_entry_map_.upper_bound(flow_iteration_key_);
-    } else {
+    if (!key_valid_)  {
          FlowErrorResp *resp = new FlowErrorResp();
          SendResponse(resp);
          return true;
     }
 
-    while (it == flow_obj->flow_entry_map_.end() &&
-          ++partition_id_ < agent_->flow_thread_count()) {
-         flow_obj = agent_->pkt()->flow_table(partition_id_);
-         it =  flow_obj->flow_entry_map_.begin();
-    }
-
-    while (it != flow_obj->flow_entry_map_.end()) {
-        FlowEntry *fe = it->second;
-        const FlowExportInfo *info = NULL;
-        if (fe->fsc()) {
-            info = fe->fsc()->FindFlowExportInfo(fe);
+    FlowTable::FlowList flows;
+    size_t cursor = flow_iteration_slot_;
+    while (true) {
+        flows.clear();
+        flow_obj->GetNextFlows(&cursor, kMaxFlowResponse - count, &flows);
+
+        FlowTable::FlowList::iterator it = flows.begin();
+        while (it != flows.end()) {
+            FlowEntry *fe = *it;
+            const FlowExportInfo *info = NULL;
+            if (fe->fsc()) {
+                info = fe->fsc()->FindFlowExportInfo(fe);
+            }
+            SetSandeshFlowData(list, fe, info);
+            ++it;
+            count++;
         }
-        SetSandeshFlowData(list, fe, info);
-        ++it;
-        count++;
+
         if (count == kMaxFlowResponse) {
-            if (it != flow_obj->flow_entry_map_.end()) {
-                std::ostringstream ostr;
+            std::ostringstream ostr;
+            flows.clear();
+            flow_obj->GetNextFlows(&cursor, 1, &flows);
+            if (flows.empty() == false) {
                 ostr << proto_ << ":" << port_ << ":"
-                    << GetFlowKey(fe->key(), partition_id_);
-                resp_->set_flow_key(ostr.str());
-                flow_key_set = true;
+                    << GetFlowKey(partition_id_, cursor - 1);
             } else {
-                std::ostringstream ostr;
-                FlowKey key;
                 ostr << proto_ << ":" << port_ << ":"
-                    << GetFlowKey(key, ++partition_id_);
-                resp_->set_flow_key(ostr.str());
-                flow_key_set = true;
+                    << GetFlowKey(++partition_id_, 0);
             }
+            resp_->set_flow_key(ostr.str());
+            flow_key_set = true;
             break;
         }
 
-        while (it == flow_obj->flow_entry_map_.end()) {
-            if (++partition_id_ < agent_->flow_thread_count()) {
-                flow_obj = agent_->pkt()->flow_table(partition_id_);
-                it = flow_obj->flow_entry_map_.begin();
-                if (it != flow_obj->flow_entry_map_.end()) {
-                    break;
-                }
-            } else {
-              break;
-           }
-         }
-
+        if (++partition_id_ >= agent_->flow_thread_count())
+            break;
+        flow_obj = agent_->pkt()->flow_table(partition_id_);
+        cursor = 0;
     }
 
     if (!flow_key_set) {
@@ -720,6 +676,17 @@ void NextFlowStatsRecordsSet::HandleRequest() const {
 }
 
 
+static void SetBlockFreeListInfo(const BlockFreeList *free_list,
+                                 std::vector<SandeshBlockFreeListInfo> &list) {
+    SandeshBlockFreeListInfo info;
+    info.set_name(free_list->name());
+    info.set_block_size(free_list->block_size());
+    info.set_total_alloc(free_list->total_alloc());
+    info.set_total_reuse(free_list->total_reuse());
+    info.set_freelist_count(free_list->free_count());
+    list.push_back(info);
+}
+
 void SandeshFlowTableInfoRequest::HandleRequest() const {
     Agent *agent = Agent::GetInstance();
     FlowProto *proto = agent->pkt()->get_flow_proto();
@@ -728,6 +695,15 @@ void SandeshFlowTableInfoRequest::HandleRequest() const {
     resp->set_total_added(agent->stats()->flow_created());
     resp->set_max_flows(agent->stats()->max_flow_count());
     resp->set_total_deleted(agent->stats()->flow_aged());
+    std::vector<SandeshBlockFreeListInfo> block_list;
+    SetBlockFreeListInfo(FlowEvent::free_list(), block_list);
+    SetBlockFreeListInfo(PacketBuffer::free_list(), block_list);
+    SetBlockFreeListInfo(PktInfo::free_list(), block_list);
+    SetBlockFreeListInfo(FlowMgmtRequest::free_list(), block_list);
+    SetBlockFreeListInfo(FlowMgmtKeyTreePool::free_list(), block_list);
+    SetBlockFreeListInfo(FlowStatsCollector::FlowEntryTreePool::free_list(),
+                         block_list);
+    resp->set_block_free_list(block_list);
     std::vector<SandeshFlowTableInfo> info_list;
     for (uint16_t i = 0; i < proto->flow_table_count(); i++) {
         FlowTable *table = proto->GetTable(i);
@@ -21,7 +21,7 @@ public:
 
     void SendResponse(SandeshResponse *resp);
     bool SetFlowKey(std::string key);
-    static std::string GetFlowKey(const FlowKey &key, uint16_t partition_id);
+    static std::string GetFlowKey(uint16_t partition_id, size_t slot);
 
     virtual bool Run();
     std::string Description() const { return "PktSandeshFlow"; }
@@ -32,7 +32,7 @@ public:
 protected:
     FlowRecordsResp *resp_obj_;
     std::string resp_data_;
-    FlowKey flow_iteration_key_;
+    size_t flow_iteration_slot_;
     bool key_valid_;
     bool delete_op_;
     Agent *agent_;
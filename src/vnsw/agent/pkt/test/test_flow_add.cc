@@ -85,6 +85,76 @@ TEST_F(FlowTest, FlowAdd_1) {
    EXPECT_TRUE(fe->data().underlay_gw_index_ == 255);
 }
 
+//Run-to-completion mode needs vrouter hash. Both are reset in TearDown, so
+//that a failed test does not leave them enabled for the tests that follow
+class FlowRunToCompletionTest : public FlowTest {
+public:
+    virtual void SetUp() {
+        FlowTest::SetUp();
+        agent()->params()->set_flow_run_to_completion(true);
+        get_flow_proto()->set_use_vrouter_hash(true);
+    }
+
+    virtual void TearDown() {
+        get_flow_proto()->set_use_vrouter_hash(false);
+        agent()->params()->set_flow_run_to_completion(false);
+        FlowTest::TearDown();
+    }
+};
+
+//Flow creation in run-to-completion mode. Flow traps must not be enqueued
+//to packet handler queue
+TEST_F(FlowRunToCompletionTest, FlowAdd) {
+    PktHandler *pkt_handler = agent()->pkt()->pkt_handler();
+    uint64_t pkt_wq_count = pkt_handler->GetPktEnqueueCount();
+
+    TestFlow flow[] = {
+        {  TestFlowPkt(Address::INET, vm1_ip, vm2_ip, IPPROTO_TCP, 1000, 200,
+                       "vrf5", flow0->id()),
+        {
+            new VerifyVn("vn5", "vn5"),
+            new VerifyVrf("vrf5", "vrf5"),
+            new VerifyDestVrf("vrf5", "vrf5")
+        }
+        },
+        {  TestFlowPkt(Address::INET, vm2_ip, vm1_ip, IPPROTO_TCP, 200, 1000,
+                       "vrf5", flow1->id()),
+        {
+            new VerifyVn("vn5", "vn5"),
+            new VerifyVrf("vrf5", "vrf5"),
+            new VerifyDestVrf("vrf5", "vrf5")
+        }
+        }
+    };
+
+    CreateFlow(flow, 2);
+    EXPECT_EQ(2U, get_flow_proto()->FlowCount());
+    EXPECT_EQ(pkt_wq_count, pkt_handler->GetPktEnqueueCount());
+}
+
+//Flow-table for a flow-key is known only after parsing unless vrouter hash is
+//used. Flow traps must take packet handler queue without vrouter hash
+TEST_F(FlowRunToCompletionTest, FlowAdd_NoVrouterHash) {
+    get_flow_proto()->set_use_vrouter_hash(false);
+    PktHandler *pkt_handler = agent()->pkt()->pkt_handler();
+    uint64_t pkt_wq_count = pkt_handler->GetPktEnqueueCount();
+
+    TestFlow flow[] = {
+        {  TestFlowPkt(Address::INET, vm1_ip, vm2_ip, IPPROTO_TCP, 1000, 200,
+                       "vrf5", flow0->id()),
+        {
+            new VerifyVn("vn5", "vn5"),
+            new VerifyVrf("vrf5", "vrf5"),
+            new VerifyDestVrf("vrf5", "vrf5")
+        }
+        }
+    };
+
+    CreateFlow(flow, 1);
+    EXPECT_EQ(2U, get_flow_proto()->FlowCount());
+    EXPECT_EQ(pkt_wq_count + 1, pkt_handler->GetPktEnqueueCount());
+}
+
 //Egress flow test (IP fabric to VMPort - Same VN)
 //Flow creation using GRE packets
 TEST_F(FlowTest, FlowAdd_2) {
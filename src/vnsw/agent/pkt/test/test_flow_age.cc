@@ -160,6 +160,65 @@ TEST_F(FlowTest, FlowAge_3) {
     flow_stats_collector_->SetFlowAgeTime(bkp_age_time);
 }
 
+static uint64_t FlowVisits(FlowStatsCollectorObject *obj) {
+    uint64_t visits = 0;
+    for (int i = 0; i < FlowStatsCollectorObject::kMaxCollectors; i++) {
+        visits += obj->GetCollector(i)->flow_visits();
+    }
+    return visits;
+}
+
+// Idle flows must be visited only when they can be aged, and not on every
+// scan interval
+TEST_F(FlowTest, FlowAge_IdleFlowVisits) {
+    // Age time of 6 sec, flows with changing stats are visited every 1.5 sec
+    uint64_t tmp_age_time = 6 * 1000 * 1000;
+    uint64_t bkp_age_time = flow_stats_collector_->GetFlowAgeTime();
+    flow_stats_collector_->SetFlowAgeTime(tmp_age_time);
+
+    TestFlow flow[] = {
+        {
+            TestFlowPkt(Address::INET, vm1_ip, vm2_ip, 1, 0, 0, "vrf5",
+                    flow0->id(), 1),
+            { }
+        }
+    };
+
+    CreateFlow(flow, 1);
+    EXPECT_EQ(2U, get_flow_proto()->FlowCount());
+
+    // First visit reads the stats of new flows. Flows with changed stats are
+    // visited again after 1.5 sec and found idle
+    usleep(1700 * 1000);
+    client->EnqueueFlowAge();
+    client->WaitForIdle();
+    usleep(1600 * 1000);
+    client->EnqueueFlowAge();
+    client->WaitForIdle();
+    uint64_t visits = FlowVisits(flow_stats_collector_);
+
+    // Idle flows are not visited before they can be aged
+    for (int i = 0; i < 20; i++) {
+        usleep(100 * 1000);
+        client->EnqueueFlowAge();
+        client->WaitForIdle();
+    }
+    EXPECT_EQ(visits, FlowVisits(flow_stats_collector_));
+    EXPECT_EQ(2U, get_flow_proto()->FlowCount());
+
+    // Flows are aged on the visit after age time
+    for (int i = 0; i < 60 && get_flow_proto()->FlowCount() != 0; i++) {
+        usleep(100 * 1000);
+        client->EnqueueFlowAge();
+        client->WaitForIdle();
+    }
+    WAIT_FOR(100, 1, (0U == get_flow_proto()->FlowCount()));
+    EXPECT_GE(visits + 2, FlowVisits(flow_stats_collector_));
+
+    //Restore flow aging time
+    flow_stats_collector_->SetFlowAgeTime(bkp_age_time);
+}
+
 TEST_F(FlowTest, Flow_introspect_delete_all) {
     EXPECT_EQ(0U, get_flow_proto()->FlowCount());
 
@@ -6,6 +6,8 @@
 #include "test/test_cmn_util.h"
 #include "test_pkt_util.h"
 #include "pkt/flow_proto.h"
+#include "pkt/flow_mgmt.h"
+#include "pkt/flow_mgmt/flow_mgmt_request.h"
 
 class FlowTest : public ::testing::Test {
 public:
@@ -172,6 +174,106 @@ TEST_F(FlowTest, KSync_Alloc_Grow_1) {
               ksync_free_list_->max_count());
 }
 
+TEST_F(FlowTest, BlockFreeList_Alloc_Free_1) {
+    BlockFreeList free_list("Test", 64);
+    void *ptr = free_list.Allocate(32);
+    EXPECT_TRUE(ptr != NULL);
+    EXPECT_EQ(1U, free_list.total_alloc());
+    EXPECT_EQ(0U, free_list.total_reuse());
+
+    // Freed block is reused for next allocation
+    free_list.Free(ptr, 32);
+    EXPECT_EQ(1U, free_list.free_count());
+    void *ptr1 = free_list.Allocate(64);
+    EXPECT_TRUE(ptr == ptr1);
+    EXPECT_EQ(2U, free_list.total_alloc());
+    EXPECT_EQ(1U, free_list.total_reuse());
+    EXPECT_EQ(0U, free_list.free_count());
+
+    // Objects larger than block size are not pooled
+    void *ptr2 = free_list.Allocate(128);
+    EXPECT_EQ(2U, free_list.total_alloc());
+    free_list.Free(ptr2, 128);
+    EXPECT_EQ(0U, free_list.free_count());
+
+    free_list.Free(ptr1, 64);
+    EXPECT_EQ(1U, free_list.free_count());
+}
+
+TEST_F(FlowTest, Event_Alloc_Free_1) {
+    const BlockFreeList *event_free_list = FlowEvent::free_list();
+    uint64_t total_alloc = event_free_list->total_alloc();
+    FlowEvent *event = new FlowEvent(FlowEvent::FREE_FLOW_REF);
+    EXPECT_LT(total_alloc, event_free_list->total_alloc());
+    delete event;
+
+    FlowEvent *ksync_event = new FlowEventKSync(NULL, KSyncEntry::ADD_ACK, 0,
+                                                0, 0, 0, 0, 0, 0);
+    EXPECT_LT(total_alloc + 1, event_free_list->total_alloc());
+    delete ksync_event;
+}
+
+// PktInfo and FlowMgmtRequest held by shared_ptr are taken from free-list
+TEST_F(FlowTest, PktInfo_Alloc_Free_1) {
+    const BlockFreeList *free_list = PktInfo::free_list();
+    uint64_t total_alloc = free_list->total_alloc();
+    boost::shared_ptr<PktInfo> pkt_info(new PktInfo(PktHandler::FLOW, NULL));
+    EXPECT_EQ(total_alloc + 1, free_list->total_alloc());
+    pkt_info.reset();
+    EXPECT_LT(0U, free_list->free_count());
+}
+
+TEST_F(FlowTest, FlowMgmtRequest_Alloc_Free_1) {
+    const BlockFreeList *free_list = FlowMgmtRequest::free_list();
+    uint64_t total_alloc = free_list->total_alloc();
+    FlowMgmtManager::FlowMgmtRequestPtr req
+        (new FlowMgmtRequest(FlowMgmtRequest::DUMMY));
+    EXPECT_LT(total_alloc, free_list->total_alloc());
+    req.reset();
+    EXPECT_LT(0U, free_list->free_count());
+
+    // Derived requests are larger than the block and are not pooled
+    total_alloc = free_list->total_alloc();
+    req.reset(new BgpAsAServiceFlowMgmtRequest(0));
+    EXPECT_EQ(total_alloc, free_list->total_alloc());
+}
+
+struct TestTreePool {
+    static BlockFreeList *free_list() {
+        static BlockFreeList free_list("Test",
+            sizeof(std::pair<const int, int>) +
+            BlockFreeListAllocator<int, TestTreePool>::kMapNodeOverhead);
+        return &free_list;
+    }
+};
+
+// Nodes of map using BlockFreeListAllocator are recycled through free-list
+TEST_F(FlowTest, Tree_Alloc_Free_1) {
+    typedef std::map<int, int, std::less<int>,
+        BlockFreeListAllocator<std::pair<const int, int>, TestTreePool> > Tree;
+    BlockFreeList *free_list = TestTreePool::free_list();
+    {
+        Tree tree;
+        for (int i = 0; i < 10; i++) {
+            tree[i] = i;
+        }
+        EXPECT_EQ(10U, free_list->total_alloc());
+        EXPECT_EQ(0U, free_list->total_reuse());
+    }
+    EXPECT_EQ(10U, free_list->free_count());
+
+    Tree tree;
+    for (int i = 0; i < 10; i++) {
+        tree[i] = i;
+    }
+    EXPECT_EQ(20U, free_list->total_alloc());
+    EXPECT_EQ(10U, free_list->total_reuse());
+    EXPECT_EQ(0U, free_list->free_count());
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(i, tree[i]);
+    }
+}
+
 int main(int argc, char *argv[]) {
     int ret = 0;
 
@@ -76,6 +76,8 @@ public:
     }
 
     virtual void TearDown() {
+        flow_proto_->set_use_vrouter_hash(false);
+        agent_->params()->set_flow_run_to_completion(false);
         FlushFlowTable();
         client->Reset();
 
@@ -343,6 +345,130 @@ TEST_F(TestFlowTable, ResetFlowStats) {
                                200, 1, 30, vif0->flow_key_nh()->id(), 10));
 }
 
+// Run-to-completion picks flow-table from flow-handle. If vrouter hash is
+// turned off before the trap is processed, the parsed packet must move to
+// the flow-table for flow-key without going to packet handler queue
+TEST_F(TestFlowTable, RunToCompletion_Reenqueue) {
+    uint32_t count = flow_proto_->flow_table_count();
+    uint32_t index = flow_proto_->FlowTableIndex
+        (Ip4Address::from_string(vm1_ip), Ip4Address::from_string(vm2_ip),
+         IPPROTO_TCP, 1000, 200, 0);
+    // Flow-handle picking a table other than the one for flow-key
+    uint32_t flow_handle = ((index + 1) % count) * count;
+
+    agent_->params()->set_flow_run_to_completion(true);
+    flow_proto_->set_use_vrouter_hash(true);
+    for (uint32_t i = 0; i < count; i++) {
+        flow_proto_->DisableFlowEventQueue(i, true);
+    }
+
+    PktHandler *pkt_handler = agent_->pkt()->pkt_handler();
+    uint64_t pkt_wq_count = pkt_handler->GetPktEnqueueCount();
+    uint64_t add_count = flow_proto_->flow_stats()->add_count_;
+    TxTcpPacket(vif0->id(), vm1_ip, vm2_ip, 1000, 200, false, flow_handle,
+                vif0->vrf()->vrf_id());
+    client->WaitForIdle();
+
+    flow_proto_->set_use_vrouter_hash(false);
+    for (uint32_t i = 0; i < count; i++) {
+        flow_proto_->DisableFlowEventQueue(i, false);
+    }
+    client->WaitForIdle();
+
+    FlowEntry *flow = FlowGet(vm1_ip, vm2_ip, IPPROTO_TCP, 1000, 200,
+                              vif0->flow_key_nh()->id(), flow_handle);
+    EXPECT_TRUE(flow != NULL);
+    if (flow) {
+        EXPECT_EQ(index, (uint32_t)flow->flow_table()->table_index());
+    }
+    EXPECT_EQ(pkt_wq_count, pkt_handler->GetPktEnqueueCount());
+    EXPECT_EQ(add_count + 1, flow_proto_->flow_stats()->add_count_);
+}
+
+// Flow trap that does not parse as a flow packet must go back to packet
+// handler queue in run-to-completion mode
+TEST_F(TestFlowTable, RunToCompletion_NonFlowTrap) {
+    agent_->params()->set_flow_run_to_completion(true);
+    flow_proto_->set_use_vrouter_hash(true);
+
+    PktHandler *pkt_handler = agent_->pkt()->pkt_handler();
+    uint64_t pkt_wq_count = pkt_handler->GetPktEnqueueCount();
+    uint64_t dropped = agent_->stats()->pkt_dropped();
+    // Trap on an unknown interface is not a flow packet
+    TxTcpPacket(1000, vm1_ip, vm2_ip, 1000, 200, false, 1,
+                vif0->vrf()->vrf_id());
+    client->WaitForIdle();
+
+    EXPECT_EQ(pkt_wq_count + 1, pkt_handler->GetPktEnqueueCount());
+    EXPECT_EQ(dropped + 1, agent_->stats()->pkt_dropped());
+    EXPECT_EQ(0U, flow_proto_->FlowCount());
+}
+
+// Verify flow index with enough flows to grow and shrink the hash table.
+// Paging with slot cursor must return every flow once
+TEST_F(TestFlowTable, FlowEntryHashTable_1) {
+    FlowTable *table = flow_proto_->GetTable(0);
+    FlowEntryHashTable hash_table;
+    std::vector<FlowEntry *> flows;
+    for (uint32_t i = 0; i < 5000; i++) {
+        FlowKey key(vif0->flow_key_nh()->id(),
+                    Ip4Address(0x01010100 + (i % 200)),
+                    Ip4Address(0x01010101), IPPROTO_TCP, 1000 + (i / 200), 80);
+        FlowEntry *flow = FlowEntry::Allocate(key, table);
+        bool inserted = false;
+        EXPECT_TRUE(hash_table.Insert(flow, &inserted) == flow);
+        EXPECT_TRUE(inserted);
+        flows.push_back(flow);
+    }
+    EXPECT_EQ(flows.size(), hash_table.size());
+    EXPECT_TRUE(hash_table.slot_count() > FlowEntryHashTable::kMinSlots);
+
+    // Insert with duplicate key must return the existing flow
+    FlowEntry *dup = FlowEntry::Allocate(flows[10]->key(), table);
+    bool inserted = true;
+    EXPECT_TRUE(hash_table.Insert(dup, &inserted) == flows[10]);
+    EXPECT_FALSE(inserted);
+    table->free_list()->Free(dup);
+
+    // Page through the flows with slot cursor. Every flow must be returned
+    // exactly once
+    FlowEntryHashTable::FlowList list;
+    std::set<FlowEntry *> visited;
+    size_t cursor = 0;
+    size_t count = 0;
+    while (true) {
+        list.clear();
+        size_t prev = cursor;
+        hash_table.GetNext(&cursor, 100, &list);
+        if (list.empty())
+            break;
+        EXPECT_TRUE(list.size() <= 100);
+        EXPECT_TRUE(cursor > prev);
+        count += list.size();
+        visited.insert(list.begin(), list.end());
+    }
+    EXPECT_EQ(flows.size(), count);
+    EXPECT_EQ(flows.size(), visited.size());
+    EXPECT_EQ(hash_table.slot_count(), cursor);
+
+    for (size_t i = 0; i < flows.size(); i += 2) {
+        EXPECT_TRUE(hash_table.Remove(flows[i]));
+    }
+    for (size_t i = 0; i < flows.size(); i++) {
+        FlowEntry *flow = hash_table.Find(flows[i]->key());
+        EXPECT_TRUE(flow == ((i % 2) ? flows[i] : NULL));
+    }
+    for (size_t i = 1; i < flows.size(); i += 2) {
+        EXPECT_TRUE(hash_table.Remove(flows[i]));
+    }
+    EXPECT_TRUE(hash_table.empty());
+    EXPECT_EQ(FlowEntryHashTable::kMinSlots, hash_table.slot_count());
+
+    for (size_t i = 0; i < flows.size(); i++) {
+        table->free_list()->Free(flows[i]);
+    }
+}
+
 int main(int argc, char *argv[]) {
     int ret = 0;
     GETUSERARGS();
@@ -27,6 +27,7 @@
 #include "oper/vm.h"
 #include "oper/vn.h"
 #include "pkt/pkt_handler.h"
+#include "pkt/block_free_list.h"
 
 #include "vr_interface.h"
 #include "vr_types.h"
@@ -289,6 +290,42 @@ TEST_F(PktTest, tx_vlan_1) {
     client->WaitForIdle();
 }
 
+// Rx buffers must be returned to the pool when the packet is freed
+TEST_F(PktTest, RxBufferRecycle_1) {
+    PacketBufferManager *mgr = agent_->pkt()->packet_buffer_manager();
+    uint32_t pool_size = mgr->rx_buffer_pool_size();
+
+    uint8_t *buff = mgr->AllocateRxBuffer();
+    PacketBufferPtr pkt = mgr->AllocateRxPacket(PktHandler::RX_PACKET, buff,
+                                                64, 0);
+    EXPECT_TRUE(pkt->data() == buff);
+    EXPECT_EQ(64, pkt->data_len());
+    EXPECT_EQ(PacketBufferManager::kRxBufferSize, pkt->buffer_len());
+
+    pkt.reset();
+    EXPECT_EQ(pool_size + 1, mgr->rx_buffer_pool_size());
+
+    // Next allocation must reuse the buffer
+    uint64_t alloc = mgr->rx_buffer_alloc();
+    EXPECT_TRUE(mgr->AllocateRxBuffer() == buff);
+    EXPECT_EQ(alloc, mgr->rx_buffer_alloc());
+    mgr->FreeRxBuffer(buff);
+}
+
+// Memory of freed PacketBuffer is reused for next packet
+TEST_F(PktTest, PacketBufferRecycle_1) {
+    PacketBufferManager *mgr = agent_->pkt()->packet_buffer_manager();
+    const BlockFreeList *free_list = PacketBuffer::free_list();
+    PacketBufferPtr pkt = mgr->Allocate(PktHandler::RX_PACKET, 64, 0);
+    pkt.reset();
+    EXPECT_LT(0U, free_list->free_count());
+
+    uint64_t total_reuse = free_list->total_reuse();
+    pkt = mgr->Allocate(PktHandler::RX_PACKET, 64, 0);
+    EXPECT_EQ(64, pkt->data_len());
+    EXPECT_LT(total_reuse, free_list->total_reuse());
+}
+
 int main(int argc, char *argv[]) {
     GETUSERARGS();
 
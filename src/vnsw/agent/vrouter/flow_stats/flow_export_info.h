@@ -6,8 +6,9 @@
 
 #include <pkt/flow_entry.h>
 #include <filter/acl.h>
+#include <vrouter/flow_stats/timer_wheel.h>
 
-class FlowExportInfo : public boost::intrusive::list_base_hook<> {
+class FlowExportInfo : public TimerWheelEntry {
 public:
     FlowExportInfo();
     FlowExportInfo(const FlowEntryPtr &fe, uint64_t setup_time);
@@ -51,6 +52,4 @@ private:
     uint32_t flow_handle_;
     boost::uuids::uuid uuid_;
 };
-
-typedef boost::intrusive::list<FlowExportInfo> FlowExportInfoList;
 #endif //  __AGENT_FLOW_EXPORT_INFO_H__
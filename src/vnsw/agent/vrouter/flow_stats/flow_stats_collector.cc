@@ -35,6 +35,14 @@
 #include <vrouter/flow_stats/flow_stats_types.h>
 
 bool flow_ageing_debug_ = false;
+
+BlockFreeList *FlowStatsCollector::FlowEntryTreePool::free_list() {
+    return StaticBlockFreeList<FlowEntryTreePool>(
+               "FlowStatsCollector::FlowEntryTree",
+               sizeof(FlowEntryTree::value_type) +
+               FlowEntryTreeAllocator::kMapNodeOverhead);
+}
+
 FlowStatsCollector::FlowStatsCollector(boost::asio::io_service &io, int intvl,
                                        uint32_t flow_cache_timeout,
                                        AgentUveBase *uve,
@@ -49,9 +57,8 @@ FlowStatsCollector::FlowStatsCollector(boost::asio::io_service &io, int intvl,
         task_id_(uve->agent()->task_scheduler()->GetTaskId
                  (kTaskFlowStatsCollector)),
         rand_gen_(boost::uuids::random_generator()),
-        flow_iteration_key_(NULL),
-        entries_to_visit_(0),
         flow_tcp_syn_age_time_(FlowTcpSynAgeTime),
+        ageing_wheel_(GetCurrentTime() / (kFlowStatsTimerInterval * 1000)),
         retry_delete_(true),
         request_queue_(agent_uve_->agent()->task_scheduler()->
                        GetTaskId(kTaskFlowStatsCollector),
@@ -60,13 +67,15 @@ FlowStatsCollector::FlowStatsCollector(boost::asio::io_service &io, int intvl,
                                    this, _1)),
         flow_aging_key_(*key), instance_id_(instance_id),
         flow_stats_manager_(aging_module), parent_(obj), ageing_task_(NULL),
-        current_time_(GetCurrentTime()), ageing_task_starts_(0) {
+        current_time_(GetCurrentTime()), ageing_task_starts_(0),
+        flow_visits_(0) {
         if (flow_cache_timeout) {
             // Convert to usec
             flow_age_time_intvl_ = 1000000L * (uint64_t)flow_cache_timeout;
         } else {
             flow_age_time_intvl_ = FlowAgeTime;
         }
+        wheel_age_time_intvl_ = flow_age_time_intvl_;
         deleted_ = false;
         request_queue_.set_name("Flow stats collector");
         request_queue_.set_measure_busy_time
@@ -75,9 +84,6 @@ FlowStatsCollector::FlowStatsCollector(boost::asio::io_service &io, int intvl,
             (boost::bind(&FlowStatsCollector::RequestHandlerEntry, this));
         request_queue_.SetExitCallback
             (boost::bind(&FlowStatsCollector::RequestHandlerExit, this, _1));
-        // Aging timer fires every kFlowStatsTimerInterval msec. Compute
-        // number of timer fires needed to scan complete table
-        timers_per_scan_ = TimersPerScan();
         InitDone();
 }
 
@@ -99,53 +105,33 @@ void FlowStatsCollector::Shutdown() {
     request_queue_.Shutdown();
 }
 
-// We want to scan the flow table every 25% of configured ageing time.
-// Compute number of timer fires needed to scan the flow-table once.
-uint32_t FlowStatsCollector::TimersPerScan() {
-    uint64_t scan_time_millisec;
-    /* Use Age Time itself as scan-time for flows */
-
-    // Convert aging-time configured in micro-sec to millisecond
-    scan_time_millisec = flow_age_time_intvl_ / 1000;
+// Convert time in usec to tick of ageing_wheel_. Rounded up so that flow is
+// not visited before the time
+uint64_t FlowStatsCollector::TimeToTick(uint64_t time) {
+    uint64_t tick_usec = kFlowStatsTimerInterval * 1000;
+    return (time + tick_usec - 1) / tick_usec;
+}
 
-    // Compute time in which we must scan the complete table to honor the
-    // kFlowScanTime
-    scan_time_millisec = (scan_time_millisec * kFlowScanTime) / 100;
+// Flows with changing stats are visited every kFlowScanTime percent of
+// ageing time
+uint64_t FlowStatsCollector::FlowScanTime() const {
+    uint64_t scan_time = (flow_age_time_intvl_ * kFlowScanTime) / 100;
 
     // Enforce min value on scan-time
-    if (scan_time_millisec < kFlowStatsTimerInterval) {
-        scan_time_millisec = kFlowStatsTimerInterval;
+    if (scan_time < (kFlowStatsTimerInterval * 1000)) {
+        scan_time = kFlowStatsTimerInterval * 1000;
     }
-
-    // Number of timer fires needed to scan table once
-    return scan_time_millisec / kFlowStatsTimerInterval;
+    return scan_time;
 }
 
-// Update entries_to_visit_ based on total flows
-// Timer fires every kFlowScanTime. Its possible that we may not have visited
-// all entries by the time next timer fires. So, keep accumulating the number
-// of entries to visit into entries_to_visit_
-//
-// A lower-bound and an upper-bound are enforced on entries_to_visit_
-void FlowStatsCollector::UpdateEntriesToVisit() {
-    // Compute number of flows to visit per scan-time
-    uint32_t count = flow_export_info_list_.size();
-    uint32_t entries = count / timers_per_scan_;
-
-    // Update number of entries to visit in flow.
-    // The scan for previous timer may still be in progress. So, accmulate
-    // number of entries to visit
-    entries_to_visit_ += entries;
-
-    // Cap number of entries to visit to 25% of table
-    if (entries_to_visit_ > ((count * kFlowScanTime)/100))
-        entries_to_visit_ = (count * kFlowScanTime)/100;
-
-    // Apply lower-limit
-    if (entries_to_visit_ < kMinFlowsPerTimer)
-        entries_to_visit_ = kMinFlowsPerTimer;
-
-    return;
+// Schedule flow to be visited at time. Flow is visited atleast one tick
+// later so that an ageing task does not visit same flow again
+void FlowStatsCollector::ScheduleFlow(FlowExportInfo *info, uint64_t time) {
+    uint64_t tick = TimeToTick(time);
+    if (tick <= ageing_wheel_.current_tick()) {
+        tick = ageing_wheel_.current_tick() + 1;
+    }
+    ageing_wheel_.Schedule(info, tick);
 }
 
 bool FlowStatsCollector::ShouldBeAged(FlowExportInfo *info,
@@ -602,29 +588,43 @@ bool FlowStatsCollector::AgeFlow(KSyncFlowMemory *ksync_obj,
 
     // Update stats for flows not being deleted
     // Stats for deleted flow are updated when we get DELETE message
-    if (deleted == false && k_flow) {
-        uint64_t k_bytes, bytes;
-
-        k_bytes = GetFlowStats(k_stats.flow_bytes_oflow,
-                               k_stats.flow_bytes);
-        bytes = 0x0000ffffffffffffULL & info->bytes();
-        /* Don't account for agent overflow bits while comparing change in
-         * stats */
-        if (bytes != k_bytes) {
-            UpdateFlowStatsInternalLocked(info,
-                                          k_stats.flow_bytes,
-                                          k_stats.flow_bytes_oflow,
-                                          k_stats.flow_packets,
-                                          k_stats.flow_packets_oflow,
-                                          curr_time, false);
-        }
+    if (deleted == false) {
+        UpdateChangedFlowStats(info, k_flow, k_stats, curr_time);
     }
     return deleted;
 }
 
+// Export stats of flow only if counters changed in vrouter. Sets
+// last_modified_time of the flow to curr_time on change. Returns true if
+// counters changed
+bool FlowStatsCollector::UpdateChangedFlowStats(FlowExportInfo *info,
+                                                const vr_flow_entry *k_flow,
+                                                const vr_flow_stats &k_stats,
+                                                uint64_t curr_time) {
+    if (k_flow == NULL)
+        return false;
+
+    uint64_t k_bytes, bytes;
+    k_bytes = GetFlowStats(k_stats.flow_bytes_oflow, k_stats.flow_bytes);
+    bytes = 0x0000ffffffffffffULL & info->bytes();
+    /* Don't account for agent overflow bits while comparing change in
+     * stats */
+    if (bytes == k_bytes)
+        return false;
+
+    UpdateFlowStatsInternalLocked(info,
+                                  k_stats.flow_bytes,
+                                  k_stats.flow_bytes_oflow,
+                                  k_stats.flow_packets,
+                                  k_stats.flow_packets_oflow,
+                                  curr_time, false);
+    return true;
+}
+
 // Check if a flow is to be aged or evicted. Returns number of flows visited
-uint32_t FlowStatsCollector::ProcessFlow(FlowExportInfoList::iterator &it,
-                                         KSyncFlowMemory *ksync_obj,
+// The flow is removed from ageing_wheel_ when invoked, and is scheduled again
+// unless it must not be visited anymore
+uint32_t FlowStatsCollector::ProcessFlow(KSyncFlowMemory *ksync_obj,
                                          FlowExportInfo *info,
                                          uint64_t curr_time) {
     uint32_t count = 1;
@@ -670,102 +670,95 @@ uint32_t FlowStatsCollector::ProcessFlow(FlowExportInfoList::iterator &it,
         // Flow evicted?
         if (EvictFlow(ksync_obj, k_flow, kinfo.flags, flow_handle, gen_id,
                       info, curr_time) == true) {
-            // If retry_delete_ enabled, dont change flow_export_info_list_
-            if (retry_delete_ == true)
-                return count;
-
-            // We dont want to retry delete-events, remove flow from ageing list
-            assert(info->is_linked());
-            FlowExportInfoList::iterator flow_it =
-                flow_export_info_list_.iterator_to(*info);
-            flow_export_info_list_.erase(flow_it);
+            // If retry_delete_ enabled, retry evict after kFlowDeleteRetryTime
+            if (retry_delete_ == true) {
+                ScheduleFlow(info, info->evict_enqueue_time() +
+                             kFlowDeleteRetryTime);
+            }
 
+            // We dont want to retry delete-events, flow is not visited again
             return count;
         }
+    } else if (info->evict_enqueue_time() &&
+               (curr_time - info->evict_enqueue_time()) <=
+               kFlowDeleteRetryTime) {
+        // Flow evicted by vrouter and evict enqueued on evicted flow stats
+        // message. If evict does not remove the flow, its aged on the visit
+        // after kFlowDeleteRetryTime
+        ScheduleFlow(info, info->evict_enqueue_time() + kFlowDeleteRetryTime);
+        return count;
     }
 
-
     // Flow aged?
-    if (AgeFlow(ksync_obj, k_flow, k_stats, kinfo, info, curr_time) == false)
+    if (AgeFlow(ksync_obj, k_flow, k_stats, kinfo, info, curr_time) == false) {
+        // Flow with counters changed in this visit is visited again after
+        // scan time to export stats. An idle flow is visited again only when
+        // it can be aged. Flow past ageing time, but not aged (ex. reverse
+        // flow active), is visited after scan time
+        uint64_t next_time = info->last_modified_time() +
+            flow_age_time_intvl_;
+        if (info->last_modified_time() == curr_time || next_time <= curr_time)
+            next_time = curr_time + FlowScanTime();
+        ScheduleFlow(info, next_time);
         return count;
+    }
 
-    // If retry_delete_ enabled, dont change flow_export_info_list_
-    if (retry_delete_ == false)
+    // If retry_delete_ is not enabled, visit flow again to retry delete
+    if (retry_delete_ == false) {
+        ScheduleFlow(info, info->delete_enqueue_time() + kFlowDeleteRetryTime);
         return count;
+    }
 
-    // Flow aged, remove both forward and reverse flow
-    assert(info->is_linked());
-    FlowExportInfoList::iterator flow_it =
-        flow_export_info_list_.iterator_to(*info);
-    flow_export_info_list_.erase(flow_it);
-
+    // Flow aged, remove reverse flow also. Forward flow is not scheduled again
     FlowEntry *rfe = info->reverse_flow();
     FlowExportInfo *rev_info = FindFlowExportInfo(rfe);
     if (rev_info) {
-        if (rev_info->is_linked()) {
-            FlowExportInfoList::iterator rev_flow_it =
-                flow_export_info_list_.iterator_to(*rev_info);
-            if (rev_flow_it == it) {
-                it++;
-            }
-            flow_export_info_list_.erase(rev_flow_it);
-        }
+        ageing_wheel_.Cancel(rev_info);
         count++;
     }
     return count;
 }
 
 uint32_t FlowStatsCollector::RunAgeing(uint32_t max_count) {
-    FlowExportInfoList::iterator it;
-    if (flow_iteration_key_ == NULL) {
-        it = flow_export_info_list_.begin();
-    } else {
-        FlowEntryTree::iterator tree_it = flow_tree_.find(flow_iteration_key_);
-        // Flow to iterate next is not found. Force stop this iteration.
-        // We will continue from begining on next timer
-        if (tree_it == flow_tree_.end()) {
-            flow_iteration_key_ = NULL;
-            return entries_to_visit_;
-        }
-        it = flow_export_info_list_.iterator_to(tree_it->second);
-    }
-
     KSyncFlowMemory *ksync_obj = agent_uve_->agent()->ksync()->
         ksync_flow_memory();
     uint64_t curr_time = GetCurrentTime();
     uint32_t count = 0;
     while (count < max_count) {
-        if (it == flow_export_info_list_.end()) {
+        FlowExportInfo *info = ageing_wheel_.PopExpired();
+        if (info == NULL) {
             break;
         }
 
-        FlowExportInfo *info = &(*it);
-        it++;
         flows_visited_++;
-        count += ProcessFlow(it, ksync_obj, info, curr_time);
-    }
-
-    // Update iterator for next pass
-    if (it == flow_export_info_list_.end()) {
-        flow_iteration_key_ = NULL;
-    } else {
-        flow_iteration_key_ = it->flow();
+        flow_visits_++;
+        count += ProcessFlow(ksync_obj, info, curr_time);
     }
 
     return count;
 }
 
-// Timer fired for ageing. Update the number of entries to visit and start the
-// task if its already not ruuning
+// Timer fired for ageing. Advance the ageing wheel and start the task to visit
+// expired flows if its already not ruuning
 bool FlowStatsCollector::Run() {
     if (flow_tree_.size() == 0) {
         return true;
      }
 
-    // Update number of entries to visit in flow.
-    UpdateEntriesToVisit();
+    // Flows are scheduled based on ageing time. Visit all flows again if
+    // ageing time is modified
+    if (wheel_age_time_intvl_ != flow_age_time_intvl_) {
+        wheel_age_time_intvl_ = flow_age_time_intvl_;
+        ageing_wheel_.ExpireAll();
+    }
 
-    // Start task to scan the entries
+    // Expire flows scheduled upto current time
+    ageing_wheel_.Advance(GetCurrentTime() / (kFlowStatsTimerInterval * 1000));
+    if (ageing_wheel_.expired_size() == 0) {
+        return true;
+    }
+
+    // Start task to visit the expired entries
     if (ageing_task_ == NULL) {
         ageing_task_starts_++;
 
@@ -775,7 +768,8 @@ bool FlowStatsCollector::Run() {
                 << " AgeingTasks Num " << ageing_task_starts_
                 << " Request count " << request_queue_.Length()
                 << " Tree size " << flow_tree_.size()
-                << " List size " << flow_export_info_list_.size()
+                << " Wheel size " << ageing_wheel_.size()
+                << " Expired size " << ageing_wheel_.expired_size()
                 << " flows visited " << flows_visited_
                 << " flows aged " << flows_aged_
                 << " flows evicted " << flows_evicted_);
@@ -791,15 +785,10 @@ bool FlowStatsCollector::Run() {
 
 bool FlowStatsCollector::RunAgeingTask() {
     // Run ageing per task
-    uint32_t count = RunAgeing(kFlowsPerTask);
-    // Update number of entries visited
-    if (count < entries_to_visit_)
-        entries_to_visit_ -= count;
-    else
-        entries_to_visit_ = 0;
-    // Done with task if we reach end of tree or count is exceeded
-    if (flow_iteration_key_ == NULL || entries_to_visit_ == 0) {
-        entries_to_visit_ = 0;
+    RunAgeing(kFlowsPerTask);
+
+    // Done with task if all expired entries are visited
+    if (ageing_wheel_.expired_size() == 0) {
         ageing_task_ = NULL;
         return true;
     }
@@ -998,59 +987,18 @@ void FlowStatsCollector::AddFlow(FlowExportInfo info) {
     } else {
         NewFlow(info.flow());
     }
-    if (ret.first->second.is_linked() == false) {
-        flow_export_info_list_.push_back(ret.first->second);
-    }
-}
-
-// The flow being deleted may be the first flow to visit in next ageing
-// iteration. Update the flow to visit next in such case
-void FlowStatsCollector::UpdateFlowIterationKey
-(const FlowEntry *del_flow, FlowEntryTree::iterator &tree_it) {
-    // Flow not found in tree is not a valid scenario. Lets be safe and
-    // restart walk here
-    if (tree_it == flow_tree_.end()) {
-        flow_iteration_key_ = NULL;
-    }
-
-    if (flow_iteration_key_ == NULL) {
-        return;
-    }
-
-    // The flow to visit next for ageing is being deleted. Update next flow to
-    // visit
-    FlowExportInfoList::iterator it =
-        flow_export_info_list_.iterator_to(tree_it->second);
-    ++it;
-
-    // If this is end of list, start from begining again
-    if (it == flow_export_info_list_.end())
-        it = flow_export_info_list_.begin();
-
-    if (it == flow_export_info_list_.end()) {
-        flow_iteration_key_ = NULL;
-    } else {
-        flow_iteration_key_ = it->flow();
+    // Visit new flow after scan time to read its stats
+    FlowExportInfo *export_info = &ret.first->second;
+    if (export_info->wheel_linked() == false) {
+        ScheduleFlow(export_info, info.last_modified_time() + FlowScanTime());
     }
 }
 
 void FlowStatsCollector::DeleteFlow(FlowEntryTree::iterator &it) {
-    // Update flow_iteration_key_ if flow being deleted is flow to visit in
-    // next ageing cycle
-    // Nothing to do if flow being deleted is not the next-iteration key
-    if (it->first == flow_iteration_key_) {
-        UpdateFlowIterationKey(it->first, it);
-    }
-
     if (it == flow_tree_.end())
         return;
 
-    if (it->second.is_linked()) {
-        FlowExportInfoList::iterator it1 =
-            flow_export_info_list_.iterator_to(it->second);
-        flow_export_info_list_.erase(it1);
-    }
-
+    ageing_wheel_.Cancel(&it->second);
     flow_tree_.erase(it);
 }
 
@@ -1071,9 +1019,19 @@ void FlowStatsCollector::EvictedFlowStatsUpdate(const FlowEntryPtr &flow,
         /* We are updating stats of evicted flow. Set teardown_time here.
          * When delete event is being handled we don't export flow if
          * teardown time is set */
+        uint64_t curr_time = GetCurrentTime();
         UpdateFlowStatsInternal(info, bytes, oflow_bytes & 0xFFFF,
                                 packets, oflow_bytes & 0xFFFF0000,
-                                GetCurrentTime(), true);
+                                curr_time, true);
+
+        /* Flow is already evicted in vrouter. Evict the flow now instead of
+         * waiting for its next visit, which can be upto ageing time away for
+         * an idle flow. Visit the flow again to age it if evict fails */
+        if (info->evict_enqueue_time() == 0) {
+            FlowEvictEnqueue(info, curr_time, info->flow_handle(),
+                             info->gen_id());
+            ScheduleFlow(info, curr_time + kFlowDeleteRetryTime);
+        }
     }
 }
 
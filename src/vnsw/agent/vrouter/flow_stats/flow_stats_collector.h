@@ -6,6 +6,7 @@
 #define vnsw_agent_flow_stats_collector_h
 
 #include <boost/static_assert.hpp>
+#include <pkt/block_free_list.h>
 #include <pkt/flow_table.h>
 #include <cmn/agent_cmn.h>
 #include <cmn/index_vector.h>
@@ -15,6 +16,7 @@
 #include <sandesh/common/flow_types.h>
 #include <vrouter/flow_stats/flow_export_request.h>
 #include <vrouter/flow_stats/flow_export_info.h>
+#include <vrouter/flow_stats/timer_wheel.h>
 #include <vrouter/flow_stats/flow_stats_manager.h>
 
 // Forward declaration
@@ -37,26 +39,29 @@ public:
 //of kTaskFlowStatsCollector which has exclusion with "db::DBTable",
 //
 // The algorithm for ageing flows,
-// - The complete flow-table will be scanned every 25% of ageing time
-//   - An implication of this is, flow ageing will have accuracy of 25%
-// - Run timer every kFlowStatsTimerInterval msec (100 msec)
-// - Compute number of flow-entres to visit in kFlowStatsTimerInterval
-//   - This is subject to constraing that complete flow table must be scanned
-//     in 25% of ageing time
-// - On every timer expiry accumulate the number of entries to visit into
-//   entries_to_visit_ variable
-// - Start a task (Flow AgeingTask) to scan the flow-entries
+// - Every flow is kept in ageing_wheel_, a timing wheel keyed on the time
+//   the flow must be visited next
+// - Run timer every kFlowStatsTimerInterval msec (100 msec). This is also the
+//   tick of the wheel
+// - On every timer expiry, advance the wheel to current time. Flows due for
+//   a visit move to expired list of the wheel
+// - Start a task (Flow AgeingTask) to visit the expired flows
 // - On every run of task, visit upto kFlowsPerTask entries
-//   If scan is not complete, continue the task
-//   On completion of scan, stop the task
+//   If expired list is not empty, continue the task
+//   On completion, stop the task
 //
 // On every visit of flow, check if flow is idle for configured ageing time and
-// delete the idle flows
+// delete the idle flows. Stats are exported only if counters changed since
+// the last visit. Flows with changed counters are visited again after
+// kFlowScanTime percent of ageing time. Idle flows are visited again only
+// when they can be aged, ie after ageing time from the last change in stats.
 //
-// The flow_tree_ maintains flows sorted on flow pointer. This tree cannot be
-// used to scan flows for ageing since entries can be added/deleted between
-// ageing tasks. Alternatively, another list is maintained in the sequence
-// flows are added to flow ageing module.
+// Flows marked for eviction by vrouter (EvictFlow) are detected when the flow
+// is visited. Flows already evicted by vrouter are evicted on the evicted
+// flow stats message, without waiting for the next visit.
+//
+// The flow_tree_ maintains flows sorted on flow pointer. The FlowExportInfo
+// in the tree is also the entry in the ageing_wheel_.
 class FlowStatsCollector : public StatsCollector {
 public:
     // Default ageing time
@@ -64,13 +69,11 @@ public:
     // Default TCP ageing time
     static const uint64_t FlowTcpSynAgeTime = 1000000 * 180;
 
-    // Time within which complete table must be scanned
+    // Interval to visit flows with changing stats
     // Specified in terms of percentage of aging-time
     static const uint32_t kFlowScanTime = 25;
     // Flog ageing timer interval in milliseconds
     static const uint32_t kFlowStatsTimerInterval = 100;
-    // Minimum flows to visit per interval
-    static const uint32_t kMinFlowsPerTimer = 3000;
     // Number of flows to visit per task
     static const uint32_t kFlowsPerTask = 256;
 
@@ -80,8 +83,19 @@ public:
     static const uint32_t kDefaultFlowSamplingThreshold = 500;
     static const uint8_t  kMaxFlowMsgsPerSend = 16;
 
-    typedef std::map<const FlowEntry*, FlowExportInfo> FlowEntryTree;
+    // A node is added to flow_tree_ for every flow created. Nodes are taken
+    // from a free-list shared by all collectors
+    struct FlowEntryTreePool {
+        static BlockFreeList *free_list();
+    };
+    typedef BlockFreeListAllocator<
+        std::pair<const FlowEntry *const, FlowExportInfo>, FlowEntryTreePool>
+        FlowEntryTreeAllocator;
+    typedef std::map<const FlowEntry*, FlowExportInfo,
+                     std::less<const FlowEntry*>, FlowEntryTreeAllocator>
+        FlowEntryTree;
     typedef WorkQueue<boost::shared_ptr<FlowExportReq> > Queue;
+    typedef TimerWheel<FlowExportInfo> FlowAgeingWheel;
 
     // Task in which the actual flow table scan happens. See description above
     class AgeingTask : public Task {
@@ -119,8 +133,7 @@ public:
     boost::uuids::uuid rand_gen();
     bool Run();
     bool RunAgeingTask();
-    uint32_t ProcessFlow(FlowExportInfoList::iterator &it,
-                         KSyncFlowMemory *ksync_obj,
+    uint32_t ProcessFlow(KSyncFlowMemory *ksync_obj,
                          FlowExportInfo *info, uint64_t curr_time);
     bool AgeFlow(KSyncFlowMemory *ksync_obj, const vr_flow_entry *k_flow,
                  const vr_flow_stats &k_stats, const KFlowData &kinfo,
@@ -150,7 +163,8 @@ public:
     const FlowExportInfo *FindFlowExportInfo(const FlowEntry *fe) const;
     static uint64_t GetFlowStats(const uint16_t &oflow_data, const uint32_t &data);
     size_t Size() const { return flow_tree_.size(); }
-    size_t AgeTreeSize() const { return flow_export_info_list_.size(); }
+    size_t AgeTreeSize() const { return ageing_wheel_.size(); }
+    uint64_t flow_visits() const { return flow_visits_; }
     void NewFlow(FlowEntry *flow);
     void set_deleted(bool val) {
         deleted_ = val;
@@ -173,8 +187,9 @@ public:
 
 private:
     static uint64_t GetCurrentTime();
-    uint32_t TimersPerScan();
-    void UpdateEntriesToVisit();
+    static uint64_t TimeToTick(uint64_t time);
+    uint64_t FlowScanTime() const;
+    void ScheduleFlow(FlowExportInfo *info, uint64_t time);
     void EvictedFlowStatsUpdate(const FlowEntryPtr &flow, uint32_t bytes,
                                 uint32_t packets, uint32_t oflow_bytes,
                                 const boost::uuids::uuid &u);
@@ -204,6 +219,10 @@ private:
                                 uint64_t bytes, uint64_t pkts);
     bool ShouldBeAged(FlowExportInfo *info, const vr_flow_entry *k_flow,
                       const vr_flow_stats &k_stats, uint64_t curr_time);
+    bool UpdateChangedFlowStats(FlowExportInfo *info,
+                                const vr_flow_entry *k_flow,
+                                const vr_flow_stats &k_stats,
+                                uint64_t curr_time);
     uint64_t GetUpdatedFlowPackets(const FlowExportInfo *stats,
                                    uint64_t k_flow_pkts);
     uint64_t GetUpdatedFlowBytes(const FlowExportInfo *stats,
@@ -217,28 +236,26 @@ private:
     void RequestHandlerExit(bool done);
     void AddFlow(FlowExportInfo info);
     void DeleteFlow(FlowEntryTree::iterator &it);
-    void UpdateFlowIterationKey(const FlowEntry *del_flow,
-                                FlowEntryTree::iterator &tree_it);
     void HandleFlowStatsUpdate(const FlowKey &key, uint32_t bytes,
                                uint32_t packets, uint32_t oflow_bytes);
 
     AgentUveBase *agent_uve_;
     int task_id_;
     boost::uuids::random_generator rand_gen_;
-    const FlowEntry* flow_iteration_key_;
     uint64_t flow_age_time_intvl_;
-    // Number of entries pending to be visited
-    uint32_t entries_to_visit_;
+    // Ageing time used to schedule flows in ageing_wheel_. All flows are
+    // visited again when ageing time is modified
+    uint64_t wheel_age_time_intvl_;
     uint64_t flow_tcp_syn_age_time_;
 
     FlowEntryTree flow_tree_;
-    FlowExportInfoList flow_export_info_list_;
+    FlowAgeingWheel ageing_wheel_;
     // Flag to specify if flow-delete request event must be retried
     // If enabled
-    //    Dont remove FlowExportInfo from list after generating delete event
+    //    Dont remove FlowExportInfo from wheel after generating delete event
     //    Retry delete event after kFlowDeleteRetryTime
     // Else
-    //    Remove FlowExportInfo from list after generating delete event
+    //    Remove FlowExportInfo from wheel after generating delete event
     //    FIXME : disabling is only a debug feature for now. Once we remove
     //    from list, flow will never be aged. So, need to ensure all scenarios
     //    are covered before disabling the fag
@@ -250,14 +267,13 @@ private:
     FlowStatsManager *flow_stats_manager_;
     FlowStatsCollectorObject *parent_;
     AgeingTask *ageing_task_;
-    // Number of timer fires needed to scan the flow-table once
-    // This is based on ageing timer
-    uint32_t timers_per_scan_;
     // Cached UTC Time stamp
     // The timestamp is taken once on FlowStatsCollector::RequestHandlerEntry()
     // and used for all requests in current run
     uint64_t current_time_;
     uint64_t ageing_task_starts_;
+    // Number of flow visits since start
+    uint64_t flow_visits_;
 
     // Per ageing-timer stats for debugging
     uint32_t flows_visited_;
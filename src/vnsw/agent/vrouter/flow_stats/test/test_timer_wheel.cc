@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2017 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <stdlib.h>
+#include <vector>
+
+#include "vrouter/flow_stats/timer_wheel.h"
+
+#include "testing/gunit.h"
+#include "gtest/gtest.h"
+
+class TestEntry : public TimerWheelEntry {
+public:
+    TestEntry() : expired_(0) { }
+    uint64_t expired_;
+};
+
+typedef TimerWheel<TestEntry> TestWheel;
+
+// Advance one tick at a time and note the tick at which entries expire
+static void RunWheel(TestWheel *wheel, uint64_t tick) {
+    while (wheel->current_tick() < tick) {
+        wheel->Advance(wheel->current_tick() + 1);
+        TestEntry *entry;
+        while ((entry = wheel->PopExpired()) != NULL) {
+            entry->expired_ = wheel->current_tick();
+        }
+    }
+}
+
+TEST(TimerWheelTest, Basic) {
+    TestWheel wheel(1000);
+    TestEntry e1, e2, e3;
+    wheel.Schedule(&e1, 1005);
+    wheel.Schedule(&e2, 1000 + 300);
+    wheel.Schedule(&e3, 1000 + 70000);
+    EXPECT_EQ(3U, wheel.size());
+    EXPECT_TRUE(e1.wheel_linked());
+
+    RunWheel(&wheel, 1004);
+    EXPECT_EQ(0U, e1.expired_);
+    RunWheel(&wheel, 1005);
+    EXPECT_EQ(1005U, e1.expired_);
+    EXPECT_FALSE(e1.wheel_linked());
+
+    RunWheel(&wheel, 1000 + 70000);
+    EXPECT_EQ(1300U, e2.expired_);
+    EXPECT_EQ(71000U, e3.expired_);
+    EXPECT_EQ(0U, wheel.size());
+}
+
+TEST(TimerWheelTest, Cancel) {
+    TestWheel wheel(0);
+    TestEntry e1, e2;
+    wheel.Schedule(&e1, 10);
+    wheel.Schedule(&e2, 20);
+    wheel.Cancel(&e1);
+    wheel.Cancel(&e1);
+    EXPECT_EQ(1U, wheel.size());
+
+    // Reschedule moves the entry
+    wheel.Schedule(&e2, 5);
+    EXPECT_EQ(1U, wheel.size());
+    RunWheel(&wheel, 30);
+    EXPECT_EQ(0U, e1.expired_);
+    EXPECT_EQ(5U, e2.expired_);
+}
+
+// Entries in the past go to expired list. Big jumps expire everything
+TEST(TimerWheelTest, Expired) {
+    TestWheel wheel(100);
+    TestEntry e1, e2, e3;
+    wheel.Schedule(&e1, 50);
+    EXPECT_EQ(1U, wheel.expired_size());
+    EXPECT_EQ(&e1, wheel.PopExpired());
+    EXPECT_TRUE(wheel.PopExpired() == NULL);
+
+    wheel.Schedule(&e2, 100 + TestWheel::kMaxTicks + 1000);
+    EXPECT_EQ(100 + TestWheel::kMaxTicks, e2.wheel_tick());
+    wheel.Schedule(&e3, 200);
+    wheel.Advance(100 + 2 * TestWheel::kMaxTicks);
+    EXPECT_EQ(2U, wheel.expired_size());
+
+    // Copy of an entry is not in the wheel
+    TestEntry e4(e2);
+    EXPECT_FALSE(e4.wheel_linked());
+    wheel.Clear();
+    EXPECT_FALSE(e2.wheel_linked());
+    EXPECT_EQ(0U, wheel.size());
+}
+
+// Random schedule and advance in steps of varying size
+TEST(TimerWheelTest, Random) {
+    srand(1);
+    const uint64_t start = 123456;
+    TestWheel wheel(start);
+    std::vector<TestEntry> entries(2048);
+    std::vector<uint64_t> expiry(entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        uint64_t delta = rand() % (1 << (rand() % 20));
+        expiry[i] = start + delta;
+        wheel.Schedule(&entries[i], expiry[i]);
+    }
+
+    uint64_t end = start + (1 << 20);
+    while (wheel.current_tick() < end) {
+        uint64_t tick = wheel.current_tick() + 1 + (rand() % 512);
+        wheel.Advance(tick);
+        TestEntry *entry;
+        while ((entry = wheel.PopExpired()) != NULL) {
+            entry->expired_ = wheel.current_tick();
+        }
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (expiry[i] <= wheel.current_tick()) {
+                ASSERT_NE(0U, entries[i].expired_);
+                ASSERT_GE(entries[i].expired_, expiry[i]);
+                ASSERT_LT(entries[i].expired_, expiry[i] + 512);
+            } else {
+                ASSERT_EQ(0U, entries[i].expired_);
+            }
+        }
+    }
+    EXPECT_EQ(0U, wheel.size());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2017 Juniper Networks, Inc. All rights reserved.
+ */
+#ifndef __AGENT_TIMER_WHEEL_H__
+#define __AGENT_TIMER_WHEEL_H__
+
+#include <stdint.h>
+#include <boost/intrusive/list.hpp>
+#include <base/util.h>
+
+// Hook for entries kept in TimerWheel. An entry is in atmost one wheel.
+// Copy of an entry does not inherit membership in the wheel.
+class TimerWheelEntry : public boost::intrusive::list_base_hook<> {
+public:
+    TimerWheelEntry() : wheel_tick_(0), wheel_slot_(kInvalidSlot) { }
+    TimerWheelEntry(const TimerWheelEntry &rhs) :
+        boost::intrusive::list_base_hook<>(), wheel_tick_(0),
+        wheel_slot_(kInvalidSlot) {
+    }
+    TimerWheelEntry &operator=(const TimerWheelEntry &rhs) { return *this; }
+
+    uint64_t wheel_tick() const { return wheel_tick_; }
+    bool wheel_linked() const { return wheel_slot_ != kInvalidSlot; }
+
+private:
+    template <typename T> friend class TimerWheel;
+    static const uint32_t kInvalidSlot = 0xFFFFFFFF;
+
+    uint64_t wheel_tick_;
+    uint32_t wheel_slot_;
+};
+
+// Hierarchical timing wheel of entries keyed on expiry tick. T must derive
+// from TimerWheelEntry.
+//
+// Level 0 has one slot per tick for the next kSlots ticks. Each slot in
+// level N covers kSlots slots of level N-1. When level 0 wraps around, the
+// entries in next slot of level 1 are moved down to level 0 (and so on for
+// higher levels). Schedule, Cancel and expiry of an entry are O(1) and the
+// cost of Advance is proportional to ticks elapsed plus entries expired,
+// independent of number of entries in the wheel.
+//
+// Entries whose tick is not in future are moved to the expired list. The
+// user takes entries from the expired list with PopExpired and may schedule
+// them again.
+//
+// Entries scheduled beyond kMaxTicks are capped to kMaxTicks. The wheel is
+// not thread-safe.
+template <typename T>
+class TimerWheel {
+public:
+    static const uint32_t kSlotBits = 8;
+    static const uint32_t kSlots = (1 << kSlotBits);
+    static const uint32_t kLevels = 3;
+    static const uint64_t kMaxTicks = (1ULL << (kSlotBits * kLevels)) - 1;
+
+    explicit TimerWheel(uint64_t tick) : current_(tick), size_(0) { }
+    ~TimerWheel() { Clear(); }
+
+    // Schedule entry to expire at tick. Entry already in the wheel is
+    // rescheduled
+    void Schedule(T *entry, uint64_t tick) {
+        Cancel(entry);
+        entry->wheel_tick_ = tick;
+        Insert(entry);
+        size_++;
+    }
+
+    // Remove entry from the wheel. Noop if entry is not in the wheel
+    void Cancel(T *entry) {
+        if (entry->wheel_linked() == false)
+            return;
+        EntryList &list = slots_[entry->wheel_slot_];
+        list.erase(list.iterator_to(*entry));
+        entry->wheel_slot_ = TimerWheelEntry::kInvalidSlot;
+        size_--;
+    }
+
+    // Move time forward to tick, moving entries that expire to expired list.
+    // Moving time backwards is ignored
+    void Advance(uint64_t tick) {
+        if (tick <= current_)
+            return;
+
+        // Time jumped more than the wheel can hold. Expire everything
+        if ((tick - current_) > kMaxTicks) {
+            ExpireAll();
+            current_ = tick;
+            return;
+        }
+
+        while (current_ < tick) {
+            // Nothing pending, skip to tick directly
+            if (size_ == slots_[kExpiredSlot].size()) {
+                current_ = tick;
+                break;
+            }
+            current_++;
+            for (uint32_t level = kLevels - 1; level > 0; level--) {
+                if ((current_ & ((1ULL << (kSlotBits * level)) - 1)) == 0)
+                    Cascade(SlotIndex(level, current_));
+            }
+            Cascade(SlotIndex(0, current_));
+        }
+    }
+
+    // Move all entries to expired list
+    void ExpireAll() {
+        EntryList &expired = slots_[kExpiredSlot];
+        for (uint32_t i = 0; i < kExpiredSlot; i++) {
+            while (slots_[i].empty() == false) {
+                T &entry = slots_[i].front();
+                slots_[i].pop_front();
+                entry.wheel_slot_ = kExpiredSlot;
+                expired.push_back(entry);
+            }
+        }
+    }
+
+    // Remove and return first entry from expired list. Returns NULL if no
+    // entry is expired
+    T *PopExpired() {
+        EntryList &expired = slots_[kExpiredSlot];
+        if (expired.empty())
+            return NULL;
+        T *entry = &expired.front();
+        expired.pop_front();
+        entry->wheel_slot_ = TimerWheelEntry::kInvalidSlot;
+        size_--;
+        return entry;
+    }
+
+    void Clear() {
+        for (uint32_t i = 0; i <= kExpiredSlot; i++) {
+            while (slots_[i].empty() == false) {
+                T &entry = slots_[i].front();
+                slots_[i].pop_front();
+                entry.wheel_slot_ = TimerWheelEntry::kInvalidSlot;
+            }
+        }
+        size_ = 0;
+    }
+
+    uint64_t current_tick() const { return current_; }
+    size_t size() const { return size_; }
+    size_t expired_size() const { return slots_[kExpiredSlot].size(); }
+
+private:
+    typedef boost::intrusive::list<T> EntryList;
+    static const uint32_t kExpiredSlot = kLevels * kSlots;
+
+    static uint32_t SlotIndex(uint32_t level, uint64_t tick) {
+        return (level * kSlots) +
+            ((tick >> (kSlotBits * level)) & (kSlots - 1));
+    }
+
+    void Insert(T *entry) {
+        uint32_t slot = kExpiredSlot;
+        if (entry->wheel_tick_ > current_) {
+            uint64_t delta = entry->wheel_tick_ - current_;
+            if (delta > kMaxTicks) {
+                entry->wheel_tick_ = current_ + kMaxTicks;
+                delta = kMaxTicks;
+            }
+            uint32_t level = 0;
+            while (delta >= (1ULL << (kSlotBits * (level + 1))))
+                level++;
+            slot = SlotIndex(level, entry->wheel_tick_);
+        }
+        entry->wheel_slot_ = slot;
+        slots_[slot].push_back(*entry);
+    }
+
+    // Re-insert entries in the slot based on current time. Entries move to a
+    // lower level or to the expired list
+    void Cascade(uint32_t slot) {
+        EntryList list;
+        list.swap(slots_[slot]);
+        while (list.empty() == false) {
+            T &entry = list.front();
+            list.pop_front();
+            Insert(&entry);
+        }
+    }
+
+    EntryList slots_[kExpiredSlot + 1];
+    uint64_t current_;
+    size_t size_;
+    DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+#endif // __AGENT_TIMER_WHEEL_H__
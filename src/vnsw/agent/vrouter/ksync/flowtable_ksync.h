@@ -72,6 +72,8 @@ public:
     void SetPcapData(FlowEntryPtr fe, std::vector<int8_t> &data);
     // For flows allocate buffers in ksync-sock context
     virtual bool pre_alloc_rx_buffer() const { return true; }
+    // Flow setup latency must not suffer behind route/nexthop programming
+    virtual bool tx_priority() const { return true; }
     // KSync flow responses must be processed in multiple ksync response queues
     // to support scaling. Distribute the flows based on flow-table index
     virtual uint32_t GetTableIndex() const;
@@ -33,6 +33,8 @@ public:
     virtual bool IsLess(const KSyncEntry &rhs) const;
     virtual std::string ToString() const;
     virtual KSyncEntry *UnresolvedReference();
+    // Flows refer to the mirror index. Flow messages must not overtake it
+    virtual bool tx_barrier() const { return true; }
     virtual bool Sync(DBEntry *e);
     virtual int AddMsg(char *buf, int buf_len);
     virtual int ChangeMsg(char *buf, int buf_len);
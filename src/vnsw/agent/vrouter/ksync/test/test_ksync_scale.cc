@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2017 Juniper Networks, Inc. All rights reserved.
+ */
+
+// Benchmark for the agent to vrouter programming path.
+//
+// Workloads are run against the in-process vrouter emulation in
+// KSyncSockTypeMap, so every request goes thru the oper DB, the KSync
+// object state machines, KSyncTxQueue, sandesh encoding and decode in the
+// user socket. Time spent in the kernel is not measured.
+//
+// Each workload is run in waves. A wave is a batch of requests enqueued
+// together and is complete when the agent is idle and the vrouter
+// emulation has the expected number of entries. Following are reported
+// for every workload
+// - Entries and messages to vrouter per second
+// - Percentiles of wave latency
+// - Increase in RSS per entry added
+//
+// Scale is controlled with environment variables
+// KSYNC_SCALE_VRF_COUNT   : Number of VRFs in route workload
+// KSYNC_SCALE_ROUTE_COUNT : Number of routes per VRF in route workload. Also
+//                           number of ECMP routes in ECMP workload
+// KSYNC_SCALE_FLOW_COUNT  : Number of flows added in every flow wave
+// KSYNC_SCALE_FLOW_ROUNDS : Number of add/delete rounds in flow workload
+//
+#include "base/os.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "base/time_util.h"
+#include "testing/gunit.h"
+#include "test/test_cmn_util.h"
+#include "pkt/test/test_pkt_util.h"
+#include "pkt/flow_proto.h"
+#include "ksync/ksync_sock.h"
+#include "ksync/ksync_sock_user.h"
+
+struct PortInfo input[] = {
+    {"vnet1", 1, "1.1.1.1", "00:00:00:01:01:01", 1, 1},
+};
+
+static uint32_t GetScaleParam(const char *name, uint32_t def) {
+    const char *val = getenv(name);
+    if (val == NULL)
+        return def;
+    return strtoul(val, NULL, 0);
+}
+
+// Resident memory of the process in KB
+static uint64_t ProcessRssKb() {
+    std::ifstream file("/proc/self/statm");
+    uint64_t size = 0;
+    uint64_t rss = 0;
+    file >> size >> rss;
+    return rss * (getpagesize() / 1024);
+}
+
+// Collects stats of one workload and prints them on Report()
+class KSyncScaleStats {
+public:
+    explicit KSyncScaleStats(const std::string &name) :
+        name_(name), entries_(0), start_time_(0), wave_start_(0),
+        msg_count_(KSyncSockTypeMap::MsgCount()),
+        tx_count_(KSyncSock::Get(0)->tx_count()), rss_(ProcessRssKb()),
+        rss_delta_(0), rss_entries_(0) {
+        start_time_ = ClockMonotonicUsec();
+    }
+
+    void WaveStart() { wave_start_ = ClockMonotonicUsec(); }
+    void WaveEnd(uint32_t entries) {
+        latency_.push_back(ClockMonotonicUsec() - wave_start_);
+        entries_ += entries;
+    }
+
+    // RSS increase per entry is meaningful only for workloads that add
+    // entries. Callers invoke this before deleting the entries
+    void SampleMemory() {
+        uint64_t rss = ProcessRssKb();
+        rss_delta_ = (rss > rss_) ? (rss - rss_) : 0;
+        rss_entries_ = entries_;
+    }
+
+    void Report() {
+        uint64_t time = ClockMonotonicUsec() - start_time_;
+        uint64_t msgs = KSyncSockTypeMap::MsgCount() - msg_count_;
+        uint64_t bulks = KSyncSock::Get(0)->tx_count() - tx_count_;
+        if (time == 0)
+            time = 1;
+
+        std::sort(latency_.begin(), latency_.end());
+        std::cout << "KSync scale : " << name_ << std::endl;
+        std::cout << "    Entries            : " << entries_ << std::endl;
+        std::cout << "    Messages           : " << msgs << " in "
+            << bulks << " bulk messages" << std::endl;
+        std::cout << "    Time               : " << time << " usec"
+            << std::endl;
+        std::cout << "    Entries per sec    : "
+            << (entries_ * 1000000) / time << std::endl;
+        std::cout << "    Messages per sec   : "
+            << (msgs * 1000000) / time << std::endl;
+        std::cout << "    Wave latency usec  : p50 " << Percentile(50)
+            << " p90 " << Percentile(90) << " p99 " << Percentile(99)
+            << " max " << Percentile(100) << std::endl;
+        if (rss_entries_) {
+            std::cout << "    RSS per entry      : "
+                << (rss_delta_ * 1024) / rss_entries_ << " bytes"
+                << std::endl;
+        }
+    }
+
+private:
+    uint64_t Percentile(uint32_t percent) const {
+        if (latency_.empty())
+            return 0;
+        return latency_[((latency_.size() - 1) * percent) / 100];
+    }
+
+    std::string name_;
+    uint64_t entries_;
+    uint64_t start_time_;
+    uint64_t wave_start_;
+    uint64_t msg_count_;
+    uint64_t tx_count_;
+    uint64_t rss_;
+    uint64_t rss_delta_;
+    uint64_t rss_entries_;
+    std::vector<uint64_t> latency_;
+};
+
+class TestKSyncScale : public ::testing::Test {
+public:
+    virtual void SetUp() {
+        agent_ = Agent::GetInstance();
+        flow_proto_ = agent_->pkt()->get_flow_proto();
+        vrf_count_ = GetScaleParam("KSYNC_SCALE_VRF_COUNT", 4);
+        route_count_ = GetScaleParam("KSYNC_SCALE_ROUTE_COUNT", 256);
+        flow_count_ = GetScaleParam("KSYNC_SCALE_FLOW_COUNT", 256);
+        flow_rounds_ = GetScaleParam("KSYNC_SCALE_FLOW_ROUNDS", 4);
+
+        boost::system::error_code ec;
+        bgp_peer_ = CreateBgpPeer(Ip4Address::from_string("0.0.0.1", ec),
+                                  "xmpp channel");
+        client->WaitForIdle();
+    }
+
+    virtual void TearDown() {
+        DeleteBgpPeer(bgp_peer_);
+        client->WaitForIdle();
+    }
+
+    static std::string VrfName(uint32_t i) {
+        std::stringstream str;
+        str << "scale_vrf" << i;
+        return str.str();
+    }
+
+    // Spread routes on 16 remote servers so that tunnel nexthops are shared
+    static Ip4Address ServerIp(uint32_t i) {
+        return Ip4Address(0x0A010100 + (i % 16) + 1);
+    }
+
+    static Ip4Address RouteIp(uint32_t i) {
+        return Ip4Address(0x0B000000 + i);
+    }
+
+    void DeleteRemoteRoute(const std::string &vrf, const Ip4Address &addr) {
+        InetUnicastAgentRouteTable::DeleteReq(bgp_peer_, vrf, addr, 32,
+                                              new ControllerVmRoute(bgp_peer_));
+    }
+
+    Agent *agent_;
+    FlowProto *flow_proto_;
+    BgpPeer *bgp_peer_;
+    uint32_t vrf_count_;
+    uint32_t route_count_;
+    uint32_t flow_count_;
+    uint32_t flow_rounds_;
+};
+
+// N VRFs x M remote routes. A wave adds or deletes routes of one VRF
+TEST_F(TestKSyncScale, vrf_routes) {
+    for (uint32_t i = 0; i < vrf_count_; i++) {
+        AddVrf(VrfName(i).c_str(), i + 100);
+    }
+    client->WaitForIdle();
+    for (uint32_t i = 0; i < vrf_count_; i++) {
+        WAIT_FOR(1000, 1000, (VrfFind(VrfName(i).c_str()) == true));
+    }
+    client->WaitForIdle();
+    int route_count = KSyncSockTypeMap::RouteCount();
+
+    KSyncScaleStats add_stats("Route add");
+    for (uint32_t i = 0; i < vrf_count_; i++) {
+        add_stats.WaveStart();
+        for (uint32_t j = 0; j < route_count_; j++) {
+            Inet4TunnelRouteAdd(bgp_peer_, VrfName(i), RouteIp(j), 32,
+                                ServerIp(j), TunnelType::MplsType(), j + 16,
+                                "vn1", SecurityGroupList(), TagList(),
+                                PathPreference());
+        }
+        client->WaitForIdle();
+        add_stats.WaveEnd(route_count_);
+    }
+    add_stats.SampleMemory();
+    add_stats.Report();
+    EXPECT_EQ(route_count + (int)(vrf_count_ * route_count_),
+              KSyncSockTypeMap::RouteCount());
+
+    KSyncScaleStats del_stats("Route delete");
+    for (uint32_t i = 0; i < vrf_count_; i++) {
+        del_stats.WaveStart();
+        for (uint32_t j = 0; j < route_count_; j++) {
+            DeleteRemoteRoute(VrfName(i), RouteIp(j));
+        }
+        client->WaitForIdle();
+        del_stats.WaveEnd(route_count_);
+    }
+    del_stats.Report();
+    EXPECT_EQ(route_count, KSyncSockTypeMap::RouteCount());
+
+    for (uint32_t i = 0; i < vrf_count_; i++) {
+        DelVrf(VrfName(i).c_str());
+    }
+    client->WaitForIdle();
+    for (uint32_t i = 0; i < vrf_count_; i++) {
+        WAIT_FOR(1000, 1000, (VrfFind(VrfName(i).c_str()) == false));
+    }
+}
+
+// ECMP routes with a composite nexthop of two tunnels per route. Every
+// route adds a new composite nexthop
+TEST_F(TestKSyncScale, ecmp_routes) {
+    std::string vrf = VrfName(0);
+    AddVrf(vrf.c_str(), 100);
+    client->WaitForIdle();
+    WAIT_FOR(1000, 1000, (VrfFind(vrf.c_str()) == true));
+    int route_count = KSyncSockTypeMap::RouteCount();
+    int nh_count = KSyncSockTypeMap::NHCount();
+    uint32_t wave_size = std::max(route_count_ / 16, 1U);
+
+    KSyncScaleStats add_stats("ECMP route add");
+    for (uint32_t i = 0; i < route_count_; i += wave_size) {
+        add_stats.WaveStart();
+        uint32_t end = std::min(i + wave_size, route_count_);
+        for (uint32_t j = i; j < end; j++) {
+            ComponentNHKeyList comp_nh_list;
+            ComponentNHKeyPtr nh1(new ComponentNHKey
+                (j + 16, agent_->fabric_vrf_name(), agent_->router_id(),
+                 ServerIp(j), false, TunnelType::DefaultType()));
+            ComponentNHKeyPtr nh2(new ComponentNHKey
+                (j + 16, agent_->fabric_vrf_name(), agent_->router_id(),
+                 ServerIp(j + 1), false, TunnelType::DefaultType()));
+            comp_nh_list.push_back(nh1);
+            comp_nh_list.push_back(nh2);
+            EcmpTunnelRouteAdd(bgp_peer_, vrf, RouteIp(j), 32, comp_nh_list,
+                               false, "vn1", SecurityGroupList(), TagList(),
+                               PathPreference());
+        }
+        client->WaitForIdle();
+        add_stats.WaveEnd(end - i);
+    }
+    add_stats.SampleMemory();
+    add_stats.Report();
+    EXPECT_EQ(route_count + (int)route_count_,
+              KSyncSockTypeMap::RouteCount());
+    EXPECT_LT(nh_count, KSyncSockTypeMap::NHCount());
+
+    KSyncScaleStats del_stats("ECMP route delete");
+    for (uint32_t i = 0; i < route_count_; i += wave_size) {
+        del_stats.WaveStart();
+        uint32_t end = std::min(i + wave_size, route_count_);
+        for (uint32_t j = i; j < end; j++) {
+            DeleteRemoteRoute(vrf, RouteIp(j));
+        }
+        client->WaitForIdle();
+        del_stats.WaveEnd(end - i);
+    }
+    del_stats.Report();
+    EXPECT_EQ(route_count, KSyncSockTypeMap::RouteCount());
+
+    DelVrf(vrf.c_str());
+    client->WaitForIdle();
+    WAIT_FOR(1000, 1000, (VrfFind(vrf.c_str()) == false));
+}
+
+// Flow add/delete churn. Every round adds flows to remote destinations and
+// flushes them
+TEST_F(TestKSyncScale, flow_churn) {
+    CreateVmportEnv(input, 1);
+    client->WaitForIdle();
+    WAIT_FOR(1000, 1000, VmPortActive(input, 0));
+    VmInterface *vnet = VmInterfaceGet(1);
+    std::string vnet_addr = vnet->primary_ip_addr().to_string();
+
+    boost::system::error_code ec;
+    Inet4TunnelRouteAdd(NULL, "vrf1", Ip4Address::from_string("5.0.0.0", ec),
+                        8, Ip4Address::from_string("10.1.1.2", ec),
+                        TunnelType::AllType(), 16, "vn1",
+                        SecurityGroupList(), TagList(), PathPreference());
+    client->WaitForIdle();
+    EXPECT_EQ(0U, flow_proto_->FlowCount());
+
+    KSyncScaleStats add_stats("Flow add");
+    KSyncScaleStats del_stats("Flow delete");
+    for (uint32_t round = 0; round < flow_rounds_; round++) {
+        add_stats.WaveStart();
+        for (uint32_t i = 0; i < flow_count_; i++) {
+            Ip4Address addr(0x05000000 + (round * flow_count_) + i);
+            TxIpPacket(vnet->id(), vnet_addr.c_str(),
+                       addr.to_string().c_str(), 1);
+        }
+        // Every packet sets up a forward and reverse flow
+        WAIT_FOR(flow_count_ * 10, 1000,
+                 (flow_proto_->FlowCount() == 2 * flow_count_));
+        client->WaitForIdle();
+        add_stats.WaveEnd(2 * flow_count_);
+        if (round == 0)
+            add_stats.SampleMemory();
+
+        del_stats.WaveStart();
+        client->EnqueueFlowFlush();
+        WAIT_FOR(flow_count_ * 10, 1000, (flow_proto_->FlowCount() == 0));
+        client->WaitForIdle();
+        del_stats.WaveEnd(2 * flow_count_);
+    }
+    add_stats.Report();
+    del_stats.Report();
+
+    InetUnicastAgentRouteTable::DeleteReq(NULL, "vrf1",
+                                          Ip4Address::from_string("5.0.0.0",
+                                                                  ec),
+                                          8, NULL);
+    DeleteVmportEnv(input, 1, true);
+    client->WaitForIdle();
+    WAIT_FOR(1000, 1000, (VmPortFind(1) == false));
+}
+
+int main(int argc, char **argv) {
+    GETUSERARGS();
+
+    client = TestInit(init_file, ksync_init, true, true, true, 100*1000);
+    int ret = RUN_ALL_TESTS();
+    TestShutdown();
+    delete client;
+    return ret;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "xmpp/xmpp_stanza_framer.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "xmpp/xmpp_str.h"
+
+#include "testing/gunit.h"
+
+using namespace std;
+
+class XmppStanzaFramerTest : public ::testing::Test {
+protected:
+    // Feed the input to the framer in chunks of the given size and collect
+    // all stanzas.
+    void Feed(const string &input, size_t chunk_size) {
+        for (size_t pos = 0; pos < input.size(); pos += chunk_size) {
+            size_t size = min(chunk_size, input.size() - pos);
+            chunks_.push_back(input.substr(pos, size));
+            const string &chunk = chunks_.back();
+            framer_.SetChunk(
+                reinterpret_cast<const uint8_t *>(chunk.data()), size);
+            const char *data;
+            size_t len;
+            while (framer_.Next(&data, &len)) {
+                stanzas_.push_back(string(data, len));
+            }
+        }
+    }
+
+    XmppStanzaFramer framer_;
+    vector<string> stanzas_;
+    deque<string> chunks_;
+};
+
+TEST_F(XmppStanzaFramerTest, SingleStanza) {
+    string msg("<iq type='set' from='agent' to='bgp'><pubsub>"
+               "<publish node='1/1/blue/10.1.1.1'><item id='x'/></publish>"
+               "</pubsub></iq>");
+    Feed(msg, msg.size());
+    ASSERT_EQ(1, stanzas_.size());
+    EXPECT_EQ(msg, stanzas_[0]);
+    EXPECT_FALSE(framer_.InProgress());
+}
+
+TEST_F(XmppStanzaFramerTest, ZeroCopySlice) {
+    string msg("<message from='a' to='b'><event/></message>");
+    framer_.SetChunk(reinterpret_cast<const uint8_t *>(msg.data()),
+                     msg.size());
+    const char *data;
+    size_t len;
+    ASSERT_TRUE(framer_.Next(&data, &len));
+    EXPECT_EQ(msg.data(), data);
+    EXPECT_EQ(msg.size(), len);
+    EXPECT_FALSE(framer_.Next(&data, &len));
+}
+
+TEST_F(XmppStanzaFramerTest, MultipleStanzas) {
+    string msg1("<iq type='set'><pubsub><publish node='a'/></pubsub></iq>");
+    string msg2("<message type='chat'><body>hello</body></message>");
+    string msg3("<iq type='get'/>");
+    Feed(msg1 + msg2 + msg3, 4096);
+    ASSERT_EQ(3, stanzas_.size());
+    EXPECT_EQ(msg1, stanzas_[0]);
+    EXPECT_EQ(msg2, stanzas_[1]);
+    EXPECT_EQ(msg3, stanzas_[2]);
+}
+
+TEST_F(XmppStanzaFramerTest, Whitespace) {
+    string ws(sXMPP_WHITESPACE);
+    string msg("<iq type='set'><pubsub/></iq>");
+    Feed(ws + msg + " \n" + ws, 4096);
+    ASSERT_EQ(3, stanzas_.size());
+    EXPECT_EQ(ws, stanzas_[0]);
+    EXPECT_EQ(msg, stanzas_[1]);
+    EXPECT_EQ(" \n" + ws, stanzas_[2]);
+    EXPECT_FALSE(framer_.InProgress());
+}
+
+TEST_F(XmppStanzaFramerTest, QuotedMarkup) {
+    string msg("<iq id='a>b' name=\"</iq>\"><item value='/'/></iq>");
+    Feed(msg + msg, 4096);
+    ASSERT_EQ(2, stanzas_.size());
+    EXPECT_EQ(msg, stanzas_[0]);
+    EXPECT_EQ(msg, stanzas_[1]);
+}
+
+TEST_F(XmppStanzaFramerTest, NestedSameTag) {
+    string msg("<message><message>inner</message><x/></message>");
+    Feed(msg, 4096);
+    ASSERT_EQ(1, stanzas_.size());
+    EXPECT_EQ(msg, stanzas_[0]);
+}
+
+TEST_F(XmppStanzaFramerTest, Declaration) {
+    string msg("<?xml version='1.0'?><iq><a/></iq>");
+    Feed(msg, 4096);
+    ASSERT_EQ(1, stanzas_.size());
+    EXPECT_EQ(msg, stanzas_[0]);
+}
+
+//
+// Split the stream at every possible chunk size and make sure that the same
+// set of stanzas is produced.
+//
+TEST_F(XmppStanzaFramerTest, Fragmented) {
+    string msg1("<iq type='set' from='agent' to='bgp'><pubsub>"
+                "<publish node='1/1/blue/10.1.1.1'><item id='x'>"
+                "<entry><nlri><af>1</af><address>10.1.1.1/32</address></nlri>"
+                "</entry></item></publish></pubsub></iq>");
+    string msg2("<message from='bgp' to='agent'><event/></message>");
+    string input = msg1 + " " + msg2 + msg1;
+    for (size_t chunk_size = 1; chunk_size <= input.size(); ++chunk_size) {
+        framer_.Clear();
+        stanzas_.clear();
+        chunks_.clear();
+        Feed(input, chunk_size);
+        vector<string> result;
+        for (size_t idx = 0; idx < stanzas_.size(); ++idx) {
+            if (stanzas_[idx] != " ")
+                result.push_back(stanzas_[idx]);
+        }
+        ASSERT_EQ(3, result.size()) << "chunk size " << chunk_size;
+        EXPECT_EQ(msg1, result[0]);
+        EXPECT_EQ(msg2, result[1]);
+        EXPECT_EQ(msg1, result[2]);
+        EXPECT_FALSE(framer_.InProgress());
+    }
+}
+
+TEST_F(XmppStanzaFramerTest, Partial) {
+    string msg("<iq type='set'><pubsub><publish node='a'/></pubsub></iq>");
+    Feed(msg.substr(0, 20), 4096);
+    EXPECT_TRUE(stanzas_.empty());
+    EXPECT_TRUE(framer_.InProgress());
+    EXPECT_EQ(20, framer_.pending_size());
+    Feed(msg.substr(20), 4096);
+    ASSERT_EQ(1, stanzas_.size());
+    EXPECT_EQ(msg, stanzas_[0]);
+    EXPECT_FALSE(framer_.InProgress());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -270,9 +270,51 @@ bool XmppSession::Match(Buffer buffer, int *result, bool NewBuf) {
     return true;
 }
 
+//
+// Use the XmppStanzaFramer once the stream has been opened and all stream
+// negotiation is complete. The regex based matcher is used only for the
+// stream open and TLS negotiation exchanges. The switch happens at a stanza
+// boundary, when the regex matcher has no partial data saved in buf_. Once
+// the framer is in use, it continues to be used as the connection never goes
+// back to the negotiation states.
+//
+bool XmppSession::UseStanzaFramer() const {
+    if (framer_.InProgress())
+        return true;
+    if (tag_known_ || !buf_.empty())
+        return false;
+
+    xmsm::XmState state = connection_->GetStateMcState();
+    if (state == xmsm::ESTABLISHED)
+        return true;
+    return (state == xmsm::OPENCONFIRM && IsSslDisabled());
+}
+
+//
+// Hand over all complete stanzas in the buffer to the connection. Stanzas
+// that are fully contained in the buffer are not copied into buf_, and only
+// the partial stanza at the end of the buffer is saved by the framer.
+//
+void XmppSession::ProcessStanzas(Buffer buffer) {
+    framer_.SetChunk(BufferData(buffer), BufferSize(buffer));
+
+    const char *data;
+    size_t size;
+    while (framer_.Next(&data, &size)) {
+        connection_->ReceiveMsg(this, string(data, size));
+
+        // Connection is deleted. Session is being deleted as well.
+        if (!connection_) {
+            framer_.Clear();
+            break;
+        }
+    }
+}
+
 // Read the socket stream and send messages to the connection object.
-// The buffer is copied to local string for regex match.
-// TODO Code need to change st Match() is done on buffer itself.
+// The buffer is copied to local string for regex match during stream
+// negotiation, after which stanzas are delimited by the XmppStanzaFramer
+// directly on the buffer.
 void XmppSession::OnRead(Buffer buffer) {
     if (this->Connection() == NULL || !connection_) {
         // Connection is deleted. Session is being deleted as well
@@ -289,6 +331,12 @@ void XmppSession::OnRead(Buffer buffer) {
         return;
     }
 
+    if (UseStanzaFramer()) {
+        ProcessStanzas(buffer);
+        ReleaseBuffer(buffer);
+        return;
+    }
+
     int result = 0;
     bool more = Match(buffer, &result, true);
     do {
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "xmpp/xmpp_stanza_framer.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "xmpp/xmpp_str.h"
+
+XmppStanzaFramer::XmppStanzaFramer()
+    : state_(IDLE),
+      depth_(0),
+      quote_(0),
+      last_(0),
+      chunk_(NULL),
+      chunk_size_(0),
+      cursor_(0),
+      start_(0),
+      pending_done_(false) {
+}
+
+bool XmppStanzaFramer::IsWhitespace(uint8_t c) {
+    return (memchr(sXMPP_VALIDWS, c, sizeof(sXMPP_VALIDWS) - 1) != NULL);
+}
+
+void XmppStanzaFramer::SetChunk(const uint8_t *data, size_t size) {
+    assert(cursor_ == chunk_size_);
+    if (pending_done_) {
+        pending_.clear();
+        pending_done_ = false;
+    }
+    chunk_ = data;
+    chunk_size_ = size;
+    cursor_ = 0;
+    start_ = 0;
+}
+
+void XmppStanzaFramer::Clear() {
+    state_ = IDLE;
+    depth_ = 0;
+    quote_ = 0;
+    last_ = 0;
+    chunk_ = NULL;
+    chunk_size_ = 0;
+    cursor_ = 0;
+    start_ = 0;
+    pending_done_ = false;
+    pending_.clear();
+}
+
+//
+// Consume the '>' at the cursor that terminates the current stanza and
+// return the stanza. The stanza is returned directly from the chunk unless
+// it started in a previous chunk.
+//
+bool XmppStanzaFramer::Complete(const char **data, size_t *size) {
+    cursor_++;
+    state_ = IDLE;
+    last_ = 0;
+    if (pending_.empty()) {
+        *data = reinterpret_cast<const char *>(chunk_ + start_);
+        *size = cursor_ - start_;
+    } else {
+        pending_.append(chunk_ + start_, chunk_ + cursor_);
+        *data = pending_.data();
+        *size = pending_.size();
+        pending_done_ = true;
+    }
+    start_ = cursor_;
+    return true;
+}
+
+bool XmppStanzaFramer::Next(const char **data, size_t *size) {
+    if (pending_done_) {
+        pending_.clear();
+        pending_done_ = false;
+    }
+
+    while (cursor_ < chunk_size_) {
+        uint8_t c = chunk_[cursor_];
+        switch (state_) {
+        case IDLE:
+            if (IsWhitespace(c)) {
+                cursor_++;
+                continue;
+            }
+            state_ = TEXT;
+            if (cursor_ > start_) {
+                *data = reinterpret_cast<const char *>(chunk_ + start_);
+                *size = cursor_ - start_;
+                start_ = cursor_;
+                return true;
+            }
+            continue;
+        case TEXT:
+            if (c == '<')
+                state_ = TAG_OPEN;
+            break;
+        case TAG_OPEN:
+            if (c == '/') {
+                state_ = END_TAG;
+            } else if (c == '?' || c == '!') {
+                state_ = DECLARATION;
+            } else {
+                state_ = START_TAG;
+                quote_ = 0;
+            }
+            break;
+        case START_TAG:
+            if (quote_) {
+                if (c == quote_)
+                    quote_ = 0;
+            } else if (c == '"' || c == '\'') {
+                quote_ = c;
+            } else if (c == '>') {
+                state_ = TEXT;
+                if (last_ != '/') {
+                    depth_++;
+                } else if (depth_ == 0) {
+                    return Complete(data, size);
+                }
+            }
+            break;
+        case END_TAG:
+            if (c == '>') {
+                state_ = TEXT;
+                if (depth_ > 0)
+                    depth_--;
+                if (depth_ == 0)
+                    return Complete(data, size);
+            }
+            break;
+        case DECLARATION:
+            if (c == '>')
+                state_ = TEXT;
+            break;
+        }
+        last_ = c;
+        cursor_++;
+    }
+
+    // Reached the end of the chunk. Trailing whitespace is handed out right
+    // away, a partial stanza is saved till the next chunk arrives.
+    if (state_ == IDLE) {
+        if (cursor_ == start_)
+            return false;
+        *data = reinterpret_cast<const char *>(chunk_ + start_);
+        *size = cursor_ - start_;
+        start_ = cursor_;
+        return true;
+    }
+    pending_.append(chunk_ + start_, chunk_ + cursor_);
+    start_ = cursor_;
+    return false;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef __XMPP_STANZA_FRAMER_H__
+#define __XMPP_STANZA_FRAMER_H__
+
+#include <stdint.h>
+#include <string>
+
+#include "base/util.h"
+
+//
+// Incremental tokenizer that finds stanza boundaries in the XMPP byte stream
+// once the stream has been established.
+//
+// The framer is a byte level state machine that tracks element depth, quoted
+// attribute values and markup declarations. Scan state is preserved across
+// reads, so every received byte is examined exactly once irrespective of how
+// the stanzas are split across socket reads.
+//
+// A stanza that is entirely contained in the chunk being scanned is returned
+// as a slice of that chunk without any copy. Only the partial stanza at the
+// tail of a chunk is carried over in an internal buffer, and is completed in
+// place when the following chunk(s) arrive.
+//
+// Runs of whitespace between stanzas (including the XMPP keepalive filler)
+// are returned as separate slices, same as the regex based matcher.
+//
+// Usage:
+//     framer.SetChunk(data, size);
+//     while (framer.Next(&msg, &msg_size)) {
+//         ... // msg is valid till the next call to Next or SetChunk
+//     }
+//
+class XmppStanzaFramer {
+public:
+    XmppStanzaFramer();
+
+    // Supply the next chunk of the byte stream. The previous chunk must have
+    // been drained i.e. Next must have returned false.
+    void SetChunk(const uint8_t *data, size_t size);
+
+    // Get the next complete stanza or whitespace run. Returns false if more
+    // data is needed, in which case any partial stanza has been saved.
+    bool Next(const char **data, size_t *size);
+
+    // Discard all state including any partially received stanza.
+    void Clear();
+
+    // Whether the framer is in the middle of a stanza.
+    bool InProgress() const { return state_ != IDLE; }
+    size_t pending_size() const { return pending_.size(); }
+
+private:
+    enum State {
+        IDLE,           // between stanzas, skipping whitespace
+        TEXT,           // character data inside or before an element
+        TAG_OPEN,       // seen '<'
+        START_TAG,      // inside a start or empty element tag
+        END_TAG,        // inside an end tag
+        DECLARATION     // inside <? ... > or <! ... >
+    };
+
+    static bool IsWhitespace(uint8_t c);
+    bool Complete(const char **data, size_t *size);
+
+    State state_;
+    int depth_;
+    uint8_t quote_;
+    uint8_t last_;
+    const uint8_t *chunk_;
+    size_t chunk_size_;
+    size_t cursor_;
+    size_t start_;
+    bool pending_done_;
+    std::string pending_;
+
+    DISALLOW_COPY_AND_ASSIGN(XmppStanzaFramer);
+};
+
+#endif // __XMPP_STANZA_FRAMER_H__